@@ -0,0 +1,340 @@
+#include <benchmark/benchmark.h>
+
+#include "base_vector.hpp"
+#include "benchmark_helpers.hpp"
+#include "overlapped_copy.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+// Each benchmark runs for std::vector (the baseline) and base_vector, with
+// int, double and std::string elements, for 1K to 1M elements
+
+namespace {
+using mem::bench::make_container;
+using mem::bench::make_value;
+
+std::size_t size_of(const benchmark::State &state) {
+  return static_cast<std::size_t>(state.range(0));
+}
+
+template <class Container>
+void set_bytes_processed(benchmark::State &state) {
+  state.SetBytesProcessed(
+      state.iterations() * state.range(0) *
+      static_cast<std::int64_t>(sizeof(typename Container::value_type)));
+}
+
+template <class Container> void construct(benchmark::State &state) {
+  const auto n = size_of(state);
+
+  for (auto _ : state) {
+    Container c(n);
+    benchmark::DoNotOptimize(c.data());
+  }
+
+  set_bytes_processed<Container>(state);
+}
+
+template <class Container> void fill(benchmark::State &state) {
+  using value_type = typename Container::value_type;
+  const auto n = size_of(state);
+  const auto value = make_value<value_type>(42);
+
+  for (auto _ : state) {
+    Container c(n, value);
+    benchmark::DoNotOptimize(c.data());
+  }
+
+  set_bytes_processed<Container>(state);
+}
+
+template <class Container> void push_back(benchmark::State &state) {
+  using value_type = typename Container::value_type;
+  const auto n = size_of(state);
+  const auto value = make_value<value_type>(42);
+
+  for (auto _ : state) {
+    Container c;
+    for (std::size_t i = 0; i < n; ++i) {
+      c.push_back(value);
+    }
+    benchmark::DoNotOptimize(c.data());
+  }
+
+  set_bytes_processed<Container>(state);
+}
+
+template <class Container> void assign(benchmark::State &state) {
+  const auto n = size_of(state);
+  const auto source = make_container<Container>(n);
+  Container c;
+
+  for (auto _ : state) {
+    c.assign(source.begin(), source.end());
+    benchmark::DoNotOptimize(c.data());
+  }
+
+  set_bytes_processed<Container>(state);
+}
+
+template <class Container> void copy(benchmark::State &state) {
+  const auto source = make_container<Container>(size_of(state));
+
+  for (auto _ : state) {
+    Container c(source);
+    benchmark::DoNotOptimize(c.data());
+  }
+
+  set_bytes_processed<Container>(state);
+}
+
+template <class Container> void move(benchmark::State &state) {
+  auto a = make_container<Container>(size_of(state));
+  Container b;
+
+  for (auto _ : state) {
+    b = std::move(a);
+    a = std::move(b);
+    benchmark::DoNotOptimize(a.data());
+  }
+}
+
+/// Erase one element at the given fraction of the size, and append one to
+/// keep the size
+template <class Container, int Percent>
+void erase(benchmark::State &state) {
+  using value_type = typename Container::value_type;
+  const auto n = size_of(state);
+  auto c = make_container<Container>(n);
+  c.reserve(n + 1);
+  const auto value = make_value<value_type>(42);
+
+  const auto pos =
+      static_cast<std::ptrdiff_t>(Percent == 100 ? n - 1 : n * Percent / 100);
+
+  for (auto _ : state) {
+    c.erase(c.begin() + pos);
+    c.push_back(value);
+    benchmark::DoNotOptimize(c.data());
+  }
+
+  state.SetBytesProcessed(
+      state.iterations() * static_cast<std::int64_t>(n - pos) *
+      static_cast<std::int64_t>(sizeof(value_type)));
+}
+
+/// Random mask erasing about Percent percent of n elements
+std::vector<bool> make_mask(std::size_t n, int Percent) {
+  std::mt19937 random(42);
+  std::uniform_int_distribution<int> percent(0, 99);
+
+  std::vector<bool> mask(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    mask[i] = percent(random) < Percent;
+  }
+  return mask;
+}
+
+template <class T, class Alloc>
+void erase_masked(std::vector<T, Alloc> &c, const std::vector<bool> &mask) {
+  auto erased = mask.begin();
+  c.erase(std::remove_if(c.begin(), c.end(),
+                         [&erased](const T &) { return *erased++; }),
+          c.end());
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+void erase_masked(mem::base_vector<T, Alloc, GrowthPolicy> &c,
+                  const std::vector<bool> &mask) {
+  c.erase(mask);
+}
+
+/// Erase a random Percent percent of the elements in a single pass
+template <class Container, int Percent>
+void erase_mask(benchmark::State &state) {
+  const auto n = size_of(state);
+  const auto c = make_container<Container>(n);
+  const auto mask = make_mask(n, Percent);
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto d = c;
+    state.ResumeTiming();
+
+    erase_masked(d, mask);
+    benchmark::DoNotOptimize(d.data());
+  }
+
+  set_bytes_processed<Container>(state);
+}
+
+template <class Container> void iterate(benchmark::State &state) {
+  const auto c = make_container<Container>(size_of(state));
+
+  for (auto _ : state) {
+    std::size_t sum = 0;
+    for (auto it = c.begin(); it != c.end(); ++it) {
+      if constexpr (std::is_same_v<typename Container::value_type,
+                                   std::string>) {
+        sum += (*it).size();
+      } else {
+        sum += static_cast<std::size_t>(*it);
+      }
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+
+  set_bytes_processed<Container>(state);
+}
+
+/// Insert a range of n / 8 elements in the middle of n elements
+template <class Container> void insert(benchmark::State &state) {
+  const auto n = size_of(state);
+  const auto c = make_container<Container>(n);
+  const auto range = make_container<Container>(n / 8);
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto d = c;
+    state.ResumeTiming();
+
+    d.insert(d.begin() + n / 2, range.begin(), range.end());
+    benchmark::DoNotOptimize(d.data());
+  }
+
+  set_bytes_processed<Container>(state);
+}
+
+/// Value initialize with all hardware threads
+template <class Container> void parallel_construct(benchmark::State &state) {
+  const auto n = size_of(state);
+
+  for (auto _ : state) {
+    Container c(mem::par, n);
+    benchmark::DoNotOptimize(c.data());
+  }
+
+  set_bytes_processed<Container>(state);
+}
+
+/// Fill with all hardware threads
+template <class Container> void parallel_fill(benchmark::State &state) {
+  using value_type = typename Container::value_type;
+  const auto n = size_of(state);
+  const auto value = make_value<value_type>(42);
+
+  for (auto _ : state) {
+    Container c(mem::par, n, value);
+    benchmark::DoNotOptimize(c.data());
+  }
+
+  set_bytes_processed<Container>(state);
+}
+
+/// Grow to n elements, which are overwritten right away (e.g. by a decoder)
+template <class Container> void resize_and_overwrite(benchmark::State &state) {
+  const auto n = size_of(state);
+  Container c;
+  c.reserve(n);
+
+  for (auto _ : state) {
+    c.resize(n);
+    std::fill(c.begin(), c.end(), 7);
+    benchmark::DoNotOptimize(c.data());
+    c.clear();
+  }
+
+  set_bytes_processed<Container>(state);
+}
+
+/// resize_and_overwrite with resize_for_overwrite, which skips zeroing
+template <class Container> void resize_for_overwrite(benchmark::State &state) {
+  const auto n = size_of(state);
+  Container c;
+  c.reserve(n);
+
+  for (auto _ : state) {
+    c.resize_for_overwrite(n);
+    std::fill(c.begin(), c.end(), 7);
+    benchmark::DoNotOptimize(c.data());
+    c.clear();
+  }
+
+  set_bytes_processed<Container>(state);
+}
+
+/// Shift all but the first element to the front
+template <class Container> void overlapped_copy(benchmark::State &state) {
+  auto c = make_container<Container>(size_of(state));
+
+  for (auto _ : state) {
+    auto end = mem::overlapped_copy(c.begin() + 1, c.end(), c.begin());
+    benchmark::DoNotOptimize(end);
+    benchmark::ClobberMemory();
+  }
+
+  set_bytes_processed<Container>(state);
+}
+} // namespace
+
+#define MEM_BENCHMARK_CONTAINERS(name, ...)                                    \
+  BENCHMARK_TEMPLATE(name, std::vector<int>, ##__VA_ARGS__)                    \
+      ->RangeMultiplier(32)                                                    \
+      ->Range(1 << 10, 1 << 20);                                               \
+  BENCHMARK_TEMPLATE(name, mem::base_vector<int>, ##__VA_ARGS__)               \
+      ->RangeMultiplier(32)                                                    \
+      ->Range(1 << 10, 1 << 20);                                               \
+  BENCHMARK_TEMPLATE(name, std::vector<double>, ##__VA_ARGS__)                 \
+      ->RangeMultiplier(32)                                                    \
+      ->Range(1 << 10, 1 << 20);                                               \
+  BENCHMARK_TEMPLATE(name, mem::base_vector<double>, ##__VA_ARGS__)            \
+      ->RangeMultiplier(32)                                                    \
+      ->Range(1 << 10, 1 << 20);                                               \
+  BENCHMARK_TEMPLATE(name, std::vector<std::string>, ##__VA_ARGS__)            \
+      ->RangeMultiplier(32)                                                    \
+      ->Range(1 << 10, 1 << 20);                                               \
+  BENCHMARK_TEMPLATE(name, mem::base_vector<std::string>, ##__VA_ARGS__)       \
+      ->RangeMultiplier(32)                                                    \
+      ->Range(1 << 10, 1 << 20)
+
+MEM_BENCHMARK_CONTAINERS(construct);
+MEM_BENCHMARK_CONTAINERS(fill);
+MEM_BENCHMARK_CONTAINERS(push_back);
+MEM_BENCHMARK_CONTAINERS(assign);
+MEM_BENCHMARK_CONTAINERS(copy);
+MEM_BENCHMARK_CONTAINERS(move);
+MEM_BENCHMARK_CONTAINERS(erase, 0);
+MEM_BENCHMARK_CONTAINERS(erase, 50);
+MEM_BENCHMARK_CONTAINERS(erase, 100);
+MEM_BENCHMARK_CONTAINERS(erase_mask, 20);
+MEM_BENCHMARK_CONTAINERS(erase_mask, 60);
+MEM_BENCHMARK_CONTAINERS(insert);
+MEM_BENCHMARK_CONTAINERS(iterate);
+MEM_BENCHMARK_CONTAINERS(overlapped_copy);
+
+// Sequential construct and fill of the same sizes are the baseline
+BENCHMARK_TEMPLATE(construct, mem::base_vector<double>)
+    ->Arg(1 << 24)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(parallel_construct, mem::base_vector<double>)
+    ->Arg(1 << 24)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(fill, mem::base_vector<std::string>)
+    ->Arg(1 << 22)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(parallel_fill, mem::base_vector<std::string>)
+    ->Arg(1 << 22)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+BENCHMARK_TEMPLATE(resize_and_overwrite, mem::base_vector<int>)
+    ->RangeMultiplier(32)
+    ->Range(1 << 10, 1 << 24);
+BENCHMARK_TEMPLATE(resize_for_overwrite, mem::base_vector<int>)
+    ->RangeMultiplier(32)
+    ->Range(1 << 10, 1 << 24);
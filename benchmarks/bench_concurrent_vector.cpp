@@ -0,0 +1,84 @@
+#include <benchmark/benchmark.h>
+
+#include "base_vector.hpp"
+#include "concurrent_vector.hpp"
+
+#include <cstdint>
+#include <mutex>
+
+// Threads appending to one shared vector: concurrent_vector against a
+// base_vector guarded by a mutex
+
+namespace {
+constexpr std::int64_t appends_per_iteration = 1000;
+
+mem::concurrent_vector<std::uint64_t> *concurrent = nullptr;
+
+mem::base_vector<std::uint64_t> *guarded = nullptr;
+std::mutex *guarded_mutex = nullptr;
+
+void setup(const benchmark::State &) {
+  concurrent = new mem::concurrent_vector<std::uint64_t>();
+  guarded = new mem::base_vector<std::uint64_t>();
+  guarded_mutex = new std::mutex();
+}
+
+void teardown(const benchmark::State &) {
+  delete concurrent;
+  delete guarded;
+  delete guarded_mutex;
+}
+
+void concurrent_push_back(benchmark::State &state) {
+  for (auto _ : state) {
+    for (std::int64_t i = 0; i < appends_per_iteration; ++i) {
+      concurrent->push_back(static_cast<std::uint64_t>(i));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * appends_per_iteration);
+}
+
+void mutex_push_back(benchmark::State &state) {
+  for (auto _ : state) {
+    for (std::int64_t i = 0; i < appends_per_iteration; ++i) {
+      std::lock_guard<std::mutex> lock(*guarded_mutex);
+      guarded->push_back(static_cast<std::uint64_t>(i));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * appends_per_iteration);
+}
+
+/// Append blocks of 100 elements with one reservation
+void concurrent_grow_by(benchmark::State &state) {
+  for (auto _ : state) {
+    for (std::int64_t i = 0; i < appends_per_iteration; i += 100) {
+      benchmark::DoNotOptimize(concurrent->grow_by(100, 1));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * appends_per_iteration);
+}
+
+void mutex_grow_by(benchmark::State &state) {
+  for (auto _ : state) {
+    for (std::int64_t i = 0; i < appends_per_iteration; i += 100) {
+      std::lock_guard<std::mutex> lock(*guarded_mutex);
+      guarded->resize(guarded->size() + 100, 1);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * appends_per_iteration);
+}
+} // namespace
+
+// Fixed iterations bound the memory of the shared vectors
+#define MEM_BENCHMARK_THREADS(name)                                            \
+  BENCHMARK(name)                                                              \
+      ->Setup(setup)                                                           \
+      ->Teardown(teardown)                                                     \
+      ->Iterations(2000)                                                       \
+      ->ThreadRange(1, 8)                                                      \
+      ->UseRealTime()
+
+MEM_BENCHMARK_THREADS(concurrent_push_back);
+MEM_BENCHMARK_THREADS(mutex_push_back);
+MEM_BENCHMARK_THREADS(concurrent_grow_by);
+MEM_BENCHMARK_THREADS(mutex_grow_by);
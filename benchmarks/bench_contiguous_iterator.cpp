@@ -0,0 +1,143 @@
+#include <benchmark/benchmark.h>
+
+#include "base_vector.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+// Standard algorithms on the iterators of a base_vector against the same
+// algorithms on raw pointers, and the internal algorithms of base_vector
+// (which unwrap their iterators) against std::vector, with 4K to 4M ints.
+//
+// Whether the standard algorithms take their memmove/memcmp paths for the
+// iterators depends on the standard library: libstdc++ 12 only does so for
+// pointers and its own iterators, so there the pointer variants are the
+// baseline, which the internal algorithms reach
+
+namespace {
+using vector = mem::base_vector<std::uint32_t>;
+
+/// Passes the iterators of a base_vector to the algorithm
+struct iterators {
+  static auto begin(vector &v) { return v.begin(); }
+  static auto end(vector &v) { return v.end(); }
+};
+
+/// Passes raw pointers to the algorithm
+struct pointers {
+  static auto begin(vector &v) { return v.data(); }
+  static auto end(vector &v) { return v.data() + v.size(); }
+};
+
+vector make_vector(const benchmark::State &state) {
+  vector v(static_cast<std::size_t>(state.range(0)));
+  std::iota(v.begin(), v.end(), 0u);
+  return v;
+}
+
+void set_bytes_processed(benchmark::State &state) {
+  state.SetBytesProcessed(
+      state.iterations() * state.range(0) *
+      static_cast<std::int64_t>(sizeof(vector::value_type)));
+}
+
+template <class Access> void copy(benchmark::State &state) {
+  vector source = make_vector(state);
+  vector target(source.size());
+
+  for (auto _ : state) {
+    auto end = std::copy(Access::begin(source), Access::end(source),
+                         Access::begin(target));
+    benchmark::DoNotOptimize(end);
+    benchmark::ClobberMemory();
+  }
+
+  set_bytes_processed(state);
+}
+
+template <class Access> void fill(benchmark::State &state) {
+  vector v = make_vector(state);
+
+  for (auto _ : state) {
+    std::fill(Access::begin(v), Access::end(v), 7u);
+    benchmark::ClobberMemory();
+  }
+
+  set_bytes_processed(state);
+}
+
+template <class Access> void equal(benchmark::State &state) {
+  vector a = make_vector(state);
+  vector b = make_vector(state);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        std::equal(Access::begin(a), Access::end(a), Access::begin(b)));
+  }
+
+  set_bytes_processed(state);
+}
+
+template <class Access> void find(benchmark::State &state) {
+  vector v = make_vector(state);
+  const auto last = static_cast<std::uint32_t>(v.size() - 1);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(std::find(Access::begin(v), Access::end(v), last));
+  }
+
+  set_bytes_processed(state);
+}
+
+/// Assign a range of the same size, i.e. copy over the existing elements
+template <class Vector> void assign(benchmark::State &state) {
+  const auto n = static_cast<std::size_t>(state.range(0));
+  std::vector<std::uint32_t> source(n);
+  std::iota(source.begin(), source.end(), 0u);
+  Vector v(n);
+
+  for (auto _ : state) {
+    v.assign(source.begin(), source.end());
+    benchmark::ClobberMemory();
+  }
+
+  set_bytes_processed(state);
+}
+
+/// Assign n copies of a value, i.e. fill the existing elements
+template <class Vector> void assign_value(benchmark::State &state) {
+  const auto n = static_cast<std::size_t>(state.range(0));
+  Vector v(n);
+
+  for (auto _ : state) {
+    v.assign(n, 7u);
+    benchmark::ClobberMemory();
+  }
+
+  set_bytes_processed(state);
+}
+} // namespace
+
+#define MEM_BENCHMARK_ACCESS(name)                                             \
+  BENCHMARK_TEMPLATE(name, iterators)                                          \
+      ->RangeMultiplier(32)                                                    \
+      ->Range(1 << 12, 1 << 22);                                               \
+  BENCHMARK_TEMPLATE(name, pointers)->RangeMultiplier(32)->Range(1 << 12, 1 << 22)
+
+MEM_BENCHMARK_ACCESS(copy);
+MEM_BENCHMARK_ACCESS(fill);
+MEM_BENCHMARK_ACCESS(equal);
+MEM_BENCHMARK_ACCESS(find);
+
+BENCHMARK_TEMPLATE(assign, vector)->RangeMultiplier(32)->Range(1 << 12, 1 << 22);
+BENCHMARK_TEMPLATE(assign, std::vector<std::uint32_t>)
+    ->RangeMultiplier(32)
+    ->Range(1 << 12, 1 << 22);
+BENCHMARK_TEMPLATE(assign_value, vector)
+    ->RangeMultiplier(32)
+    ->Range(1 << 12, 1 << 22);
+BENCHMARK_TEMPLATE(assign_value, std::vector<std::uint32_t>)
+    ->RangeMultiplier(32)
+    ->Range(1 << 12, 1 << 22);
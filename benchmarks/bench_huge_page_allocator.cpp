@@ -0,0 +1,106 @@
+#include <benchmark/benchmark.h>
+
+#include "base_vector.hpp"
+#include "huge_page_allocator.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <random>
+
+namespace {
+using huge_pages = mem::huge_page_allocator<float>;
+using huge_pages_populated =
+    mem::huge_page_allocator<float, 2 * 1024 * 1024, true>;
+
+constexpr std::int64_t MiB = 1024 * 1024;
+
+/// Random indices into a vector of size n
+mem::base_vector<std::size_t> random_indices(std::size_t n,
+                                             std::size_t count) {
+  std::mt19937_64 generator(42);
+  std::uniform_int_distribution<std::size_t> distribution(0, n - 1);
+
+  mem::base_vector<std::size_t> indices;
+  indices.reserve(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    indices.push_back(distribution(generator));
+  }
+  return indices;
+}
+
+template <class Alloc> void allocate_and_fill(benchmark::State &state) {
+  const auto n = static_cast<std::size_t>(state.range(0)) / sizeof(float);
+
+  for (auto _ : state) {
+    // Includes the page faults on first touch
+    mem::base_vector<float, Alloc> v(n, 1.0f);
+    benchmark::DoNotOptimize(v.data());
+  }
+
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+template <class Alloc> void sequential_scan(benchmark::State &state) {
+  const auto n = static_cast<std::size_t>(state.range(0)) / sizeof(float);
+  mem::base_vector<float, Alloc> v(n, 1.0f);
+
+  for (auto _ : state) {
+    float sum = 0;
+    for (auto it = v.begin(); it != v.end(); ++it) {
+      sum += *it;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+template <class Alloc> void random_scan(benchmark::State &state) {
+  const auto n = static_cast<std::size_t>(state.range(0)) / sizeof(float);
+  mem::base_vector<float, Alloc> v(n, 1.0f);
+  const auto indices = random_indices(n, 1 << 20);
+
+  for (auto _ : state) {
+    float sum = 0;
+    for (auto it = indices.begin(); it != indices.end(); ++it) {
+      sum += v[*it];
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(indices.size()));
+}
+} // namespace
+
+BENCHMARK_TEMPLATE(allocate_and_fill, std::allocator<float>)
+    ->Arg(64 * MiB)
+    ->Arg(512 * MiB)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(allocate_and_fill, huge_pages)
+    ->Arg(64 * MiB)
+    ->Arg(512 * MiB)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(allocate_and_fill, huge_pages_populated)
+    ->Arg(64 * MiB)
+    ->Arg(512 * MiB)
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_TEMPLATE(sequential_scan, std::allocator<float>)
+    ->Arg(64 * MiB)
+    ->Arg(512 * MiB)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(sequential_scan, huge_pages)
+    ->Arg(64 * MiB)
+    ->Arg(512 * MiB)
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_TEMPLATE(random_scan, std::allocator<float>)
+    ->Arg(64 * MiB)
+    ->Arg(512 * MiB)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(random_scan, huge_pages)
+    ->Arg(64 * MiB)
+    ->Arg(512 * MiB)
+    ->Unit(benchmark::kMillisecond);
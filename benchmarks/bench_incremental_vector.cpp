@@ -0,0 +1,143 @@
+#include <benchmark/benchmark.h>
+
+#include "base_vector.hpp"
+#include "incremental_vector.hpp"
+#include "segmented_vector.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+// Latency distribution of push_back while growing to 1K to 32M elements:
+// base_vector, which relocates all elements at once, against
+// incremental_vector and segmented_vector. The p50, p99, p99.9 and max
+// counters are in nanoseconds, per single push_back
+
+namespace {
+std::size_t size_of(const benchmark::State &state) {
+  return static_cast<std::size_t>(state.range(0));
+}
+
+/// Record the latency of every push_back into a histogram with logarithmic
+/// buckets (4 per power of two), which is cheap enough to not distort the
+/// measured latencies
+class latency_histogram {
+public:
+  static constexpr std::size_t sub_buckets = 4;
+  static constexpr std::size_t buckets = 64 * sub_buckets;
+
+  void record(std::uint64_t ns) {
+    ++counts_[bucket_of(ns)];
+    ++total_;
+  }
+
+  /// Upper bound of the bucket holding the given quantile, e.g. 0.999
+  double quantile(double q) const {
+    const auto target = static_cast<std::uint64_t>(q * total_);
+    std::uint64_t seen = 0;
+
+    for (std::size_t b = 0; b < buckets; ++b) {
+      seen += counts_[b];
+      if (seen > target) {
+        return upper_bound_of(b);
+      }
+    }
+    return upper_bound_of(buckets - 1);
+  }
+
+private:
+  std::uint64_t counts_[buckets] = {};
+  std::uint64_t total_ = 0;
+
+  static std::size_t bucket_of(std::uint64_t ns) {
+    if (ns < sub_buckets) {
+      return static_cast<std::size_t>(ns);
+    }
+
+    std::size_t exponent = 0;
+    while ((ns >> exponent) >= 2 * sub_buckets) {
+      ++exponent;
+    }
+    // The top bits below the leading one select the sub bucket
+    return (exponent + 1) * sub_buckets +
+           static_cast<std::size_t>((ns >> exponent) - sub_buckets);
+  }
+
+  static double upper_bound_of(std::size_t bucket) {
+    if (bucket < sub_buckets) {
+      return static_cast<double>(bucket + 1);
+    }
+
+    const std::size_t exponent = bucket / sub_buckets - 1;
+    const std::size_t mantissa = bucket % sub_buckets + sub_buckets + 1;
+    return static_cast<double>(std::uint64_t(mantissa) << exponent);
+  }
+};
+
+template <class Container> void push_back_latency(benchmark::State &state) {
+  using clock = std::chrono::steady_clock;
+  const auto n = size_of(state);
+  latency_histogram histogram;
+  clock::duration worst{};
+
+  for (auto _ : state) {
+    Container c;
+    for (std::size_t i = 0; i < n; ++i) {
+      const auto start = clock::now();
+      c.push_back(static_cast<std::uint64_t>(i));
+      const auto latency = clock::now() - start;
+
+      histogram.record(static_cast<std::uint64_t>(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(latency)
+              .count()));
+      worst = std::max(worst, latency);
+    }
+    benchmark::DoNotOptimize(&c[0]);
+  }
+
+  state.counters["p50_ns"] = histogram.quantile(0.5);
+  state.counters["p99_ns"] = histogram.quantile(0.99);
+  state.counters["p99.9_ns"] = histogram.quantile(0.999);
+  state.counters["max_ns"] =
+      std::chrono::duration<double, std::nano>(worst).count();
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <class Container> void index(benchmark::State &state) {
+  const auto n = size_of(state);
+  Container c;
+  for (std::size_t i = 0; i < n; ++i) {
+    c.push_back(static_cast<std::uint64_t>(i));
+  }
+
+  for (auto _ : state) {
+    std::uint64_t sum = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+      sum += c[i];
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+using contiguous = mem::base_vector<std::uint64_t>;
+using incremental = mem::incremental_vector<std::uint64_t>;
+using segmented = mem::segmented_vector<std::uint64_t>;
+} // namespace
+
+#define MEM_BENCHMARK_CONTAINERS(name)                                         \
+  BENCHMARK_TEMPLATE(name, contiguous)                                         \
+      ->RangeMultiplier(32)                                                    \
+      ->Range(1 << 10, 1 << 25);                                               \
+  BENCHMARK_TEMPLATE(name, incremental)                                        \
+      ->RangeMultiplier(32)                                                    \
+      ->Range(1 << 10, 1 << 25);                                               \
+  BENCHMARK_TEMPLATE(name, segmented)                                          \
+      ->RangeMultiplier(32)                                                    \
+      ->Range(1 << 10, 1 << 25)
+
+MEM_BENCHMARK_CONTAINERS(push_back_latency);
+MEM_BENCHMARK_CONTAINERS(index);
@@ -0,0 +1,66 @@
+#include <benchmark/benchmark.h>
+
+#include "base_vector.hpp"
+#include "benchmark_helpers.hpp"
+#include "overlapped_copy.hpp"
+
+#include <cstdint>
+#include <string>
+
+namespace {
+using mem::bench::make_container;
+using mem::bench::make_value;
+
+constexpr std::int64_t elements = 10'000'000;
+
+/// Shift all elements but the first one to the front
+template <class T> void shift_front(benchmark::State &state) {
+  auto v = make_container<mem::base_vector<T>>(
+      static_cast<std::size_t>(state.range(0)));
+
+  for (auto _ : state) {
+    auto end = mem::overlapped_copy(v.begin() + 1, v.end(), v.begin());
+    benchmark::DoNotOptimize(end);
+    benchmark::ClobberMemory();
+  }
+
+  state.SetBytesProcessed(state.iterations() * state.range(0) *
+                          static_cast<std::int64_t>(sizeof(T)));
+}
+
+/// Erase the first element, and append one to keep the size
+template <class T> void erase_front(benchmark::State &state) {
+  const auto n = static_cast<std::size_t>(state.range(0));
+  mem::base_vector<T> v;
+  v.reserve(n + 1);
+  for (std::size_t i = 0; i < n; ++i) {
+    v.push_back(make_value<T>(i));
+  }
+
+  for (auto _ : state) {
+    v.erase(v.begin());
+    v.push_back(make_value<T>(0));
+    benchmark::ClobberMemory();
+  }
+
+  state.SetBytesProcessed(state.iterations() * state.range(0) *
+                          static_cast<std::int64_t>(sizeof(T)));
+}
+} // namespace
+
+BENCHMARK_TEMPLATE(shift_front, int)
+    ->Arg(elements)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(shift_front, double)
+    ->Arg(elements)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(shift_front, std::string)
+    ->Arg(elements / 10)
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_TEMPLATE(erase_front, int)
+    ->Arg(elements)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(erase_front, std::string)
+    ->Arg(elements / 10)
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,125 @@
+#include <benchmark/benchmark.h>
+
+#include "base_vector.hpp"
+#include "segmented_vector.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+// Growing and reading a segmented_vector against a base_vector, which
+// reallocates as it grows, with 1K to 32M elements
+
+namespace {
+std::size_t size_of(const benchmark::State &state) {
+  return static_cast<std::size_t>(state.range(0));
+}
+
+template <class Container>
+void set_bytes_processed(benchmark::State &state) {
+  state.SetBytesProcessed(
+      state.iterations() * state.range(0) *
+      static_cast<std::int64_t>(sizeof(typename Container::value_type)));
+}
+
+template <class Container> void push_back(benchmark::State &state) {
+  const auto n = size_of(state);
+
+  for (auto _ : state) {
+    Container c;
+    for (std::size_t i = 0; i < n; ++i) {
+      c.push_back(static_cast<std::uint64_t>(i));
+    }
+    benchmark::DoNotOptimize(&c[0]);
+  }
+
+  set_bytes_processed<Container>(state);
+}
+
+/// Slowest single push_back while growing to n elements, i.e. the latency
+/// spike of the last reallocation
+template <class Container> void worst_push_back(benchmark::State &state) {
+  using clock = std::chrono::steady_clock;
+  const auto n = size_of(state);
+  clock::duration worst{};
+
+  for (auto _ : state) {
+    Container c;
+    for (std::size_t i = 0; i < n; ++i) {
+      const auto start = clock::now();
+      c.push_back(static_cast<std::uint64_t>(i));
+      worst = std::max(worst, clock::now() - start);
+    }
+    benchmark::DoNotOptimize(&c[0]);
+  }
+
+  state.counters["worst_us"] =
+      std::chrono::duration<double, std::micro>(worst).count();
+}
+
+template <class Container> void iterate(benchmark::State &state) {
+  Container c(size_of(state));
+  std::iota(c.begin(), c.end(), 0);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(std::accumulate(c.begin(), c.end(), 0ull));
+  }
+
+  set_bytes_processed<Container>(state);
+}
+
+template <class Container> void index(benchmark::State &state) {
+  const auto n = size_of(state);
+  Container c(n);
+  std::iota(c.begin(), c.end(), 0);
+
+  for (auto _ : state) {
+    std::uint64_t sum = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+      sum += c[i];
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+
+  set_bytes_processed<Container>(state);
+}
+
+/// iterate on the contiguous blocks
+template <class Container> void iterate_segments(benchmark::State &state) {
+  Container c(size_of(state));
+  std::iota(c.begin(), c.end(), 0);
+
+  for (auto _ : state) {
+    std::uint64_t sum = 0;
+    c.for_each_segment([&sum](const std::uint64_t *first,
+                              const std::uint64_t *last) {
+      sum = std::accumulate(first, last, sum);
+    });
+    benchmark::DoNotOptimize(sum);
+  }
+
+  set_bytes_processed<Container>(state);
+}
+
+using segmented = mem::segmented_vector<std::uint64_t>;
+using contiguous = mem::base_vector<std::uint64_t>;
+} // namespace
+
+#define MEM_BENCHMARK_CONTAINERS(name)                                         \
+  BENCHMARK_TEMPLATE(name, contiguous)                                         \
+      ->RangeMultiplier(32)                                                    \
+      ->Range(1 << 10, 1 << 25);                                               \
+  BENCHMARK_TEMPLATE(name, segmented)                                          \
+      ->RangeMultiplier(32)                                                    \
+      ->Range(1 << 10, 1 << 25)
+
+MEM_BENCHMARK_CONTAINERS(push_back);
+MEM_BENCHMARK_CONTAINERS(worst_push_back);
+MEM_BENCHMARK_CONTAINERS(iterate);
+MEM_BENCHMARK_CONTAINERS(index);
+
+BENCHMARK_TEMPLATE(iterate_segments, segmented)
+    ->RangeMultiplier(32)
+    ->Range(1 << 10, 1 << 25);
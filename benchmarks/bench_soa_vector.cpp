@@ -0,0 +1,98 @@
+#include <benchmark/benchmark.h>
+
+#include "base_vector.hpp"
+#include "soa_vector.hpp"
+
+#include <cstdint>
+#include <numeric>
+#include <tuple>
+
+// Scanning one field of 32 byte rows, stored as a base_vector of structs
+// (array of structures) and as a soa_vector (structure of arrays), with 1K to
+// 32M rows
+
+namespace {
+struct particle {
+  float x, y, z;
+  float vx, vy, vz;
+  float mass;
+  std::uint32_t id;
+};
+
+using particles_soa = mem::soa_vector<float, float, float, float, float, float,
+                                      float, std::uint32_t>;
+
+constexpr std::size_t mass_column = 6;
+
+std::size_t size_of(const benchmark::State &state) {
+  return static_cast<std::size_t>(state.range(0));
+}
+
+/// Bytes of the scanned field
+void set_bytes_processed(benchmark::State &state) {
+  state.SetBytesProcessed(state.iterations() * state.range(0) *
+                          static_cast<std::int64_t>(sizeof(float)));
+}
+
+particles_soa make_soa(std::size_t n) {
+  particles_soa v;
+  v.reserve(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    const float f = static_cast<float>(i);
+    v.emplace_back(f, f, f, 0.f, 0.f, 0.f, 1.f,
+                   static_cast<std::uint32_t>(i));
+  }
+  return v;
+}
+
+void aos_scan(benchmark::State &state) {
+  const auto n = size_of(state);
+  mem::base_vector<particle> v(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    v[i].mass = 1.f;
+  }
+
+  for (auto _ : state) {
+    float sum = 0.f;
+    for (const particle &p : v) {
+      sum += p.mass;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+
+  set_bytes_processed(state);
+}
+
+void soa_column_scan(benchmark::State &state) {
+  const particles_soa v = make_soa(size_of(state));
+
+  for (auto _ : state) {
+    float sum = 0.f;
+    for (float mass : v.column<mass_column>()) {
+      sum += mass;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+
+  set_bytes_processed(state);
+}
+
+/// Scan through the proxies of the zip iterators
+void soa_zip_scan(benchmark::State &state) {
+  const particles_soa v = make_soa(size_of(state));
+
+  for (auto _ : state) {
+    float sum = 0.f;
+    for (auto row : v) {
+      sum += std::get<mass_column>(row);
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+
+  set_bytes_processed(state);
+}
+} // namespace
+
+BENCHMARK(aos_scan)->RangeMultiplier(32)->Range(1 << 10, 1 << 25);
+BENCHMARK(soa_column_scan)->RangeMultiplier(32)->Range(1 << 10, 1 << 25);
+BENCHMARK(soa_zip_scan)->RangeMultiplier(32)->Range(1 << 10, 1 << 25);
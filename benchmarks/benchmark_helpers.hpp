@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <type_traits>
+
+namespace mem::bench {
+
+/// Element number i of a benchmark container. Strings are long enough to not
+/// fit into the small string buffer, so they own heap memory
+template <class T> T make_value(std::size_t i) {
+  if constexpr (std::is_same_v<T, std::string>) {
+    return std::string(32, 'x') + std::to_string(i);
+  } else {
+    return static_cast<T>(i);
+  }
+}
+
+/// Container of n elements, made with make_value
+template <class Container> Container make_container(std::size_t n) {
+  using value_type = typename Container::value_type;
+
+  Container c;
+  c.reserve(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    c.push_back(make_value<value_type>(i));
+  }
+  return c;
+}
+
+} // namespace mem::bench
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+#include "assume_aligned.hpp"
+
+namespace mem {
+
+/**
+ * @brief Allocator returning blocks aligned to Alignment bytes, e.g. 32 for
+ * AVX2 or 64 for AVX-512 and cache lines.
+ *
+ * The size of each block is padded to a multiple of Alignment, so a kernel
+ * processing the elements in blocks of Alignment bytes can load the last,
+ * partial block without touching memory outside of the allocation (the
+ * padding is uninitialized).
+ *
+ * base_vector detects the alignment (see detail::allocator_alignment), and
+ * offers aligned_data(), which passes it on to the compiler.
+ *
+ * @tparam T type of the allocated elements
+ * @tparam Alignment alignment in bytes, a power of two of at least alignof(T)
+ */
+template <class T, std::size_t Alignment = 64> class aligned_allocator {
+  static_assert((Alignment & (Alignment - 1)) == 0,
+                "Alignment needs to be a power of two");
+  static_assert(Alignment >= alignof(T),
+                "Alignment can't be weaker than the alignment of T");
+
+public:
+  using value_type = T;
+
+  using pointer = T *;
+  using const_pointer = const T *;
+
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+
+  using is_always_equal = std::true_type;
+  using propagate_on_container_move_assignment = std::true_type;
+
+  template <class U> struct rebind {
+    using other = aligned_allocator<U, Alignment>;
+  };
+
+  /// Alignment of all returned blocks
+  static constexpr std::size_t alignment = Alignment;
+
+  aligned_allocator() noexcept = default;
+
+  template <class U>
+  aligned_allocator(const aligned_allocator<U, Alignment> &) noexcept {}
+
+  pointer allocate(size_type n);
+
+  void deallocate(pointer p, size_type n) noexcept;
+
+private:
+  /// Size in bytes of a block of n elements, padded to the alignment
+  static size_type padded_size(size_type n);
+};
+
+template <class T, std::size_t Alignment>
+typename aligned_allocator<T, Alignment>::pointer
+aligned_allocator<T, Alignment>::allocate(size_type n) {
+  if (n > (static_cast<size_type>(-1) - Alignment) / sizeof(T)) {
+    throw std::bad_array_new_length();
+  }
+  return static_cast<pointer>(
+      ::operator new(padded_size(n), std::align_val_t(Alignment)));
+}
+
+template <class T, std::size_t Alignment>
+void aligned_allocator<T, Alignment>::deallocate(pointer p,
+                                                 size_type n) noexcept {
+  ::operator delete(static_cast<void *>(p), padded_size(n),
+                    std::align_val_t(Alignment));
+}
+
+template <class T, std::size_t Alignment>
+typename aligned_allocator<T, Alignment>::size_type
+aligned_allocator<T, Alignment>::padded_size(size_type n) {
+  return (n * sizeof(T) + Alignment - 1) / Alignment * Alignment;
+}
+
+template <class T, class U, std::size_t Alignment>
+bool operator==(const aligned_allocator<T, Alignment> &,
+                const aligned_allocator<U, Alignment> &) {
+  return true;
+}
+
+template <class T, class U, std::size_t Alignment>
+bool operator!=(const aligned_allocator<T, Alignment> &,
+                const aligned_allocator<U, Alignment> &) {
+  return false;
+}
+
+} // namespace mem
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+namespace mem {
+
+/// Tell the compiler, that p is aligned to N bytes, so it can emit aligned
+/// vector loads and stores. The behavior is undefined, if it isn't
+template <std::size_t N, class T> T *assume_aligned(T *p) {
+  static_assert(N > 0 && (N & (N - 1)) == 0,
+                "alignment needs to be a power of two");
+#if defined(__cpp_lib_assume_aligned)
+  return std::assume_aligned<N>(p);
+#elif defined(__GNUC__) || defined(__clang__)
+  return static_cast<T *>(__builtin_assume_aligned(p, N));
+#else
+  return p;
+#endif
+}
+
+} // namespace mem
@@ -1,14 +1,41 @@
 #pragma once
 
+#include <algorithm>
 #include <cstddef>
 #include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
 #include <vector>
 
+#include "assume_aligned.hpp"
+#include "compact.hpp"
 #include "contiguous_storage.hpp"
+#include "growth_policy.hpp"
+#include "overlapped_copy.hpp"
 
 namespace mem {
-template <class T, class Alloc> class base_vector {
-private:
+
+/// Tag to leave new elements default initialized, instead of value
+/// initialized, i.e. trivial types stay uninitialized
+struct default_init_t {
+  explicit default_init_t() = default;
+};
+
+inline constexpr default_init_t default_init{};
+
+/**
+ * @brief Dynamically sized contiguous container
+ *
+ * @tparam T type of the stored elements
+ * @tparam Alloc allocator used to acquire the memory buffer
+ * @tparam GrowthPolicy policy computing the new capacity, if the container
+ * runs out of space (see growth_policy.hpp)
+ */
+template <class T, class Alloc = std::allocator<T>,
+          class GrowthPolicy = growth::default_policy>
+class base_vector {
+protected:
   using storage_type = typename detail::contiguous_storage<T, Alloc>;
 
 public:
@@ -26,6 +53,13 @@ public:
 
   using allocator_type = typename storage_type::allocator_type;
 
+  using growth_policy = GrowthPolicy;
+
+  /// Alignment of the buffer, more than alignof(T) for over-aligning
+  /// allocators (e.g. aligned_allocator)
+  static constexpr std::size_t alignment =
+      detail::allocator_alignment<Alloc>::value;
+
   using iterator = typename storage_type::iterator;
   using const_iterator = typename storage_type::const_iterator;
 
@@ -41,12 +75,16 @@ public:
   /// create empty vector with given allocator
   explicit base_vector(const Alloc &alloc);
 
-  /// create vector of size n, with default initialized values
+  /// create vector of size n, with value initialized values
   explicit base_vector(size_type n);
 
-  /// create vector of size n, with default initialized values
+  /// create vector of size n, with value initialized values
   explicit base_vector(size_type n, const Alloc &alloc);
 
+  /// create vector of size n, with default initialized values, i.e. trivial
+  /// types are left uninitialized, for buffers which are overwritten anyway
+  base_vector(default_init_t, size_type n, const Alloc &alloc = Alloc());
+
   /// create vector of size n, with copies of value
   explicit base_vector(size_type n, const value_type &value);
 
@@ -70,12 +108,13 @@ public:
   base_vector &operator=(base_vector &&v);
 
   /// Copy constructor from exemplar base_vector with different type
-  template <class OtherT, class OtherAlloc>
-  base_vector(const base_vector<OtherT, OtherAlloc> &v);
+  template <class OtherT, class OtherAlloc, class OtherGrowthPolicy>
+  base_vector(const base_vector<OtherT, OtherAlloc, OtherGrowthPolicy> &v);
 
   /// Copy assignment from exemplar base_vector with different type
-  template <class OtherT, class OtherAlloc>
-  base_vector &operator=(const base_vector<OtherT, OtherAlloc> &v);
+  template <class OtherT, class OtherAlloc, class OtherGrowthPolicy>
+  base_vector &
+  operator=(const base_vector<OtherT, OtherAlloc, OtherGrowthPolicy> &v);
 
   /// Copy constructor from given std::vector with different type
   template <class OtherT, class OtherAlloc>
@@ -92,16 +131,63 @@ public:
   template <typename InputIter>
   base_vector(InputIter first, InputIter last, const Alloc &alloc);
 
+  /// create vector of size n, with value initialized values, which are
+  /// constructed in parallel (see parallel_policy)
+  base_vector(const parallel_policy &policy, size_type n,
+              const Alloc &alloc = Alloc());
+
+  /// create vector of size n, with copies of value, which are constructed in
+  /// parallel (see parallel_policy)
+  base_vector(const parallel_policy &policy, size_type n,
+              const value_type &value, const Alloc &alloc = Alloc());
+
+  /// Copy constructor, which copies the elements in parallel (see
+  /// parallel_policy)
+  base_vector(const parallel_policy &policy, const base_vector &v);
+
+  /// Construct base_vector from iterator range, random access ranges are
+  /// copied in parallel (see parallel_policy)
+  template <typename InputIter,
+            typename = std::enable_if_t<!std::is_integral_v<InputIter>>>
+  base_vector(const parallel_policy &policy, InputIter first, InputIter last,
+              const Alloc &alloc = Alloc());
+
   /// Destructor
   ~base_vector();
 
-  /// Shrink or grow current size of the buffer
+protected:
+  /// Create empty vector, which uses the given buffer of size capacity, until
+  /// it has to grow. The buffer is owned by the caller (e.g. a derived class)
+  /// and has to outlive the vector
+  base_vector(detail::external_buffer_t, pointer buffer, size_type capacity,
+              const Alloc &alloc);
+
+public:
+  /// Shrink or grow current size of the buffer, new elements are value
+  /// initialized
   void resize(size_type new_size);
 
   /// Shrink or grow current size of the buffer, new elements will have the
   /// given value
   void resize(size_type new_size, const value_type &value);
 
+  /// Shrink or grow current size of the buffer, new elements are default
+  /// initialized, i.e. trivial types are left uninitialized. For buffers,
+  /// which are overwritten right away (e.g. by a read from a socket)
+  void resize_for_overwrite(size_type new_size);
+
+  /// Append a copy of value, amortized O(1)
+  void push_back(const value_type &value);
+
+  /// Append value by moving it, amortized O(1)
+  void push_back(value_type &&value);
+
+  /// Append an element constructed in place from args, amortized O(1)
+  template <class... Args> reference emplace_back(Args &&...args);
+
+  /// Remove the last element, the vector must not be empty
+  void pop_back();
+
   /// return the current number of elements
   size_type size() const;
 
@@ -109,7 +195,8 @@ public:
   size_type max_size() const;
 
   /// request for larger buffer, if it's smaller than current capacity, this
-  /// function has no effect
+  /// function has no effect. Throws std::length_error, if new_capacity is
+  /// larger than max_size()
   void reserve(size_type new_capacity);
 
   /// Current capacity (i.e. allocated memory buffer)
@@ -137,10 +224,22 @@ public:
 
   const_pointer data() const;
 
+  /// data(), with the alignment of the buffer passed on to the compiler, so it
+  /// can use aligned vector instructions
+  pointer aligned_data();
+
+  /// data(), with the alignment of the buffer passed on to the compiler, so it
+  /// can use aligned vector instructions
+  const_pointer aligned_data() const;
+
   /// returns true iff size() == 0
   bool empty() const;
 
-  /// Swap elements of this vector with given vector
+  /// Destroy all elements, the capacity is left unchanged
+  void clear();
+
+  /// Swap elements of this vector with given vector. This only swaps the
+  /// buffers, if both vectors own them, otherwise the elements are moved
   void swap(base_vector &v);
 
   /// TODO: What does this do exactly?
@@ -156,21 +255,124 @@ public:
 
   iterator erase(iterator first, iterator last);
 
+  /// Erase the elements, for which mask is true, in a single pass. mask is a
+  /// range of size() values convertible to bool (e.g. std::vector<bool>).
+  /// Returns the number of erased elements
+  template <class MaskRange,
+            typename = std::enable_if_t<
+                !std::is_convertible_v<const MaskRange &, iterator>>>
+  size_type erase(const MaskRange &mask);
+
+  /// Insert a copy of value before pos, returns an iterator to it
+  iterator insert(iterator pos, const value_type &value);
+
+  /// Insert value before pos by moving it, returns an iterator to it
+  iterator insert(iterator pos, value_type &&value);
+
+  /// Insert n copies of value before pos, returns an iterator to the first
+  iterator insert(iterator pos, size_type n, const value_type &value);
+
+  /// Insert a copy of [first, last) before pos, returns an iterator to the
+  /// first inserted element. [first, last) must not refer to this vector.
+  /// The buffer is reallocated at most once, input ranges are appended and
+  /// rotated into place, so the tail is moved only once as well
+  template <class InputIter>
+  iterator insert(iterator pos, InputIter first, InputIter last);
+
+  /// Insert an element constructed in place from args before pos, returns an
+  /// iterator to it
+  template <class... Args> iterator emplace(iterator pos, Args &&...args);
+
 private:
   void default_init(size_type n);
 
+  void default_init(default_init_t, size_type n);
+
   void fill_init(size_type n, const value_type &value);
 
+  void default_init(const parallel_policy &policy, size_type n);
+
+  void fill_init(const parallel_policy &policy, size_type n,
+                 const value_type &value);
+
+  template <typename InputIterator>
+  void range_init(const parallel_policy &policy, InputIterator first,
+                  InputIterator last, std::input_iterator_tag);
+
+  template <typename ForwardIterator>
+  void range_init(const parallel_policy &policy, ForwardIterator first,
+                  ForwardIterator last, std::forward_iterator_tag);
+
   template <typename InputIterator>
   void range_init(InputIterator first, InputIterator last);
 
   template <typename InputIterator>
   void range_init(InputIterator first, InputIterator last,
-                  std::forward_iterator_tag);
+                  std::input_iterator_tag);
 
   template <typename ForwardIterator>
   void range_init(ForwardIterator first, ForwardIterator last,
-                  std::random_access_iterator_tag);
+                  std::forward_iterator_tag);
+
+  /// Capacity to grow to, such that at least required elements fit, as given
+  /// by the growth policy
+  size_type next_capacity(size_type required) const;
+
+  /// Grow the buffer to new_capacity and append n elements. construct_tail
+  /// is called with an iterator to position size() in the grown buffer, and
+  /// must construct n elements there.
+  ///
+  /// The allocator is asked to expand the buffer in place first. Otherwise a
+  /// new buffer is allocated, and construct_tail is called before the existing
+  /// elements are relocated, such that arguments referring to elements of this
+  /// vector stay valid during construction. Only if may_move_buffer is set
+  /// (i.e. construct_tail can't refer to the old buffer), the allocator may
+  /// move the buffer itself (see contiguous_storage::try_reallocate)
+  template <typename TailConstructor>
+  void reallocate_append(size_type new_capacity, size_type n,
+                         TailConstructor construct_tail, bool may_move_buffer);
+
+  /// Append n elements constructed by construct_tail (see reallocate_append),
+  /// grows the buffer using the growth policy if necessary
+  template <typename TailConstructor>
+  void append(size_type n, TailConstructor construct_tail,
+              bool may_move_buffer);
+
+  /// Insert n elements constructed by construct (see reallocate_append)
+  /// before index, the buffer is reallocated at most once
+  template <typename Constructor>
+  iterator insert_n(size_type index, size_type n, Constructor construct);
+
+  /// Make room for n elements at index by relocating the tail bytewise, and
+  /// construct them there
+  template <typename Constructor>
+  void insert_in_place(size_type index, size_type n, Constructor construct,
+                       std::true_type);
+
+  /// Construct n elements at the end, and rotate them to index
+  template <typename Constructor>
+  void insert_in_place(size_type index, size_type n, Constructor construct,
+                       std::false_type);
+
+  template <typename Integral>
+  iterator insert_dispatch(iterator pos, Integral n, Integral value,
+                           std::true_type);
+
+  template <typename InputIterator>
+  iterator insert_dispatch(iterator pos, InputIterator first,
+                           InputIterator last, std::false_type);
+
+  template <typename InputIterator>
+  iterator range_insert(size_type index, InputIterator first,
+                        InputIterator last, std::input_iterator_tag);
+
+  template <typename ForwardIterator>
+  iterator range_insert(size_type index, ForwardIterator first,
+                        ForwardIterator last, std::forward_iterator_tag);
+
+  void erase_dispatch(iterator first, iterator last, std::true_type);
+
+  void erase_dispatch(iterator first, iterator last, std::false_type);
 
   template <typename IteratorOrIntegralType>
   void init_dispatch(IteratorOrIntegralType begin, IteratorOrIntegralType end,
@@ -186,65 +388,131 @@ private:
   void assign_dispatch(InputIterator first, InputIterator last,
                        std::false_type);
 
+  template <typename InputIterator>
+  void range_assign(InputIterator first, InputIterator last,
+                    std::input_iterator_tag);
+
+  template <typename ForwardIterator>
+  void range_assign(ForwardIterator first, ForwardIterator last,
+                    std::forward_iterator_tag);
+
   template <typename Integral>
   void assign_dispatch(Integral n, Integral x, std::true_type);
 };
 
-template <class T, class Alloc>
-base_vector<T, Alloc>::base_vector() : storage_(), size_(0) {}
+template <class T, class Alloc, class GrowthPolicy>
+base_vector<T, Alloc, GrowthPolicy>::base_vector() : storage_(), size_(0) {}
 
-template <class T, class Alloc>
-base_vector<T, Alloc>::base_vector(const Alloc &alloc)
+template <class T, class Alloc, class GrowthPolicy>
+base_vector<T, Alloc, GrowthPolicy>::base_vector(const Alloc &alloc)
     : storage_(alloc), size_(0) {}
 
-template <class T, class Alloc>
-base_vector<T, Alloc>::base_vector(size_type n) : storage_(), size_(0) {
+template <class T, class Alloc, class GrowthPolicy>
+base_vector<T, Alloc, GrowthPolicy>::base_vector(size_type n)
+    : storage_(), size_(0) {
   default_init(n);
 }
 
-template <class T, class Alloc>
-base_vector<T, Alloc>::base_vector(size_type n, const Alloc &alloc)
+template <class T, class Alloc, class GrowthPolicy>
+base_vector<T, Alloc, GrowthPolicy>::base_vector(size_type n,
+                                                 const Alloc &alloc)
     : storage_(alloc), size_(0) {
   default_init(n);
 }
 
-template <class T, class Alloc>
-base_vector<T, Alloc>::base_vector(size_type n, const value_type &value)
+template <class T, class Alloc, class GrowthPolicy>
+base_vector<T, Alloc, GrowthPolicy>::base_vector(default_init_t tag,
+                                                 size_type n,
+                                                 const Alloc &alloc)
+    : storage_(alloc), size_(0) {
+  default_init(tag, n);
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+base_vector<T, Alloc, GrowthPolicy>::base_vector(size_type n,
+                                                 const value_type &value)
     : storage_(), size_(0) {
   fill_init(n, value);
 }
 
-template <class T, class Alloc>
-base_vector<T, Alloc>::base_vector(size_type n, const value_type &value,
-                                   const Alloc &alloc)
+template <class T, class Alloc, class GrowthPolicy>
+base_vector<T, Alloc, GrowthPolicy>::base_vector(size_type n,
+                                                 const value_type &value,
+                                                 const Alloc &alloc)
     : storage_(alloc), size_(0) {
   fill_init(n, value);
 }
 
-template <class T, class Alloc>
-base_vector<T, Alloc>::base_vector(const base_vector &v)
-    : storage_(detail::copy_allocator_t{}, v.storage_), size_(0) {
+template <class T, class Alloc, class GrowthPolicy>
+base_vector<T, Alloc, GrowthPolicy>::base_vector(const base_vector &v)
+    : storage_(std::allocator_traits<Alloc>::
+                   select_on_container_copy_construction(v.get_allocator())),
+      size_(0) {
   range_init(v.cbegin(), v.cend());
 }
 
-template <class T, class Alloc>
-base_vector<T, Alloc>::base_vector(const base_vector &v, const Alloc &alloc)
+template <class T, class Alloc, class GrowthPolicy>
+base_vector<T, Alloc, GrowthPolicy>::base_vector(const base_vector &v,
+                                                 const Alloc &alloc)
     : storage_(alloc), size_(0) {
   range_init(v.cbegin(), v.cend());
 }
 
-template <class T, class Alloc>
-base_vector<T, Alloc>::base_vector(base_vector &&v)
+template <class T, class Alloc, class GrowthPolicy>
+base_vector<T, Alloc, GrowthPolicy>::base_vector(const parallel_policy &policy,
+                                                 size_type n,
+                                                 const Alloc &alloc)
+    : storage_(alloc), size_(0) {
+  default_init(policy, n);
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+base_vector<T, Alloc, GrowthPolicy>::base_vector(const parallel_policy &policy,
+                                                 size_type n,
+                                                 const value_type &value,
+                                                 const Alloc &alloc)
+    : storage_(alloc), size_(0) {
+  fill_init(policy, n, value);
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+base_vector<T, Alloc, GrowthPolicy>::base_vector(const parallel_policy &policy,
+                                                 const base_vector &v)
+    : storage_(std::allocator_traits<Alloc>::
+                   select_on_container_copy_construction(v.get_allocator())),
+      size_(0) {
+  range_init(policy, v.cbegin(), v.cend(), std::random_access_iterator_tag());
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+template <typename InputIter, typename>
+base_vector<T, Alloc, GrowthPolicy>::base_vector(const parallel_policy &policy,
+                                                 InputIter first,
+                                                 InputIter last,
+                                                 const Alloc &alloc)
+    : storage_(alloc), size_(0) {
+  range_init(policy, first, last,
+             typename std::iterator_traits<InputIter>::iterator_category());
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+base_vector<T, Alloc, GrowthPolicy>::base_vector(base_vector &&v)
     : storage_(detail::copy_allocator_t{}, v.storage_), size_(0) {
   *this = std::move(v);
 }
 
-template <class T, class Alloc>
-base_vector<T, Alloc> &base_vector<T, Alloc>::operator=(const base_vector &v) {
+template <class T, class Alloc, class GrowthPolicy>
+base_vector<T, Alloc, GrowthPolicy> &
+base_vector<T, Alloc, GrowthPolicy>::operator=(const base_vector &v) {
   if (this != &v) {
     storage_.destroy_on_allocator_mismatch(v.storage_, begin(), end());
     storage_.deallocate_on_allocator_mismatch(v.storage_);
 
+    // If the buffer was released above, the elements were destroyed as well
+    if (capacity() == 0) {
+      size_ = 0;
+    }
+
     storage_.propagate_allocator(v.storage_);
 
     assign(v.begin(), v.end());
@@ -253,258 +521,883 @@ base_vector<T, Alloc> &base_vector<T, Alloc>::operator=(const base_vector &v) {
   return *this;
 }
 
-template <class T, class Alloc>
-base_vector<T, Alloc> &base_vector<T, Alloc>::operator=(base_vector &&v) {
+template <class T, class Alloc, class GrowthPolicy>
+base_vector<T, Alloc, GrowthPolicy> &
+base_vector<T, Alloc, GrowthPolicy>::operator=(base_vector &&v) {
+  if (this == &v) {
+    return *this;
+  }
+
+  constexpr bool propagate = std::allocator_traits<
+      Alloc>::propagate_on_container_move_assignment::value;
+
+  if (!v.storage_.owns_buffer() ||
+      (!propagate && storage_.is_allocator_not_equal(v.storage_))) {
+    // The buffer of v can't be taken over (e.g. it's the inline buffer of a
+    // small_vector, or our allocator can't deallocate it), so move the
+    // elements instead
+    assign(std::make_move_iterator(v.begin()),
+           std::make_move_iterator(v.end()));
+    v.clear();
+    return *this;
+  }
+
   storage_.destroy(begin(), end());
   storage_ = std::move(v.storage_);
   size_ = std::move(v.size_);
 
-  v.storage_ = detail::contiguous_storage<T, Alloc>(detail::copy_allocator_t(),
-                                                    storage_);
+  v.storage_ = storage_type(detail::copy_allocator_t(), storage_);
   v.size_ = 0;
 
   return *this;
 }
 
-template <class T, class Alloc>
-template <class OtherT, class OtherAlloc>
-base_vector<T, Alloc>::base_vector(const base_vector<OtherT, OtherAlloc> &v) {
+template <class T, class Alloc, class GrowthPolicy>
+template <class OtherT, class OtherAlloc, class OtherGrowthPolicy>
+base_vector<T, Alloc, GrowthPolicy>::base_vector(
+    const base_vector<OtherT, OtherAlloc, OtherGrowthPolicy> &v)
+    : storage_(), size_(0) {
   range_init(v.cbegin(), v.cend());
 }
 
-template <class T, class Alloc>
-template <class OtherT, class OtherAlloc>
-base_vector<T, Alloc> &
-base_vector<T, Alloc>::operator=(const base_vector<OtherT, OtherAlloc> &v) {
+template <class T, class Alloc, class GrowthPolicy>
+template <class OtherT, class OtherAlloc, class OtherGrowthPolicy>
+base_vector<T, Alloc, GrowthPolicy> &
+base_vector<T, Alloc, GrowthPolicy>::operator=(
+    const base_vector<OtherT, OtherAlloc, OtherGrowthPolicy> &v) {
   assign(v.begin(), v.end());
   return *this;
 }
 
-template <class T, class Alloc>
+template <class T, class Alloc, class GrowthPolicy>
 template <class OtherT, class OtherAlloc>
-base_vector<T, Alloc>::base_vector(const std::vector<OtherT, OtherAlloc> &v)
+base_vector<T, Alloc, GrowthPolicy>::base_vector(
+    const std::vector<OtherT, OtherAlloc> &v)
     : storage_(), size_(0) {
-  range_fill(v.begin(), v.end());
+  range_init(v.begin(), v.end());
 }
 
-template <class T, class Alloc>
+template <class T, class Alloc, class GrowthPolicy>
 template <class OtherT, class OtherAlloc>
-base_vector<T, Alloc> &
-base_vector<T, Alloc>::operator=(const std::vector<OtherT, OtherAlloc> &v) {
+base_vector<T, Alloc, GrowthPolicy> &
+base_vector<T, Alloc, GrowthPolicy>::operator=(
+    const std::vector<OtherT, OtherAlloc> &v) {
   assign(v.begin(), v.end());
   return *this;
 }
 
-template <class T, class Alloc>
+template <class T, class Alloc, class GrowthPolicy>
 template <typename InputIter>
-base_vector<T, Alloc>::base_vector(InputIter first, InputIter last)
+base_vector<T, Alloc, GrowthPolicy>::base_vector(InputIter first,
+                                                 InputIter last)
     : storage_(), size_(0) {
   // check the type of InputIterator: if it's an integral type,
   // we need to interpret this call as (size_type, value_type)
-  constexpr bool IsInteger = std::is_integral_v<InputIter>;
+  using IsInteger = std::is_integral<InputIter>;
 
-  init_dispatch(first, last, IsInteger);
+  init_dispatch(first, last, IsInteger());
 }
 
-template <class T, class Alloc>
+template <class T, class Alloc, class GrowthPolicy>
 template <typename InputIter>
-base_vector<T, Alloc>::base_vector(InputIter first, InputIter last,
-                                   const Alloc &alloc)
+base_vector<T, Alloc, GrowthPolicy>::base_vector(InputIter first,
+                                                 InputIter last,
+                                                 const Alloc &alloc)
     : storage_(alloc), size_(0) {
   // check the type of InputIterator: if it's an integral type,
   // we need to interpret this call as (size_type, value_type)
-  constexpr bool IsInteger = std::is_integral_v<InputIter>;
+  using IsInteger = std::is_integral<InputIter>;
 
-  init_dispatch(first, last, IsInteger);
+  init_dispatch(first, last, IsInteger());
 }
 
-template <class T, class Alloc> base_vector<T, Alloc>::~base_vector() {
+template <class T, class Alloc, class GrowthPolicy>
+base_vector<T, Alloc, GrowthPolicy>::base_vector(detail::external_buffer_t,
+                                                 pointer buffer,
+                                                 size_type capacity,
+                                                 const Alloc &alloc)
+    : storage_(detail::external_buffer_t{}, buffer, capacity, alloc),
+      size_(0) {}
+
+template <class T, class Alloc, class GrowthPolicy>
+base_vector<T, Alloc, GrowthPolicy>::~base_vector() {
   if (!empty()) {
     storage_.destroy(begin(), end());
   }
 }
 
-template <class T, class Alloc>
-void base_vector<T, Alloc>::resize(size_type new_size) {}
+template <class T, class Alloc, class GrowthPolicy>
+void base_vector<T, Alloc, GrowthPolicy>::resize(size_type new_size) {
+  if (new_size < size()) {
+    erase(begin() + new_size, end());
+  } else {
+    append(
+        new_size - size(),
+        [this](iterator pos, size_type n) {
+          storage_.value_construct_n(pos, n);
+        },
+        true);
+  }
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+void base_vector<T, Alloc, GrowthPolicy>::resize(size_type new_size,
+                                                 const value_type &value) {
+  if (new_size < size()) {
+    erase(begin() + new_size, end());
+  } else {
+    append(
+        new_size - size(),
+        [this, &value](iterator pos, size_type n) {
+          storage_.uninitialized_fill_n(pos, n, value);
+        },
+        false);
+  }
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+void base_vector<T, Alloc, GrowthPolicy>::resize_for_overwrite(
+    size_type new_size) {
+  if (new_size < size()) {
+    erase(begin() + new_size, end());
+  } else {
+    append(
+        new_size - size(),
+        [this](iterator pos, size_type n) {
+          storage_.default_construct_n(pos, n);
+        },
+        true);
+  }
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+void base_vector<T, Alloc, GrowthPolicy>::push_back(const value_type &value) {
+  emplace_back(value);
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+void base_vector<T, Alloc, GrowthPolicy>::push_back(value_type &&value) {
+  emplace_back(std::move(value));
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+template <class... Args>
+typename base_vector<T, Alloc, GrowthPolicy>::reference
+base_vector<T, Alloc, GrowthPolicy>::emplace_back(Args &&...args) {
+  append(
+      1,
+      [this, &args...](iterator pos, size_type) {
+        storage_.construct(pos, std::forward<Args>(args)...);
+      },
+      false);
+  return storage_[size() - 1];
+}
 
-template <class T, class Alloc>
-void base_vector<T, Alloc>::resize(size_type new_size,
-                                   const value_type &value) {}
+template <class T, class Alloc, class GrowthPolicy>
+void base_vector<T, Alloc, GrowthPolicy>::pop_back() {
+  storage_.destroy(end() - 1, end());
+  --size_;
+}
 
-template <class T, class Alloc>
-typename base_vector<T, Alloc>::size_type base_vector<T, Alloc>::size() const {
+template <class T, class Alloc, class GrowthPolicy>
+typename base_vector<T, Alloc, GrowthPolicy>::size_type
+base_vector<T, Alloc, GrowthPolicy>::size() const {
   return size_;
 }
 
-template <class T, class Alloc>
-typename base_vector<T, Alloc>::size_type
-base_vector<T, Alloc>::max_size() const {
+template <class T, class Alloc, class GrowthPolicy>
+typename base_vector<T, Alloc, GrowthPolicy>::size_type
+base_vector<T, Alloc, GrowthPolicy>::max_size() const {
   return storage_.max_size();
 }
 
-template <class T, class Alloc>
-void base_vector<T, Alloc>::reserve(size_type new_capacity) {}
+template <class T, class Alloc, class GrowthPolicy>
+void base_vector<T, Alloc, GrowthPolicy>::reserve(size_type new_capacity) {
+  if (new_capacity > capacity()) {
+    if (new_capacity > max_size()) {
+      throw std::length_error("base_vector::reserve: requested capacity "
+                              "exceeds max_size()");
+    }
+
+    reallocate_append(
+        new_capacity, 0, [](iterator, size_type) {}, true);
+  }
+}
 
-template <class T, class Alloc>
-typename base_vector<T, Alloc>::size_type
-base_vector<T, Alloc>::capacity() const {
+template <class T, class Alloc, class GrowthPolicy>
+typename base_vector<T, Alloc, GrowthPolicy>::size_type
+base_vector<T, Alloc, GrowthPolicy>::capacity() const {
   return storage_.size();
 }
 
-template <class T, class Alloc>
-typename base_vector<T, Alloc>::reference
-base_vector<T, Alloc>::operator[](size_type idx) {
+template <class T, class Alloc, class GrowthPolicy>
+typename base_vector<T, Alloc, GrowthPolicy>::reference
+base_vector<T, Alloc, GrowthPolicy>::operator[](size_type idx) {
   return storage_[idx];
 }
 
-template <class T, class Alloc>
-typename base_vector<T, Alloc>::const_reference
-base_vector<T, Alloc>::operator[](size_type idx) const {
+template <class T, class Alloc, class GrowthPolicy>
+typename base_vector<T, Alloc, GrowthPolicy>::const_reference
+base_vector<T, Alloc, GrowthPolicy>::operator[](size_type idx) const {
   return storage_[idx];
 }
 
-template <class T, class Alloc>
-typename base_vector<T, Alloc>::iterator base_vector<T, Alloc>::begin() {
+template <class T, class Alloc, class GrowthPolicy>
+typename base_vector<T, Alloc, GrowthPolicy>::iterator
+base_vector<T, Alloc, GrowthPolicy>::begin() {
   return storage_.begin();
 }
 
-template <class T, class Alloc>
-typename base_vector<T, Alloc>::const_iterator
-base_vector<T, Alloc>::begin() const {
+template <class T, class Alloc, class GrowthPolicy>
+typename base_vector<T, Alloc, GrowthPolicy>::const_iterator
+base_vector<T, Alloc, GrowthPolicy>::begin() const {
   return storage_.begin();
 }
 
-template <class T, class Alloc>
-typename base_vector<T, Alloc>::const_iterator
-base_vector<T, Alloc>::cbegin() const {
+template <class T, class Alloc, class GrowthPolicy>
+typename base_vector<T, Alloc, GrowthPolicy>::const_iterator
+base_vector<T, Alloc, GrowthPolicy>::cbegin() const {
   return storage_.cbegin();
 }
 
-template <class T, class Alloc>
-typename base_vector<T, Alloc>::iterator base_vector<T, Alloc>::end() {
-  return storage_.end();
+template <class T, class Alloc, class GrowthPolicy>
+typename base_vector<T, Alloc, GrowthPolicy>::iterator
+base_vector<T, Alloc, GrowthPolicy>::end() {
+  return begin() + size();
 }
 
-template <class T, class Alloc>
-typename base_vector<T, Alloc>::const_iterator
-base_vector<T, Alloc>::end() const {
-  return storage_.end();
+template <class T, class Alloc, class GrowthPolicy>
+typename base_vector<T, Alloc, GrowthPolicy>::const_iterator
+base_vector<T, Alloc, GrowthPolicy>::end() const {
+  return begin() + size();
 }
 
-template <class T, class Alloc>
-typename base_vector<T, Alloc>::const_iterator
-base_vector<T, Alloc>::cend() const {
-  return storage_.cend();
+template <class T, class Alloc, class GrowthPolicy>
+typename base_vector<T, Alloc, GrowthPolicy>::const_iterator
+base_vector<T, Alloc, GrowthPolicy>::cend() const {
+  return cbegin() + size();
 }
 
-template <class T, class Alloc>
-typename base_vector<T, Alloc>::pointer base_vector<T, Alloc>::data() {
+template <class T, class Alloc, class GrowthPolicy>
+typename base_vector<T, Alloc, GrowthPolicy>::pointer
+base_vector<T, Alloc, GrowthPolicy>::data() {
   return storage_.data();
 }
 
-template <class T, class Alloc>
-typename base_vector<T, Alloc>::const_pointer
-base_vector<T, Alloc>::data() const {
+template <class T, class Alloc, class GrowthPolicy>
+typename base_vector<T, Alloc, GrowthPolicy>::const_pointer
+base_vector<T, Alloc, GrowthPolicy>::data() const {
   return storage_.data();
 }
 
-template <class T, class Alloc> bool base_vector<T, Alloc>::empty() const {
+template <class T, class Alloc, class GrowthPolicy>
+typename base_vector<T, Alloc, GrowthPolicy>::pointer
+base_vector<T, Alloc, GrowthPolicy>::aligned_data() {
+  return assume_aligned<alignment>(data());
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+typename base_vector<T, Alloc, GrowthPolicy>::const_pointer
+base_vector<T, Alloc, GrowthPolicy>::aligned_data() const {
+  return assume_aligned<alignment>(data());
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+bool base_vector<T, Alloc, GrowthPolicy>::empty() const {
   return size() == 0;
 }
 
-template <class T, class Alloc>
-void base_vector<T, Alloc>::swap(base_vector &v) {
+template <class T, class Alloc, class GrowthPolicy>
+void base_vector<T, Alloc, GrowthPolicy>::clear() {
+  storage_.destroy(begin(), end());
+  size_ = 0;
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+void base_vector<T, Alloc, GrowthPolicy>::swap(base_vector &v) {
   using std::swap;
-  swap(storage_, v.storage_);
-  swap(size_, v.size_);
+
+  if (storage_.owns_buffer() && v.storage_.owns_buffer()) {
+    storage_.swap(v.storage_);
+    swap(size_, v.size_);
+  } else {
+    base_vector tmp(std::move(v));
+    v = std::move(*this);
+    *this = std::move(tmp);
+  }
 }
 
-template <class T, class Alloc>
-void base_vector<T, Alloc>::assign(size_type n, const value_type &value) {
+template <class T, class Alloc, class GrowthPolicy>
+void base_vector<T, Alloc, GrowthPolicy>::assign(size_type n,
+                                                 const value_type &value) {
   fill_assign(n, value);
 }
 
-template <class T, class Alloc>
+template <class T, class Alloc, class GrowthPolicy>
 template <class InputIter>
-void base_vector<T, Alloc>::assign(InputIter first, InputIter last) {
+void base_vector<T, Alloc, GrowthPolicy>::assign(InputIter first,
+                                                 InputIter last) {
   // check the type of InputIterator: if it's an integral type,
   // we need to interpret this call as (size_type, value_type)
-  constexpr bool IsInteger = std::is_integral_v<InputIter>;
+  using IsInteger = std::is_integral<InputIter>;
 
-  assign_dispatch(first, last, IsInteger);
+  assign_dispatch(first, last, IsInteger());
 }
 
-template <class T, class Alloc>
-typename base_vector<T, Alloc>::allocator_type
-base_vector<T, Alloc>::get_allocator() const {
+template <class T, class Alloc, class GrowthPolicy>
+typename base_vector<T, Alloc, GrowthPolicy>::allocator_type
+base_vector<T, Alloc, GrowthPolicy>::get_allocator() const {
   return storage_.get_allocator();
 }
 
-template <class T, class Alloc>
-typename base_vector<T, Alloc>::iterator
-base_vector<T, Alloc>::erase(iterator pos) {
+template <class T, class Alloc, class GrowthPolicy>
+typename base_vector<T, Alloc, GrowthPolicy>::iterator
+base_vector<T, Alloc, GrowthPolicy>::erase(iterator pos) {
   auto end = pos;
   ++end;
   return erase(pos, end);
 }
 
-template <class T, class Alloc>
-typename base_vector<T, Alloc>::iterator
-base_vector<T, Alloc>::erase(iterator first, iterator last) {
-  iterator i = overlapped_copy(last, end(), first);
-  storage_.destroy(i, end());
+template <class T, class Alloc, class GrowthPolicy>
+typename base_vector<T, Alloc, GrowthPolicy>::iterator
+base_vector<T, Alloc, GrowthPolicy>::erase(iterator first, iterator last) {
+  erase_dispatch(first, last, is_trivially_relocatable<T>());
   size_ -= (last - first);
   return first;
 }
 
-template <class T, class Alloc>
+template <class T, class Alloc, class GrowthPolicy>
+template <class MaskRange, typename>
+typename base_vector<T, Alloc, GrowthPolicy>::size_type
+base_vector<T, Alloc, GrowthPolicy>::erase(const MaskRange &mask) {
+  auto erased = std::begin(mask);
+  iterator kept_end = compact(begin(), end(), [&erased](size_type) {
+    return !static_cast<bool>(*erased++);
+  });
+
+  const auto n = static_cast<size_type>(end() - kept_end);
+  erase(kept_end, end());
+  return n;
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+typename base_vector<T, Alloc, GrowthPolicy>::iterator
+base_vector<T, Alloc, GrowthPolicy>::insert(iterator pos,
+                                            const value_type &value) {
+  return emplace(pos, value);
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+typename base_vector<T, Alloc, GrowthPolicy>::iterator
+base_vector<T, Alloc, GrowthPolicy>::insert(iterator pos, value_type &&value) {
+  return emplace(pos, std::move(value));
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+typename base_vector<T, Alloc, GrowthPolicy>::iterator
+base_vector<T, Alloc, GrowthPolicy>::insert(iterator pos, size_type n,
+                                            const value_type &value) {
+  const auto index = static_cast<size_type>(pos - begin());
+
+  if (is_trivially_relocatable<T>::value) {
+    // value may be an element of the tail, which might be shifted in place
+    // before the copies are constructed (see insert_in_place)
+    const value_type copy(value);
+    return insert_n(index, n, [this, &copy](iterator p, size_type count) {
+      storage_.uninitialized_fill_n(p, count, copy);
+    });
+  }
+
+  return insert_n(index, n, [this, &value](iterator p, size_type count) {
+    storage_.uninitialized_fill_n(p, count, value);
+  });
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+template <class InputIter>
+typename base_vector<T, Alloc, GrowthPolicy>::iterator
+base_vector<T, Alloc, GrowthPolicy>::insert(iterator pos, InputIter first,
+                                            InputIter last) {
+  return insert_dispatch(pos, first, last, std::is_integral<InputIter>());
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+template <class... Args>
+typename base_vector<T, Alloc, GrowthPolicy>::iterator
+base_vector<T, Alloc, GrowthPolicy>::emplace(iterator pos, Args &&...args) {
+  const auto index = static_cast<size_type>(pos - begin());
+
+  if (is_trivially_relocatable<T>::value) {
+    // args may refer to an element of the tail, which might be shifted in
+    // place before the new element is constructed (see insert_in_place)
+    value_type value(std::forward<Args>(args)...);
+    return insert_n(index, 1, [this, &value](iterator p, size_type) {
+      storage_.construct(p, std::move(value));
+    });
+  }
+
+  return insert_n(index, 1, [this, &args...](iterator p, size_type) {
+    storage_.construct(p, std::forward<Args>(args)...);
+  });
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+template <typename Constructor>
+typename base_vector<T, Alloc, GrowthPolicy>::iterator
+base_vector<T, Alloc, GrowthPolicy>::insert_n(size_type index, size_type n,
+                                              Constructor construct) {
+  if (n == 0) {
+    return begin() + index;
+  }
+
+  if (n <= capacity() - size()) {
+    insert_in_place(index, n, construct, is_trivially_relocatable<T>());
+    return begin() + index;
+  }
+
+  if (n > max_size() - size()) {
+    throw std::length_error("base_vector: required capacity exceeds "
+                            "max_size()");
+  }
+
+  const size_type new_capacity = next_capacity(size() + n);
+
+  if (storage_.try_expand(new_capacity)) {
+    insert_in_place(index, n, construct, is_trivially_relocatable<T>());
+    return begin() + index;
+  }
+
+  // Construct the new elements first, while elements of this vector, which
+  // the arguments may refer to, are still in place. Then relocate the front
+  // and the tail around them
+  storage_type new_storage(detail::copy_allocator_t{}, storage_, new_capacity);
+
+  iterator inserted = new_storage.begin() + index;
+  construct(inserted, n);
+
+  try {
+    storage_.relocate(begin(), begin() + index, new_storage.begin());
+  } catch (...) {
+    new_storage.destroy(inserted, inserted + n);
+    throw;
+  }
+
+  try {
+    storage_.relocate(begin() + index, end(), inserted + n);
+  } catch (...) {
+    // The front is relocated already, so the old state is lost
+    new_storage.destroy(new_storage.begin(), inserted + n);
+    storage_.destroy(begin() + index, end());
+    size_ = 0;
+    throw;
+  }
+
+  storage_.swap(new_storage);
+  size_ += n;
+  return inserted;
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+template <typename Constructor>
+void base_vector<T, Alloc, GrowthPolicy>::insert_in_place(
+    size_type index, size_type n, Constructor construct, std::true_type) {
+  iterator pos = begin() + index;
+
+  // relocate memmoves, so the ranges may overlap
+  storage_.relocate(pos, end(), pos + n);
+
+  try {
+    construct(pos, n);
+  } catch (...) {
+    storage_.relocate(pos + n, end() + n, pos);
+    throw;
+  }
+
+  size_ += n;
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+template <typename Constructor>
+void base_vector<T, Alloc, GrowthPolicy>::insert_in_place(
+    size_type index, size_type n, Constructor construct, std::false_type) {
+  construct(end(), n);
+  size_ += n;
+
+  const pointer p = data();
+  std::rotate(p + index, p + (size_ - n), p + size_);
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+template <typename Integral>
+typename base_vector<T, Alloc, GrowthPolicy>::iterator
+base_vector<T, Alloc, GrowthPolicy>::insert_dispatch(iterator pos, Integral n,
+                                                     Integral value,
+                                                     std::true_type) {
+  return insert(pos, static_cast<size_type>(n),
+                static_cast<value_type>(value));
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+template <typename InputIterator>
+typename base_vector<T, Alloc, GrowthPolicy>::iterator
+base_vector<T, Alloc, GrowthPolicy>::insert_dispatch(iterator pos,
+                                                     InputIterator first,
+                                                     InputIterator last,
+                                                     std::false_type) {
+  return range_insert(
+      static_cast<size_type>(pos - begin()), first, last,
+      typename std::iterator_traits<InputIterator>::iterator_category());
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+template <typename InputIterator>
+typename base_vector<T, Alloc, GrowthPolicy>::iterator
+base_vector<T, Alloc, GrowthPolicy>::range_insert(size_type index,
+                                                  InputIterator first,
+                                                  InputIterator last,
+                                                  std::input_iterator_tag) {
+  // The length is unknown, so buffer the elements at the end, which grows
+  // geometrically, and rotate them into place once
+  const size_type old_size = size();
+
+  try {
+    for (; first != last; ++first) {
+      emplace_back(*first);
+    }
+  } catch (...) {
+    erase(begin() + old_size, end());
+    throw;
+  }
+
+  const pointer p = data();
+  std::rotate(p + index, p + old_size, p + size_);
+  return begin() + index;
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+template <typename ForwardIterator>
+typename base_vector<T, Alloc, GrowthPolicy>::iterator
+base_vector<T, Alloc, GrowthPolicy>::range_insert(size_type index,
+                                                  ForwardIterator first,
+                                                  ForwardIterator last,
+                                                  std::forward_iterator_tag) {
+  const auto n = static_cast<size_type>(std::distance(first, last));
+
+  return insert_n(index, n, [this, first, last](iterator p, size_type) {
+    storage_.uninitialized_copy(first, last, p);
+  });
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+void base_vector<T, Alloc, GrowthPolicy>::erase_dispatch(iterator first,
+                                                         iterator last,
+                                                         std::true_type) {
+  // Destroy the erased elements, and memmove the tail over them
+  storage_.destroy(first, last);
+  storage_.relocate(last, end(), first);
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+void base_vector<T, Alloc, GrowthPolicy>::erase_dispatch(iterator first,
+                                                         iterator last,
+                                                         std::false_type) {
+  // Assign the tail over the erased elements, and destroy the now unused
+  // end of the vector
+  iterator i = overlapped_copy(last, end(), first);
+  storage_.destroy(i, end());
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+void base_vector<T, Alloc, GrowthPolicy>::default_init(size_type n) {
+  storage_.allocate(n);
+  storage_.value_construct_n(begin(), n);
+  size_ = n;
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+void base_vector<T, Alloc, GrowthPolicy>::default_init(default_init_t,
+                                                       size_type n) {
+  storage_.allocate(n);
+  storage_.default_construct_n(begin(), n);
+  size_ = n;
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+void base_vector<T, Alloc, GrowthPolicy>::fill_init(size_type n,
+                                                    const value_type &value) {
+  storage_.allocate(n);
+  storage_.uninitialized_fill_n(begin(), n, value);
+  size_ = n;
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+void base_vector<T, Alloc, GrowthPolicy>::default_init(
+    const parallel_policy &policy, size_type n) {
+  storage_.allocate(n);
+  storage_.value_construct_n(policy, begin(), n);
+  size_ = n;
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+void base_vector<T, Alloc, GrowthPolicy>::fill_init(
+    const parallel_policy &policy, size_type n, const value_type &value) {
+  storage_.allocate(n);
+  storage_.uninitialized_fill_n(policy, begin(), n, value);
+  size_ = n;
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+template <typename InputIterator>
+void base_vector<T, Alloc, GrowthPolicy>::range_init(
+    const parallel_policy &, InputIterator first, InputIterator last,
+    std::input_iterator_tag) {
+  // Single pass ranges can't be split
+  range_init(first, last, std::input_iterator_tag());
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+template <typename ForwardIterator>
+void base_vector<T, Alloc, GrowthPolicy>::range_init(
+    const parallel_policy &policy, ForwardIterator first, ForwardIterator last,
+    std::forward_iterator_tag) {
+  const auto n = static_cast<size_type>(std::distance(first, last));
+
+  storage_.allocate(n);
+  storage_.uninitialized_copy(policy, first, last, begin());
+  size_ = n;
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+template <typename InputIterator>
+void base_vector<T, Alloc, GrowthPolicy>::range_init(InputIterator first,
+                                                     InputIterator last) {
+  range_init(first, last,
+             typename std::iterator_traits<InputIterator>::iterator_category());
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+template <typename InputIterator>
+void base_vector<T, Alloc, GrowthPolicy>::range_init(InputIterator first,
+                                                     InputIterator last,
+                                                     std::input_iterator_tag) {
+  for (; first != last; ++first) {
+    emplace_back(*first);
+  }
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+template <typename ForwardIterator>
+void base_vector<T, Alloc, GrowthPolicy>::range_init(
+    ForwardIterator first, ForwardIterator last, std::forward_iterator_tag) {
+  const auto n = static_cast<size_type>(std::distance(first, last));
+
+  storage_.allocate(n);
+  storage_.uninitialized_copy(first, last, begin());
+  size_ = n;
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+typename base_vector<T, Alloc, GrowthPolicy>::size_type
+base_vector<T, Alloc, GrowthPolicy>::next_capacity(size_type required) const {
+  if (required > max_size()) {
+    throw std::length_error("base_vector: required capacity exceeds "
+                            "max_size()");
+  }
+
+  const size_type new_capacity =
+      static_cast<size_type>(GrowthPolicy::next_capacity(capacity(), required));
+
+  return std::min(std::max(new_capacity, required), max_size());
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+template <typename TailConstructor>
+void base_vector<T, Alloc, GrowthPolicy>::reallocate_append(
+    size_type new_capacity, size_type n, TailConstructor construct_tail,
+    bool may_move_buffer) {
+  if (storage_.try_expand(new_capacity) ||
+      (may_move_buffer && storage_.try_reallocate(new_capacity))) {
+    // The elements are still (or were moved by the allocator) in place
+    construct_tail(end(), n);
+    size_ += n;
+    return;
+  }
+
+  storage_type new_storage(detail::copy_allocator_t{}, storage_, new_capacity);
+
+  iterator tail = new_storage.begin() + size();
+  construct_tail(tail, n);
+
+  try {
+    storage_.relocate(begin(), end(), new_storage.begin());
+  } catch (...) {
+    new_storage.destroy(tail, tail + n);
+    throw;
+  }
+
+  storage_.swap(new_storage);
+  size_ += n;
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+template <typename TailConstructor>
+void base_vector<T, Alloc, GrowthPolicy>::append(
+    size_type n, TailConstructor construct_tail, bool may_move_buffer) {
+  if (n == 0) {
+    return;
+  }
+
+  if (n <= capacity() - size()) {
+    construct_tail(end(), n);
+    size_ += n;
+  } else {
+    if (n > max_size() - size()) {
+      throw std::length_error("base_vector: required capacity exceeds "
+                              "max_size()");
+    }
+
+    reallocate_append(next_capacity(size() + n), n, construct_tail,
+                      may_move_buffer);
+  }
+}
+
+template <class T, class Alloc, class GrowthPolicy>
 template <typename IteratorOrIntegralType>
-void base_vector<T, Alloc>::init_dispatch(IteratorOrIntegralType n,
-                                          IteratorOrIntegralType value,
-                                          std::true_type) {
+void base_vector<T, Alloc, GrowthPolicy>::init_dispatch(
+    IteratorOrIntegralType n, IteratorOrIntegralType value, std::true_type) {
   fill_init(n, value);
 }
 
-template <class T, class Alloc>
+template <class T, class Alloc, class GrowthPolicy>
 template <typename IteratorOrIntegralType>
-void base_vector<T, Alloc>::init_dispatch(IteratorOrIntegralType begin,
-                                          IteratorOrIntegralType end,
-                                          std::false_type) {
+void base_vector<T, Alloc, GrowthPolicy>::init_dispatch(
+    IteratorOrIntegralType begin, IteratorOrIntegralType end,
+    std::false_type) {
   range_init(begin, end);
 }
 
-template <class T, class Alloc>
-void base_vector<T, Alloc>::fill_assign(size_type n, const T &x) {
+template <class T, class Alloc, class GrowthPolicy>
+void base_vector<T, Alloc, GrowthPolicy>::fill_assign(size_type n,
+                                                      const T &x) {
   if (n > capacity()) {
     // If the wanted size is larger than our current capacity: allocate a new
-    // vector
-    auto tmp = base_vector<T, Alloc>(n, x, get_allocator());
-    tmp.swap(*this);
+    // buffer, x might refer to an element, so fill it before destroying them
+    storage_type new_storage(detail::copy_allocator_t{}, storage_, n);
+    new_storage.uninitialized_fill_n(new_storage.begin(), n, x);
+
+    storage_.destroy(begin(), end());
+    storage_.swap(new_storage);
+    size_ = n;
   } else if (n > size()) {
     // We have enough allocated space
-    std::fill(begin(), end(), x);
+    std::fill(detail::unwrap_iterator(begin()), detail::unwrap_iterator(end()),
+              x);
     storage_.uninitialized_fill_n(end(), n - size(), x);
     size_ += n - size();
   } else {
     // size() > n, so fill till n, and delete the rest
-    iterator new_end = std::fill_n(begin(), n, x);
-    erase(new_end, end());
+    std::fill_n(detail::unwrap_iterator(begin()), n, x);
+    erase(begin() + n, end());
   }
 }
 
-template <class T, class Alloc>
+template <class T, class Alloc, class GrowthPolicy>
 template <typename InputIterator>
-void base_vector<T, Alloc>::assign_dispatch(InputIterator first,
-                                            InputIterator last,
-                                            std::false_type) {
-  range_assign(first, last);
+void base_vector<T, Alloc, GrowthPolicy>::assign_dispatch(InputIterator first,
+                                                          InputIterator last,
+                                                          std::false_type) {
+  range_assign(
+      first, last,
+      typename std::iterator_traits<InputIterator>::iterator_category());
 }
 
-template <class T, class Alloc>
+template <class T, class Alloc, class GrowthPolicy>
 template <typename Integral>
-void base_vector<T, Alloc>::assign_dispatch(Integral n, Integral x,
-                                            std::true_type) {
+void base_vector<T, Alloc, GrowthPolicy>::assign_dispatch(Integral n,
+                                                          Integral x,
+                                                          std::true_type) {
   fill_assign(n, x);
 }
 
+template <class T, class Alloc, class GrowthPolicy>
+template <typename InputIterator>
+void base_vector<T, Alloc, GrowthPolicy>::range_assign(
+    InputIterator first, InputIterator last, std::input_iterator_tag) {
+  iterator current = begin();
+
+  // Overwrite existing elements first
+  for (; first != last && current != end(); ++current, ++first) {
+    *current = *first;
+  }
+
+  if (first == last) {
+    erase(current, end());
+  } else {
+    for (; first != last; ++first) {
+      emplace_back(*first);
+    }
+  }
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+template <typename ForwardIterator>
+void base_vector<T, Alloc, GrowthPolicy>::range_assign(
+    ForwardIterator first, ForwardIterator last, std::forward_iterator_tag) {
+  const auto n = static_cast<size_type>(std::distance(first, last));
+
+  if (n > capacity()) {
+    // Not enough space, copy the range to a new buffer
+    storage_type new_storage(detail::copy_allocator_t{}, storage_, n);
+    new_storage.uninitialized_copy(first, last, new_storage.begin());
+
+    storage_.destroy(begin(), end());
+    storage_.swap(new_storage);
+  } else if (n > size()) {
+    // Overwrite existing elements, and construct the rest in place
+    ForwardIterator mid = first;
+    std::advance(mid, size());
+
+    std::copy(detail::unwrap_iterator(first), detail::unwrap_iterator(mid),
+              detail::unwrap_iterator(begin()));
+    storage_.uninitialized_copy(mid, last, end());
+  } else {
+    // Overwrite the first n elements, destroy the rest
+    std::copy(detail::unwrap_iterator(first), detail::unwrap_iterator(last),
+              detail::unwrap_iterator(begin()));
+    storage_.destroy(begin() + n, end());
+  }
+
+  size_ = n;
+}
+
+/// Erase all elements of v, for which pred is true, in a single pass (see
+/// compact). Returns the number of erased elements
+template <class T, class Alloc, class GrowthPolicy, class Predicate>
+typename base_vector<T, Alloc, GrowthPolicy>::size_type
+erase_if(base_vector<T, Alloc, GrowthPolicy> &v, Predicate pred) {
+  const T *data = v.data();
+  auto kept_end = compact(v.begin(), v.end(), [data, &pred](std::size_t i) {
+    return !pred(data[i]);
+  });
+
+  const auto n = static_cast<std::size_t>(v.end() - kept_end);
+  v.erase(kept_end, v.end());
+  return n;
+}
+
+/// Erase the elements of v at the sorted indices in a single pass, moving the
+/// elements between them in blocks (see remove_indices). Returns the number
+/// of erased elements
+template <class T, class Alloc, class GrowthPolicy, class IndexRange>
+typename base_vector<T, Alloc, GrowthPolicy>::size_type
+remove_indices(base_vector<T, Alloc, GrowthPolicy> &v,
+               const IndexRange &sorted_indices) {
+  auto kept_end = remove_indices(v.begin(), v.end(), std::begin(sorted_indices),
+                                 std::end(sorted_indices));
+
+  const auto n = static_cast<std::size_t>(v.end() - kept_end);
+  v.erase(kept_end, v.end());
+  return n;
+}
+
 } // namespace mem
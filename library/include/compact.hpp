@@ -0,0 +1,124 @@
+#pragma once
+
+#include "overlapped_copy.hpp"
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+namespace mem {
+namespace detail {
+
+/// true, if compacting can be done branch free, i.e. Iterator is a pointer to
+/// an arithmetic type, which is cheap to copy unconditionally
+template <class Iterator>
+struct is_branch_free_compactable
+    : std::integral_constant<
+          bool, std::is_pointer_v<Iterator> &&
+                    std::is_arithmetic_v<std::remove_pointer_t<Iterator>> &&
+                    !std::is_const_v<std::remove_pointer_t<Iterator>> &&
+                    !std::is_volatile_v<std::remove_pointer_t<Iterator>>> {};
+
+template <typename ForwardIterator, typename Keep>
+ForwardIterator compact_dispatch(ForwardIterator first, ForwardIterator last,
+                                 Keep keep, std::true_type) {
+  // Every element is copied and the output position advanced by the result
+  // of keep, so the loop has no data dependent branch to mispredict. It
+  // doesn't vectorize, as each store depends on the previous position
+  ForwardIterator result = first;
+  for (std::size_t i = 0; first != last; ++first, ++i) {
+    const bool kept = keep(i);
+    *result = *first;
+    result += kept;
+  }
+  return result;
+}
+
+template <typename ForwardIterator, typename Keep>
+ForwardIterator compact_dispatch(ForwardIterator first, ForwardIterator last,
+                                 Keep keep, std::false_type) {
+  ForwardIterator result = first;
+  for (std::size_t i = 0; first != last; ++first, ++i) {
+    if (keep(i)) {
+      if (result != first) {
+        *result = std::move(*first);
+      }
+      ++result;
+    }
+  }
+  return result;
+}
+
+} // namespace detail
+
+/**
+ * @brief Move the elements of [first, last) for which keep(i) is true, with i
+ * the index of the element, to the front of the range in a single pass,
+ * preserving their order. Returns the end of the kept elements, the elements
+ * after it are left in a valid but unspecified state (like std::remove_if).
+ *
+ * keep is called exactly once per element, in order, so it may be stateful
+ * (e.g. walking a mask alongside). It may read element i, but no element
+ * after it. Ranges of arithmetic types are compacted without branches.
+ *
+ * @param first start of the range
+ * @param last end of the range
+ * @param keep called with the index of each element, true to keep it
+ */
+template <typename ForwardIterator, typename Keep>
+ForwardIterator compact(ForwardIterator first, ForwardIterator last,
+                        Keep keep) {
+  auto first_base = detail::unwrap_iterator(first);
+  auto last_base = detail::unwrap_iterator(last);
+
+  auto result_base = detail::compact_dispatch(
+      first_base, last_base, keep,
+      detail::is_branch_free_compactable<decltype(first_base)>());
+
+  return detail::rewrap_iterator(first, result_base);
+}
+
+/**
+ * @brief Remove the elements at the sorted indices [index_first, index_last)
+ * from [first, last), moving the kept elements to the front in blocks.
+ * Duplicate indices are ignored, all indices must be smaller than
+ * last - first. Returns the end of the kept elements.
+ *
+ * @param first start of the range
+ * @param last end of the range
+ * @param index_first start of the sorted indices to remove
+ * @param index_last end of the sorted indices to remove
+ */
+template <typename RandomAccessIterator, typename IndexIterator>
+RandomAccessIterator remove_indices(RandomAccessIterator first,
+                                    RandomAccessIterator last,
+                                    IndexIterator index_first,
+                                    IndexIterator index_last) {
+  if (index_first == index_last) {
+    return last;
+  }
+
+  auto first_base = detail::unwrap_iterator(first);
+  auto last_base = detail::unwrap_iterator(last);
+
+  // Move each block between two removed indices to the front as a whole, for
+  // pointers to trivially copyable types, std::move is a memmove
+  auto result = first_base + *index_first;
+  while (index_first != index_last) {
+    const auto block_first = first_base + *index_first + 1;
+
+    do {
+      ++index_first;
+    } while (index_first != index_last &&
+             first_base + *index_first < block_first);
+
+    const auto block_last =
+        index_first == index_last ? last_base : first_base + *index_first;
+
+    result = std::move(block_first, block_last, result);
+  }
+
+  return first + (result - first_base);
+}
+
+} // namespace mem
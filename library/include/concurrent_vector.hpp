@@ -0,0 +1,605 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "contiguous_storage.hpp"
+#include "segment_iterator.hpp"
+
+namespace mem {
+namespace detail {
+
+/// Index of the highest set bit of x, x must not be 0
+inline std::size_t floor_log2(std::size_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+  return sizeof(unsigned long long) * 8 - 1 -
+         static_cast<std::size_t>(
+             __builtin_clzll(static_cast<unsigned long long>(x)));
+#else
+  std::size_t result = 0;
+  while (x >>= 1) {
+    ++result;
+  }
+  return result;
+#endif
+}
+
+} // namespace detail
+
+/**
+ * @brief Vector, which many threads can append to concurrently without
+ * locking, while others read the elements appended so far.
+ *
+ * The elements are stored in segments, segment k holds first_segment_size *
+ * 2^k elements. Existing elements never move, so references stay valid while
+ * the vector grows.
+ *
+ * push_back and grow_by reserve their slots with a single atomic fetch-add.
+ * The first thread needing a segment allocates it and publishes it with a
+ * compare-and-swap, after which nothing can throw. After constructing its
+ * elements, a thread advances size() over them, if all earlier slots are
+ * published. Otherwise it marks their slots ready (one byte per slot), and
+ * the thread publishing the earlier ones advances size() over them too. So
+ * size() is always a prefix of constructed elements, which readers can access
+ * concurrently, and no thread ever waits for another one.
+ *
+ * If constructing an element throws, its slot is filled with a value
+ * initialized element, so the prefix stays intact, and the exception is
+ * rethrown. Hence T has to be nothrow default constructible. If a segment
+ * can't be allocated, the vector stops growing: this and all later appends
+ * throw, elements after the missing slots are never published, the published
+ * ones stay accessible until clear.
+ *
+ * clear, reserve and destruction must not run concurrently with other calls.
+ *
+ * @tparam T type of the stored elements
+ * @tparam Alloc allocator of the segments, it's rebound for the ready flags
+ */
+template <class T, class Alloc = std::allocator<T>> class concurrent_vector {
+  static_assert(std::is_nothrow_default_constructible_v<T>,
+                "slots of failed constructions are value initialized");
+
+private:
+  using storage_type = detail::contiguous_storage<T, Alloc>;
+
+  using alloc_traits = std::allocator_traits<Alloc>;
+
+  /// Set, once the element of a slot is constructed
+  using ready_flag = std::atomic<unsigned char>;
+
+  using flag_allocator =
+      typename alloc_traits::template rebind_alloc<ready_flag>;
+
+  using flag_traits = std::allocator_traits<flag_allocator>;
+
+public:
+  using value_type = T;
+
+  using reference = T &;
+  using const_reference = const T &;
+
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+
+  using allocator_type = Alloc;
+
+  using iterator = iter::segment_iterator<concurrent_vector, T>;
+  using const_iterator =
+      iter::segment_iterator<const concurrent_vector, const T>;
+
+  /// Number of elements in the first segment
+  static constexpr size_type first_segment_size = 32;
+
+  /// Maximum number of segments, enough to exhaust the address space
+  static constexpr size_type max_segments = 8 * sizeof(size_type) - 5;
+
+private:
+  /// Buffers of the segments, nullptr until allocated. Segment k is owned by
+  /// the vector once published here, and deallocated with allocator_
+  std::atomic<T *> segment_data_[max_segments];
+
+  /// Ready flags of the slots of the segments, nullptr until allocated
+  std::atomic<ready_flag *> segment_ready_[max_segments];
+
+  /// Number of reserved slots
+  std::atomic<size_type> reserved_;
+
+  /// Number of published elements, all constructed
+  std::atomic<size_type> size_;
+
+  /// Set, if a segment couldn't be allocated, then the slots in it can't be
+  /// published, and neither can the ones after them
+  std::atomic<bool> broken_;
+
+  allocator_type allocator_;
+
+  /// Empty storage, only used to construct and destroy elements with the
+  /// allocator
+  storage_type constructor_;
+
+public:
+  explicit concurrent_vector(const Alloc &alloc = Alloc());
+
+  concurrent_vector(const concurrent_vector &) = delete;
+
+  concurrent_vector &operator=(const concurrent_vector &) = delete;
+
+  ~concurrent_vector();
+
+  /// Append a copy of value, returns a reference to the new element
+  reference push_back(const value_type &value);
+
+  /// Append value by moving it, returns a reference to the new element
+  reference push_back(value_type &&value);
+
+  /// Append an element constructed in place from args, returns a reference
+  /// to it
+  template <class... Args> reference emplace_back(Args &&...args);
+
+  /// Append n value initialized elements, returns the index of the first
+  size_type grow_by(size_type n);
+
+  /// Append n copies of value, returns the index of the first
+  size_type grow_by(size_type n, const value_type &value);
+
+  /// Number of published elements, which can be accessed
+  size_type size() const;
+
+  bool empty() const;
+
+  /// Number of elements, which fit into the allocated segments
+  size_type capacity() const;
+
+  size_type max_size() const;
+
+  /// Allocate segments for at least n elements. Not thread safe
+  void reserve(size_type n);
+
+  /// Destroy all elements, the segments are kept. Not thread safe
+  void clear();
+
+  /// Element idx, idx has to be smaller than size()
+  reference operator[](size_type idx);
+
+  /// Element idx, idx has to be smaller than size()
+  const_reference operator[](size_type idx) const;
+
+  /// Iterators over the elements published at the time end() is called
+  iterator begin();
+
+  const_iterator begin() const;
+
+  const_iterator cbegin() const;
+
+  iterator end();
+
+  const_iterator end() const;
+
+  const_iterator cend() const;
+
+  allocator_type get_allocator() const;
+
+  /// Segment holding element idx
+  static size_type segment_of(size_type idx);
+
+  /// Index of the first element of segment k
+  static size_type segment_begin(size_type k);
+
+  /// Number of elements of segment k
+  static size_type segment_size(size_type k);
+
+private:
+  /// Allocate segment k and its ready flags, if no other thread did yet.
+  /// Returns its buffer
+  T *ensure_segment(size_type k);
+
+  /// Reserve n slots, allocate their segments, construct the elements with
+  /// construct(first, n) for each contiguous piece, and publish them. Returns
+  /// the index of the first slot
+  template <typename Constructor>
+  size_type append(size_type n, Constructor construct);
+
+  /// Publish the constructed slots [first, last): advance size_ over them,
+  /// if the earlier slots are published, otherwise mark them ready
+  void publish(size_type first, size_type last);
+
+  /// Advance size_ from published over the ready slots following it
+  void advance(size_type published);
+
+  /// true, if the element of slot idx is constructed
+  bool is_ready(size_type idx) const;
+
+  /// Iterator to the element of slot idx
+  typename storage_type::iterator slot(size_type idx);
+};
+
+template <class T, class Alloc>
+concurrent_vector<T, Alloc>::concurrent_vector(const Alloc &alloc)
+    : reserved_(0), size_(0), broken_(false), allocator_(alloc),
+      constructor_(allocator_) {
+  for (auto &data : segment_data_) {
+    data.store(nullptr, std::memory_order_relaxed);
+  }
+  for (auto &ready : segment_ready_) {
+    ready.store(nullptr, std::memory_order_relaxed);
+  }
+}
+
+template <class T, class Alloc>
+concurrent_vector<T, Alloc>::~concurrent_vector() {
+  clear();
+
+  flag_allocator flags(allocator_);
+  for (size_type k = 0; k < max_segments; ++k) {
+    if (T *data = segment_data_[k].load(std::memory_order_relaxed)) {
+      alloc_traits::deallocate(allocator_, data, segment_size(k));
+    }
+    if (ready_flag *ready = segment_ready_[k].load(std::memory_order_relaxed)) {
+      flag_traits::deallocate(flags, ready, segment_size(k));
+    }
+  }
+}
+
+template <class T, class Alloc>
+typename concurrent_vector<T, Alloc>::reference
+concurrent_vector<T, Alloc>::push_back(const value_type &value) {
+  return emplace_back(value);
+}
+
+template <class T, class Alloc>
+typename concurrent_vector<T, Alloc>::reference
+concurrent_vector<T, Alloc>::push_back(value_type &&value) {
+  return emplace_back(std::move(value));
+}
+
+template <class T, class Alloc>
+template <class... Args>
+typename concurrent_vector<T, Alloc>::reference
+concurrent_vector<T, Alloc>::emplace_back(Args &&...args) {
+  const size_type idx = append(
+      1, [this, &args...](typename storage_type::iterator pos, size_type) {
+        constructor_.construct(pos, std::forward<Args>(args)...);
+      });
+  return (*this)[idx];
+}
+
+template <class T, class Alloc>
+typename concurrent_vector<T, Alloc>::size_type
+concurrent_vector<T, Alloc>::grow_by(size_type n) {
+  return append(n, [this](typename storage_type::iterator pos, size_type m) {
+    constructor_.value_construct_n(pos, m);
+  });
+}
+
+template <class T, class Alloc>
+typename concurrent_vector<T, Alloc>::size_type
+concurrent_vector<T, Alloc>::grow_by(size_type n, const value_type &value) {
+  return append(n, [this, &value](typename storage_type::iterator pos,
+                                  size_type m) {
+    constructor_.uninitialized_fill_n(pos, m, value);
+  });
+}
+
+template <class T, class Alloc>
+typename concurrent_vector<T, Alloc>::size_type
+concurrent_vector<T, Alloc>::size() const {
+  return size_.load(std::memory_order_acquire);
+}
+
+template <class T, class Alloc>
+bool concurrent_vector<T, Alloc>::empty() const {
+  return size() == 0;
+}
+
+template <class T, class Alloc>
+typename concurrent_vector<T, Alloc>::size_type
+concurrent_vector<T, Alloc>::capacity() const {
+  size_type k = 0;
+  while (k < max_segments &&
+         segment_data_[k].load(std::memory_order_acquire) != nullptr) {
+    ++k;
+  }
+  return segment_begin(k);
+}
+
+template <class T, class Alloc>
+typename concurrent_vector<T, Alloc>::size_type
+concurrent_vector<T, Alloc>::max_size() const {
+  return std::min(segment_begin(max_segments) - 1,
+                  std::allocator_traits<Alloc>::max_size(allocator_));
+}
+
+template <class T, class Alloc>
+void concurrent_vector<T, Alloc>::reserve(size_type n) {
+  if (n > max_size()) {
+    throw std::length_error("concurrent_vector::reserve: requested capacity "
+                            "exceeds max_size()");
+  }
+  if (n > 0) {
+    for (size_type k = 0; k <= segment_of(n - 1); ++k) {
+      ensure_segment(k);
+    }
+  }
+}
+
+template <class T, class Alloc> void concurrent_vector<T, Alloc>::clear() {
+  // Elements may be constructed after the published ones, if the vector broke
+  const size_type published = size();
+  const size_type n = std::min(reserved_.load(std::memory_order_relaxed),
+                               segment_begin(max_segments));
+
+  for (size_type k = 0; k < max_segments && segment_begin(k) < n; ++k) {
+    ready_flag *ready = segment_ready_[k].load(std::memory_order_relaxed);
+    T *data = segment_data_[k].load(std::memory_order_relaxed);
+    const size_type count =
+        std::min(n, segment_begin(k + 1)) - segment_begin(k);
+
+    for (size_type i = 0; ready != nullptr && i < count; ++i) {
+      if (segment_begin(k) + i < published ||
+          ready[i].load(std::memory_order_relaxed) != 0) {
+        constructor_.destroy(typename storage_type::iterator(data + i),
+                             typename storage_type::iterator(data + i + 1));
+      }
+      ready[i].store(0, std::memory_order_relaxed);
+    }
+  }
+
+  reserved_.store(0, std::memory_order_relaxed);
+  broken_.store(false, std::memory_order_relaxed);
+  size_.store(0, std::memory_order_release);
+}
+
+template <class T, class Alloc>
+typename concurrent_vector<T, Alloc>::reference
+concurrent_vector<T, Alloc>::operator[](size_type idx) {
+  const size_type k = segment_of(idx);
+  return segment_data_[k].load(std::memory_order_acquire)[idx -
+                                                          segment_begin(k)];
+}
+
+template <class T, class Alloc>
+typename concurrent_vector<T, Alloc>::const_reference
+concurrent_vector<T, Alloc>::operator[](size_type idx) const {
+  const size_type k = segment_of(idx);
+  return segment_data_[k].load(std::memory_order_acquire)[idx -
+                                                          segment_begin(k)];
+}
+
+template <class T, class Alloc>
+typename concurrent_vector<T, Alloc>::iterator
+concurrent_vector<T, Alloc>::begin() {
+  return iterator(this, 0);
+}
+
+template <class T, class Alloc>
+typename concurrent_vector<T, Alloc>::const_iterator
+concurrent_vector<T, Alloc>::begin() const {
+  return const_iterator(this, 0);
+}
+
+template <class T, class Alloc>
+typename concurrent_vector<T, Alloc>::const_iterator
+concurrent_vector<T, Alloc>::cbegin() const {
+  return begin();
+}
+
+template <class T, class Alloc>
+typename concurrent_vector<T, Alloc>::iterator
+concurrent_vector<T, Alloc>::end() {
+  return iterator(this, size());
+}
+
+template <class T, class Alloc>
+typename concurrent_vector<T, Alloc>::const_iterator
+concurrent_vector<T, Alloc>::end() const {
+  return const_iterator(this, size());
+}
+
+template <class T, class Alloc>
+typename concurrent_vector<T, Alloc>::const_iterator
+concurrent_vector<T, Alloc>::cend() const {
+  return end();
+}
+
+template <class T, class Alloc>
+typename concurrent_vector<T, Alloc>::allocator_type
+concurrent_vector<T, Alloc>::get_allocator() const {
+  return allocator_;
+}
+
+template <class T, class Alloc>
+typename concurrent_vector<T, Alloc>::size_type
+concurrent_vector<T, Alloc>::segment_of(size_type idx) {
+  return detail::floor_log2(idx / first_segment_size + 1);
+}
+
+template <class T, class Alloc>
+typename concurrent_vector<T, Alloc>::size_type
+concurrent_vector<T, Alloc>::segment_begin(size_type k) {
+  return first_segment_size * ((size_type(1) << k) - 1);
+}
+
+template <class T, class Alloc>
+typename concurrent_vector<T, Alloc>::size_type
+concurrent_vector<T, Alloc>::segment_size(size_type k) {
+  return first_segment_size << k;
+}
+
+template <class T, class Alloc>
+T *concurrent_vector<T, Alloc>::ensure_segment(size_type k) {
+  // Allocate with copies, the members may be used by other threads
+  if (segment_ready_[k].load(std::memory_order_acquire) == nullptr) {
+    flag_allocator flags(allocator_);
+    ready_flag *ready = flag_traits::allocate(flags, segment_size(k));
+    for (size_type i = 0; i < segment_size(k); ++i) {
+      flag_traits::construct(flags, ready + i, static_cast<unsigned char>(0));
+    }
+
+    ready_flag *expected = nullptr;
+    if (!segment_ready_[k].compare_exchange_strong(
+            expected, ready, std::memory_order_acq_rel,
+            std::memory_order_acquire)) {
+      flag_traits::deallocate(flags, ready, segment_size(k));
+    }
+  }
+
+  T *data = segment_data_[k].load(std::memory_order_acquire);
+  if (data != nullptr) {
+    return data;
+  }
+
+  Alloc alloc(allocator_);
+  T *segment = alloc_traits::allocate(alloc, segment_size(k));
+
+  // Publishing hands the segment over to the vector, nothing throws after it
+  T *expected = nullptr;
+  if (segment_data_[k].compare_exchange_strong(expected, segment,
+                                               std::memory_order_acq_rel,
+                                               std::memory_order_acquire)) {
+    return segment;
+  }
+  alloc_traits::deallocate(alloc, segment, segment_size(k));
+  return expected;
+}
+
+template <class T, class Alloc>
+template <typename Constructor>
+typename concurrent_vector<T, Alloc>::size_type
+concurrent_vector<T, Alloc>::append(size_type n, Constructor construct) {
+  if (n == 0) {
+    return reserved_.load(std::memory_order_relaxed);
+  }
+  if (broken_.load(std::memory_order_acquire)) {
+    throw std::bad_alloc();
+  }
+
+  // Only reserve the slots, if they fit, otherwise they could never be
+  // published, and neither could the ones reserved after them
+  const size_type limit = max_size();
+  size_type first = reserved_.load(std::memory_order_relaxed);
+  do {
+    if (first > limit || n > limit - first) {
+      throw std::length_error("concurrent_vector: required capacity exceeds "
+                              "max_size()");
+    }
+  } while (!reserved_.compare_exchange_weak(first, first + n,
+                                            std::memory_order_relaxed,
+                                            std::memory_order_relaxed));
+  const size_type last = first + n;
+
+  try {
+    for (size_type k = segment_of(first); k <= segment_of(last - 1); ++k) {
+      ensure_segment(k);
+    }
+  } catch (...) {
+    // Without the segment, the slots can never be published
+    broken_.store(true, std::memory_order_release);
+    throw;
+  }
+
+  std::exception_ptr error;
+
+  // Construct piecewise, as the slots may span several segments
+  for (size_type pos = first; pos < last;) {
+    const size_type piece =
+        std::min(last, segment_begin(segment_of(pos) + 1)) - pos;
+
+    try {
+      if (!error) {
+        construct(slot(pos), piece);
+      } else {
+        constructor_.value_construct_n(slot(pos), piece);
+      }
+    } catch (...) {
+      // Keep the prefix intact, value initializing can't throw
+      error = std::current_exception();
+      constructor_.value_construct_n(slot(pos), piece);
+    }
+    pos += piece;
+  }
+
+  publish(first, last);
+
+  if (error) {
+    std::rethrow_exception(error);
+  }
+  return first;
+}
+
+template <class T, class Alloc>
+void concurrent_vector<T, Alloc>::publish(size_type first, size_type last) {
+  size_type published = first;
+
+  // Fast path, all earlier slots are published: publish the own ones directly
+  if (size_.compare_exchange_strong(published, last,
+                                    std::memory_order_seq_cst,
+                                    std::memory_order_relaxed)) {
+    advance(last);
+    return;
+  }
+
+  // Otherwise, leave them to the thread publishing the earlier slots
+  for (size_type pos = first; pos < last;) {
+    const size_type k = segment_of(pos);
+    const size_type piece = std::min(last, segment_begin(k + 1)) - pos;
+
+    ready_flag *ready = segment_ready_[k].load(std::memory_order_relaxed) +
+                        (pos - segment_begin(k));
+    for (size_type i = 0; i < piece; ++i) {
+      ready[i].store(1, std::memory_order_release);
+    }
+    pos += piece;
+  }
+
+  // Either this thread sees the size_ of a thread, which stopped advancing
+  // before the flags, or that thread sees the flags
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+
+  advance(size_.load(std::memory_order_relaxed));
+}
+
+template <class T, class Alloc>
+void concurrent_vector<T, Alloc>::advance(size_type published) {
+  for (;;) {
+    size_type end = published;
+    while (is_ready(end)) {
+      ++end;
+    }
+    // On failure, published is reloaded, and the scan repeated from there
+    if (end == published ||
+        size_.compare_exchange_weak(published, end, std::memory_order_acq_rel,
+                                    std::memory_order_relaxed)) {
+      return;
+    }
+  }
+}
+
+template <class T, class Alloc>
+bool concurrent_vector<T, Alloc>::is_ready(size_type idx) const {
+  const size_type k = segment_of(idx);
+  if (k >= max_segments) {
+    return false;
+  }
+  const ready_flag *ready = segment_ready_[k].load(std::memory_order_acquire);
+  // Sequentially consistent, to pair with the fence in publish
+  return ready != nullptr &&
+         ready[idx - segment_begin(k)].load(std::memory_order_seq_cst) != 0;
+}
+
+template <class T, class Alloc>
+typename concurrent_vector<T, Alloc>::storage_type::iterator
+concurrent_vector<T, Alloc>::slot(size_type idx) {
+  const size_type k = segment_of(idx);
+  return typename storage_type::iterator(
+      segment_data_[k].load(std::memory_order_acquire) +
+      (idx - segment_begin(k)));
+}
+
+} // namespace mem
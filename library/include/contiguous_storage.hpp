@@ -1,9 +1,17 @@
 #pragma once
 
 #include "normal_iterator.hpp"
+#include "parallel_policy.hpp"
+#include "trivially_relocatable.hpp"
 #include <algorithm>
+#include <cstring>
 #include <exception>
+#include <iterator>
 #include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
 
 namespace mem {
 namespace detail {
@@ -12,15 +20,68 @@ class allocator_mismatch_on_swap : public std::runtime_error {
 public:
   allocator_mismatch_on_swap()
       : std::runtime_error("swap called on containers with allocators that "
-                           "propagate on swap, but compare non-equal") {}
+                           "don't propagate on swap, and compare non-equal") {}
 };
 
 struct copy_allocator_t {};
 
+/// Tag to construct a contiguous_storage on top of a buffer it doesn't own
+struct external_buffer_t {};
+
+/// Detects the optional allocator extension `bool try_expand(p, old_n, new_n)`,
+/// which grows the block at p from old_n to new_n elements without moving it
+template <class Alloc, class = void> struct has_try_expand : std::false_type {};
+
+template <class Alloc>
+struct has_try_expand<
+    Alloc,
+    std::void_t<decltype(bool(std::declval<Alloc &>().try_expand(
+        std::declval<typename std::allocator_traits<Alloc>::pointer>(),
+        std::declval<typename std::allocator_traits<Alloc>::size_type>(),
+        std::declval<typename std::allocator_traits<Alloc>::size_type>())))>>
+    : std::true_type {};
+
+/// Detects the optional allocator extension `pointer try_reallocate(p, old_n,
+/// new_n)`, which grows the block at p from old_n to new_n elements and may
+/// move its bytes to a new address. Returns a null pointer on failure, in
+/// which case the block is left untouched
+template <class Alloc, class = void>
+struct has_try_reallocate : std::false_type {};
+
+template <class Alloc>
+struct has_try_reallocate<
+    Alloc,
+    std::enable_if_t<std::is_convertible_v<
+        decltype(std::declval<Alloc &>().try_reallocate(
+            std::declval<typename std::allocator_traits<Alloc>::pointer>(),
+            std::declval<typename std::allocator_traits<Alloc>::size_type>(),
+            std::declval<typename std::allocator_traits<Alloc>::size_type>())),
+        typename std::allocator_traits<Alloc>::pointer>>> : std::true_type {};
+
+/// Alignment of the blocks returned by Alloc. Allocators guaranteeing more than
+/// the alignment of their value_type announce it as static member alignment
+template <class Alloc, class = void>
+struct allocator_alignment
+    : std::integral_constant<
+          std::size_t,
+          alignof(typename std::allocator_traits<Alloc>::value_type)> {};
+
+template <class Alloc>
+struct allocator_alignment<Alloc, std::void_t<decltype(Alloc::alignment)>>
+    : std::integral_constant<std::size_t, Alloc::alignment> {};
+
 template <class T, class Alloc> class contiguous_storage {
 private:
   using alloc_traits = std::allocator_traits<Alloc>;
 
+  /// Iterator used to relocate elements, moves them if that can't throw (or
+  /// they can't be copied), copies them otherwise (see std::move_if_noexcept)
+  template <class Iterator>
+  using move_if_noexcept_iterator =
+      std::conditional_t<std::is_nothrow_move_constructible_v<T> ||
+                             !std::is_copy_constructible_v<T>,
+                         std::move_iterator<Iterator>, Iterator>;
+
 public:
   using allocator_type = Alloc;
 
@@ -46,6 +107,10 @@ private:
 
   size_type size_;
 
+  /// false, if the buffer wasn't allocated by this storage (e.g. it's the
+  /// inline buffer of a small_vector), then it's never deallocated or expanded
+  bool owns_buffer_;
+
 public:
   explicit contiguous_storage(const allocator_type &alloc = allocator_type{});
 
@@ -58,6 +123,11 @@ public:
   explicit contiguous_storage(copy_allocator_t, const contiguous_storage &alloc,
                               size_type n);
 
+  /// Use the n element buffer starting at buffer, which is owned by someone
+  /// else and has to outlive the storage
+  explicit contiguous_storage(external_buffer_t, pointer buffer, size_type n,
+                              const allocator_type &alloc = allocator_type{});
+
   ~contiguous_storage();
 
   /// return the current number of elements
@@ -88,14 +158,33 @@ public:
 
   allocator_type get_allocator() const;
 
+  /// false, if the storage uses an external buffer
+  bool owns_buffer() const;
+
   void allocate(size_type n);
 
   void deallocate();
 
+  /// Try to grow the buffer to n elements without moving it, using the
+  /// allocator extension try_expand (see has_try_expand). Returns false, if the
+  /// allocator doesn't provide it, the expansion failed, or there is no buffer
+  bool try_expand(size_type n);
+
+  /// Try to grow the buffer to n elements, using the allocator extension
+  /// try_reallocate (see has_try_reallocate). The buffer may be moved, which
+  /// invalidates all iterators and references into it. As the elements are
+  /// moved bytewise, this is only done for trivially relocatable types.
+  /// Returns false, if nothing was done
+  bool try_reallocate(size_type n);
+
   void swap(contiguous_storage &x);
 
   void default_construct_n(iterator first, size_type n);
 
+  void value_construct_n(iterator first, size_type n);
+
+  template <typename... Args> void construct(iterator pos, Args &&...args);
+
   void uninitialized_fill_n(iterator first, size_type n,
                             const value_type &value);
 
@@ -106,8 +195,40 @@ public:
   template <typename InputIterator, typename Size>
   iterator uninitialized_copy_n(InputIterator first, Size n, iterator result);
 
+  /// Parallel default_construct_n (see parallel_policy). Either all elements
+  /// are constructed, or none if a constructor throws
+  void default_construct_n(const parallel_policy &policy, iterator first,
+                           size_type n);
+
+  /// Parallel value_construct_n (see parallel_policy). Either all elements
+  /// are constructed, or none if a constructor throws
+  void value_construct_n(const parallel_policy &policy, iterator first,
+                         size_type n);
+
+  /// Parallel uninitialized_fill_n (see parallel_policy). Either all elements
+  /// are constructed, or none if a constructor throws
+  void uninitialized_fill_n(const parallel_policy &policy, iterator first,
+                            size_type n, const value_type &value);
+
+  /// Parallel uninitialized_copy (see parallel_policy), only random access
+  /// ranges are split, others are copied sequentially. Either all elements
+  /// are constructed, or none if a constructor throws
+  template <typename InputIterator>
+  iterator uninitialized_copy(const parallel_policy &policy,
+                              InputIterator first, InputIterator last,
+                              iterator result);
+
   void destroy(iterator first, iterator last);
 
+  /// Relocate the elements of [first, last) to the uninitialized memory
+  /// starting at result, afterwards [first, last) is uninitialized memory.
+  ///
+  /// For trivially relocatable types this is a single memmove, and the ranges
+  /// may overlap. Otherwise the elements are moved if that can't throw (copied
+  /// otherwise) and then destroyed, here the ranges must not overlap. If an
+  /// exception is thrown, [first, last) is left untouched
+  iterator relocate(iterator first, iterator last, iterator result);
+
   void deallocate_on_allocator_mismatch(const contiguous_storage &other);
 
   void destroy_on_allocator_mismatch(const contiguous_storage &other,
@@ -127,9 +248,35 @@ public:
   contiguous_storage &operator=(const contiguous_storage &x) = delete;
 
 private:
-  void swap_allocators(std::true_type, const allocator_type &);
+  bool try_expand_dispatch(std::true_type, size_type n);
+
+  bool try_expand_dispatch(std::false_type, size_type n);
 
-  void swap_allocators(std::false_type, allocator_type &);
+  bool try_reallocate_dispatch(std::true_type, size_type n);
+
+  bool try_reallocate_dispatch(std::false_type, size_type n);
+
+  iterator relocate_dispatch(std::true_type, iterator first, iterator last,
+                             iterator result);
+
+  iterator relocate_dispatch(std::false_type, iterator first, iterator last,
+                             iterator result);
+
+  template <typename InputIterator>
+  iterator uninitialized_copy_dispatch(const parallel_policy &policy,
+                                       InputIterator first, InputIterator last,
+                                       iterator result,
+                                       std::random_access_iterator_tag);
+
+  template <typename InputIterator>
+  iterator uninitialized_copy_dispatch(const parallel_policy &policy,
+                                       InputIterator first, InputIterator last,
+                                       iterator result,
+                                       std::input_iterator_tag);
+
+  void swap_allocators(std::true_type, allocator_type &other);
+
+  void swap_allocators(std::false_type, const allocator_type &other);
 
   bool is_allocator_not_equal_dispatch(std::true_type,
                                        const allocator_type &) const;
@@ -166,12 +313,14 @@ private:
 
 template <class T, class Alloc>
 contiguous_storage<T, Alloc>::contiguous_storage(const allocator_type &alloc)
-    : allocator_(alloc), begin_(pointer(static_cast<T *>(0))), size_(0) {}
+    : allocator_(alloc), begin_(pointer(static_cast<T *>(0))), size_(0),
+      owns_buffer_(true) {}
 
 template <class T, class Alloc>
 contiguous_storage<T, Alloc>::contiguous_storage(size_type n,
                                                  const allocator_type &alloc)
-    : allocator_(alloc), begin_(pointer(static_cast<T *>(0))), size_(0) {
+    : allocator_(alloc), begin_(pointer(static_cast<T *>(0))), size_(0),
+      owns_buffer_(true) {
   allocate(n);
 }
 
@@ -179,16 +328,22 @@ template <class T, class Alloc>
 contiguous_storage<T, Alloc>::contiguous_storage(
     copy_allocator_t, const contiguous_storage &other)
     : allocator_(other.allocator_), begin_(pointer(static_cast<T *>(0))),
-      size_(0) {}
+      size_(0), owns_buffer_(true) {}
 
 template <class T, class Alloc>
 contiguous_storage<T, Alloc>::contiguous_storage(
     copy_allocator_t, const contiguous_storage &other, size_type n)
     : allocator_(other.allocator_), begin_(pointer(static_cast<T *>(0))),
-      size_(0) {
+      size_(0), owns_buffer_(true) {
   allocate(n);
 }
 
+template <class T, class Alloc>
+contiguous_storage<T, Alloc>::contiguous_storage(external_buffer_t,
+                                                 pointer buffer, size_type n,
+                                                 const allocator_type &alloc)
+    : allocator_(alloc), begin_(buffer), size_(n), owns_buffer_(false) {}
+
 template <class T, class Alloc>
 contiguous_storage<T, Alloc>::~contiguous_storage() {
   deallocate();
@@ -209,13 +364,13 @@ contiguous_storage<T, Alloc>::max_size() const {
 template <class T, class Alloc>
 typename contiguous_storage<T, Alloc>::pointer
 contiguous_storage<T, Alloc>::data() {
-  return &(*begin_);
+  return begin_.base();
 }
 
 template <class T, class Alloc>
 typename contiguous_storage<T, Alloc>::const_pointer
 contiguous_storage<T, Alloc>::data() const {
-  return &(*begin_);
+  return begin_.base();
 }
 
 template <class T, class Alloc>
@@ -272,8 +427,15 @@ contiguous_storage<T, Alloc>::get_allocator() const {
   return allocator_;
 }
 
+template <class T, class Alloc>
+bool contiguous_storage<T, Alloc>::owns_buffer() const {
+  return owns_buffer_;
+}
+
 template <class T, class Alloc>
 void contiguous_storage<T, Alloc>::allocate(size_type n) {
+  owns_buffer_ = true;
+
   if (n > 0) {
     begin_ = iterator(alloc_traits::allocate(allocator_, n));
     size_ = n;
@@ -286,25 +448,49 @@ void contiguous_storage<T, Alloc>::allocate(size_type n) {
 template <class T, class Alloc>
 void contiguous_storage<T, Alloc>::deallocate() {
   if (size() > 0) {
-    alloc_traits::deallocate(allocator_, begin_.base(), size());
+    if (owns_buffer_) {
+      alloc_traits::deallocate(allocator_, begin_.base(), size());
+    }
     begin_ = pointer(static_cast<T *>(0));
     size_ = 0;
   }
+  owns_buffer_ = true;
+}
+
+template <class T, class Alloc>
+bool contiguous_storage<T, Alloc>::try_expand(size_type n) {
+  if (size() == 0 || n <= size() || !owns_buffer_) {
+    return false;
+  }
+  return try_expand_dispatch(has_try_expand<Alloc>(), n);
+}
+
+template <class T, class Alloc>
+bool contiguous_storage<T, Alloc>::try_reallocate(size_type n) {
+  if (size() == 0 || n <= size() || !owns_buffer_) {
+    return false;
+  }
+  return try_reallocate_dispatch(
+      std::integral_constant<bool, has_try_reallocate<Alloc>::value &&
+                                       is_trivially_relocatable<T>::value>(),
+      n);
 }
 
 template <class T, class Alloc>
 void contiguous_storage<T, Alloc>::swap(contiguous_storage &x) {
   using std::swap;
-  swap(begin_, x.begin_);
-  swap(size_, x.size_);
 
+  // Swap (or check) the allocators first, such that nothing is changed, if
+  // they can't be swapped
   swap_allocators(
       std::integral_constant<
           bool,
           std::allocator_traits<Alloc>::propagate_on_container_swap::value>(),
-      x.m_allocator);
+      x.allocator_);
 
-  swap(allocator_, x.allocator_);
+  swap(begin_, x.begin_);
+  swap(size_, x.size_);
+  swap(owns_buffer_, x.owns_buffer_);
 }
 
 template <class T, class Alloc>
@@ -314,6 +500,20 @@ void contiguous_storage<T, Alloc>::default_construct_n(
   std::uninitialized_default_construct_n(first.base(), n);
 }
 
+template <class T, class Alloc>
+void contiguous_storage<T, Alloc>::value_construct_n(
+    contiguous_storage<T, Alloc>::iterator first,
+    contiguous_storage<T, Alloc>::size_type n) {
+  std::uninitialized_value_construct_n(first.base(), n);
+}
+
+template <class T, class Alloc>
+template <typename... Args>
+void contiguous_storage<T, Alloc>::construct(
+    contiguous_storage<T, Alloc>::iterator pos, Args &&...args) {
+  ::new (static_cast<void *>(pos.base())) T(std::forward<Args>(args)...);
+}
+
 template <class T, class Alloc>
 void contiguous_storage<T, Alloc>::uninitialized_fill_n(
     contiguous_storage<T, Alloc>::iterator first,
@@ -328,7 +528,9 @@ typename contiguous_storage<T, Alloc>::iterator
 contiguous_storage<T, Alloc>::uninitialized_copy(
     InputIterator first, InputIterator last,
     contiguous_storage<T, Alloc>::iterator result) {
-  return iterator(std::uninitialized_copy(first, last, result.base()));
+  return iterator(std::uninitialized_copy(detail::unwrap_iterator(first),
+                                          detail::unwrap_iterator(last),
+                                          result.base()));
 }
 
 template <class T, class Alloc>
@@ -337,7 +539,102 @@ typename contiguous_storage<T, Alloc>::iterator
 contiguous_storage<T, Alloc>::uninitialized_copy_n(
     InputIterator first, Size n,
     contiguous_storage<T, Alloc>::iterator result) {
-  return iterator(std::uninitialized_copy_n(first, n, result.base()));
+  return iterator(
+      std::uninitialized_copy_n(detail::unwrap_iterator(first), n,
+                                result.base()));
+}
+
+template <class T, class Alloc>
+void contiguous_storage<T, Alloc>::default_construct_n(
+    const parallel_policy &policy, contiguous_storage<T, Alloc>::iterator first,
+    contiguous_storage<T, Alloc>::size_type n) {
+  pointer p = first.base();
+  detail::parallel_chunks(
+      policy, n,
+      [p](std::size_t begin, std::size_t end) {
+        std::uninitialized_default_construct(p + begin, p + end);
+      },
+      [p](std::size_t begin, std::size_t end) {
+        std::destroy(p + begin, p + end);
+      });
+}
+
+template <class T, class Alloc>
+void contiguous_storage<T, Alloc>::value_construct_n(
+    const parallel_policy &policy, contiguous_storage<T, Alloc>::iterator first,
+    contiguous_storage<T, Alloc>::size_type n) {
+  pointer p = first.base();
+  detail::parallel_chunks(
+      policy, n,
+      [p](std::size_t begin, std::size_t end) {
+        std::uninitialized_value_construct(p + begin, p + end);
+      },
+      [p](std::size_t begin, std::size_t end) {
+        std::destroy(p + begin, p + end);
+      });
+}
+
+template <class T, class Alloc>
+void contiguous_storage<T, Alloc>::uninitialized_fill_n(
+    const parallel_policy &policy, contiguous_storage<T, Alloc>::iterator first,
+    contiguous_storage<T, Alloc>::size_type n,
+    const contiguous_storage<T, Alloc>::value_type &value) {
+  pointer p = first.base();
+  detail::parallel_chunks(
+      policy, n,
+      [p, &value](std::size_t begin, std::size_t end) {
+        std::uninitialized_fill(p + begin, p + end, value);
+      },
+      [p](std::size_t begin, std::size_t end) {
+        std::destroy(p + begin, p + end);
+      });
+}
+
+template <class T, class Alloc>
+template <typename InputIterator>
+typename contiguous_storage<T, Alloc>::iterator
+contiguous_storage<T, Alloc>::uninitialized_copy(
+    const parallel_policy &policy, InputIterator first, InputIterator last,
+    contiguous_storage<T, Alloc>::iterator result) {
+  return uninitialized_copy_dispatch(
+      policy, first, last, result,
+      typename std::iterator_traits<InputIterator>::iterator_category());
+}
+
+template <class T, class Alloc>
+template <typename InputIterator>
+typename contiguous_storage<T, Alloc>::iterator
+contiguous_storage<T, Alloc>::uninitialized_copy_dispatch(
+    const parallel_policy &policy, InputIterator first, InputIterator last,
+    contiguous_storage<T, Alloc>::iterator result,
+    std::random_access_iterator_tag) {
+  pointer p = result.base();
+  const auto n = static_cast<size_type>(last - first);
+  auto source = detail::unwrap_iterator(first);
+
+  detail::parallel_chunks(
+      policy, n,
+      [p, source](std::size_t begin, std::size_t end) {
+        using difference = typename std::iterator_traits<
+            decltype(source)>::difference_type;
+        std::uninitialized_copy(source + static_cast<difference>(begin),
+                                source + static_cast<difference>(end),
+                                p + begin);
+      },
+      [p](std::size_t begin, std::size_t end) {
+        std::destroy(p + begin, p + end);
+      });
+
+  return result + static_cast<difference_type>(n);
+}
+
+template <class T, class Alloc>
+template <typename InputIterator>
+typename contiguous_storage<T, Alloc>::iterator
+contiguous_storage<T, Alloc>::uninitialized_copy_dispatch(
+    const parallel_policy &, InputIterator first, InputIterator last,
+    contiguous_storage<T, Alloc>::iterator result, std::input_iterator_tag) {
+  return uninitialized_copy(first, last, result);
 }
 
 template <class T, class Alloc>
@@ -347,6 +644,15 @@ void contiguous_storage<T, Alloc>::destroy(
   std::destroy(first.base(), last.base());
 }
 
+template <class T, class Alloc>
+typename contiguous_storage<T, Alloc>::iterator
+contiguous_storage<T, Alloc>::relocate(
+    contiguous_storage<T, Alloc>::iterator first,
+    contiguous_storage<T, Alloc>::iterator last,
+    contiguous_storage<T, Alloc>::iterator result) {
+  return relocate_dispatch(is_trivially_relocatable<T>(), first, last, result);
+}
+
 template <class T, class Alloc>
 void contiguous_storage<T, Alloc>::deallocate_on_allocator_mismatch(
     const contiguous_storage &other) {
@@ -396,15 +702,15 @@ void contiguous_storage<T, Alloc>::propagate_allocator(
 template <class T, class Alloc>
 contiguous_storage<T, Alloc> &
 contiguous_storage<T, Alloc>::operator=(contiguous_storage &&other) {
-  if (size() > 0) {
-    deallocate();
-  }
+  deallocate();
   propagate_allocator(other);
-  begin_ = std::move(other.m_begin);
-  size_ = std::move(other.m_size);
+  begin_ = std::move(other.begin_);
+  size_ = std::move(other.size_);
+  owns_buffer_ = other.owns_buffer_;
 
   other.begin_ = pointer(static_cast<T *>(0));
   other.size_ = 0;
+  other.owns_buffer_ = true;
 
   return *this;
 }
@@ -421,22 +727,85 @@ bool contiguous_storage<T, Alloc>::is_allocator_not_equal(
 template <class T, class Alloc>
 bool contiguous_storage<T, Alloc>::is_allocator_not_equal(
     const contiguous_storage &other) const {
-  return is_allocator_not_equal(allocator_, other.allocator_);
+  return is_allocator_not_equal(other.allocator_);
 }
 
 template <class T, class Alloc>
-void contiguous_storage<T, Alloc>::swap_allocators(std::true_type,
-                                                   const allocator_type &) {}
+bool contiguous_storage<T, Alloc>::try_expand_dispatch(std::true_type,
+                                                       size_type n) {
+  if (allocator_.try_expand(begin_.base(), size(), n)) {
+    size_ = n;
+    return true;
+  }
+  return false;
+}
 
 template <class T, class Alloc>
-void contiguous_storage<T, Alloc>::swap_allocators(std::false_type,
+bool contiguous_storage<T, Alloc>::try_expand_dispatch(std::false_type,
+                                                       size_type) {
+  return false;
+}
+
+template <class T, class Alloc>
+bool contiguous_storage<T, Alloc>::try_reallocate_dispatch(std::true_type,
+                                                           size_type n) {
+  pointer p = allocator_.try_reallocate(begin_.base(), size(), n);
+
+  if (p) {
+    begin_ = iterator(p);
+    size_ = n;
+    return true;
+  }
+  return false;
+}
+
+template <class T, class Alloc>
+bool contiguous_storage<T, Alloc>::try_reallocate_dispatch(std::false_type,
+                                                           size_type) {
+  return false;
+}
+
+template <class T, class Alloc>
+typename contiguous_storage<T, Alloc>::iterator
+contiguous_storage<T, Alloc>::relocate_dispatch(std::true_type, iterator first,
+                                                iterator last,
+                                                iterator result) {
+  const auto n = last - first;
+
+  if (n > 0) {
+    std::memmove(static_cast<void *>(result.base()),
+                 static_cast<const void *>(first.base()), n * sizeof(T));
+  }
+  return result + n;
+}
+
+template <class T, class Alloc>
+typename contiguous_storage<T, Alloc>::iterator
+contiguous_storage<T, Alloc>::relocate_dispatch(std::false_type,
+                                                iterator first, iterator last,
+                                                iterator result) {
+  iterator new_last =
+      uninitialized_copy(move_if_noexcept_iterator<iterator>(first),
+                         move_if_noexcept_iterator<iterator>(last), result);
+  destroy(first, last);
+  return new_last;
+}
+
+template <class T, class Alloc>
+void contiguous_storage<T, Alloc>::swap_allocators(std::true_type,
                                                    allocator_type &other) {
   using std::swap;
+  swap(allocator_, other);
+}
+
+template <class T, class Alloc>
+void contiguous_storage<T, Alloc>::swap_allocators(
+    std::false_type, const allocator_type &other) {
+  // Allocators stay with their container, so the buffers can only be swapped,
+  // if each can be deallocated with the other allocator
   if (is_allocator_not_equal(other)) {
     throw allocator_mismatch_on_swap();
   }
-
-  swap(allocator_, other);
 }
 
 template <class T, class Alloc>
@@ -487,5 +856,15 @@ template <class T, class Alloc>
 void contiguous_storage<T, Alloc>::propagate_allocator_dispatch(
     std::false_type, const contiguous_storage &other) {}
 
+template <class T, class Alloc>
+void contiguous_storage<T, Alloc>::propagate_allocator_dispatch(
+    std::true_type, contiguous_storage &other) {
+  allocator_ = other.allocator_;
+}
+
+template <class T, class Alloc>
+void contiguous_storage<T, Alloc>::propagate_allocator_dispatch(
+    std::false_type, contiguous_storage &other) {}
+
 } // namespace detail
 } // namespace mem
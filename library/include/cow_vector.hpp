@@ -0,0 +1,687 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "base_vector.hpp"
+
+namespace mem {
+
+/**
+ * @brief Vector, whose copies share the elements until one of them is
+ * modified (copy on write).
+ *
+ * The elements live in a base_vector in a block, which is shared by all copies
+ * and counts them atomically. Copying a cow_vector only increments the count.
+ * The first mutable access (non-const operator[], begin(), end(), data(),
+ * front(), back(), or any modifier) of a shared block clones it, so the
+ * vector owns its elements afterwards. assign and clear don't clone, they
+ * just let go of the shared block. make_unique() clones up front, e.g. before
+ * a hot loop.
+ *
+ * Like std::shared_ptr, distinct cow_vectors sharing a block may be used from
+ * different threads, a single cow_vector must not be modified concurrently.
+ *
+ * References and iterators obtained by mutable access point into the block of
+ * this vector, so they must not be used to modify it, after the vector was
+ * copied, the copy would see the change. Use cbegin() and the const overloads
+ * for read only access, they never clone.
+ *
+ * Copies share the block only if the allocators compare equal, otherwise the
+ * elements are copied.
+ *
+ * @tparam T type of the stored elements
+ * @tparam Alloc allocator used for the elements and the shared block
+ * @tparam GrowthPolicy policy computing the new capacity, if the vector runs
+ * out of space (see growth_policy.hpp)
+ */
+template <class T, class Alloc = std::allocator<T>,
+          class GrowthPolicy = growth::default_policy>
+class cow_vector {
+public:
+  using vector_type = base_vector<T, Alloc, GrowthPolicy>;
+
+  using value_type = typename vector_type::value_type;
+
+  using reference = typename vector_type::reference;
+  using const_reference = typename vector_type::const_reference;
+
+  using pointer = typename vector_type::pointer;
+  using const_pointer = typename vector_type::const_pointer;
+
+  using size_type = typename vector_type::size_type;
+
+  using allocator_type = typename vector_type::allocator_type;
+
+  using growth_policy = GrowthPolicy;
+
+  using iterator = typename vector_type::iterator;
+  using const_iterator = typename vector_type::const_iterator;
+
+private:
+  /// Elements shared by all copies of a vector
+  struct shared_block {
+    std::atomic<std::size_t> use_count;
+    vector_type elements;
+
+    template <class... Args>
+    explicit shared_block(Args &&...args)
+        : use_count(1), elements(std::forward<Args>(args)...) {}
+  };
+
+  using alloc_traits = std::allocator_traits<Alloc>;
+  using block_allocator =
+      typename alloc_traits::template rebind_alloc<shared_block>;
+  using block_traits = std::allocator_traits<block_allocator>;
+
+  allocator_type allocator_;
+
+  /// nullptr for an empty vector, which doesn't own a buffer
+  shared_block *block_;
+
+public:
+  /// create empty vector, this doesn't allocate
+  cow_vector();
+
+  /// create empty vector with given allocator, this doesn't allocate
+  explicit cow_vector(const Alloc &alloc);
+
+  /// create vector of size n, with value initialized values
+  explicit cow_vector(size_type n, const Alloc &alloc = Alloc());
+
+  /// create vector of size n, with copies of value
+  cow_vector(size_type n, const value_type &value,
+             const Alloc &alloc = Alloc());
+
+  cow_vector(std::initializer_list<value_type> values,
+             const Alloc &alloc = Alloc());
+
+  /// Construct cow_vector from iterator range
+  template <typename InputIter,
+            typename = std::enable_if_t<!std::is_integral_v<InputIter>>>
+  cow_vector(InputIter first, InputIter last, const Alloc &alloc = Alloc());
+
+  /// Take over the elements of v, without copying them
+  explicit cow_vector(vector_type &&v);
+
+  /// Shares the elements of v, if the allocators compare equal, copies them
+  /// otherwise
+  cow_vector(const cow_vector &v);
+
+  cow_vector(cow_vector &&v) noexcept;
+
+  /// Shares the elements of v, if the allocators compare equal (after
+  /// propagating), copies them otherwise
+  cow_vector &operator=(const cow_vector &v);
+
+  cow_vector &operator=(cow_vector &&v);
+
+  ~cow_vector();
+
+  size_type size() const;
+
+  size_type max_size() const;
+
+  size_type capacity() const;
+
+  bool empty() const;
+
+  /// Number of cow_vectors sharing the elements, 0 for an empty vector, which
+  /// doesn't own a buffer
+  size_type use_count() const;
+
+  /// true, if the elements are shared with another cow_vector
+  bool is_shared() const;
+
+  /// Clone the elements, if they are shared, so later mutable accesses are
+  /// free. Returns the vector owning the elements, which stays valid until
+  /// this cow_vector is copied, assigned or destroyed
+  vector_type &make_unique();
+
+  /// The elements as base_vector, e.g. to pass them to functions taking a
+  /// const base_vector &. This never clones. An empty vector without a buffer
+  /// returns a static empty base_vector, which needs a default constructible
+  /// Alloc
+  const vector_type &get() const;
+
+  /// Clones shared elements
+  reference operator[](size_type idx);
+
+  const_reference operator[](size_type idx) const;
+
+  /// Clones shared elements
+  reference front();
+
+  const_reference front() const;
+
+  /// Clones shared elements
+  reference back();
+
+  const_reference back() const;
+
+  /// Clones shared elements
+  iterator begin();
+
+  const_iterator begin() const;
+
+  const_iterator cbegin() const;
+
+  /// Clones shared elements
+  iterator end();
+
+  const_iterator end() const;
+
+  const_iterator cend() const;
+
+  /// Clones shared elements
+  pointer data();
+
+  const_pointer data() const;
+
+  void resize(size_type new_size);
+
+  void resize(size_type new_size, const value_type &value);
+
+  void reserve(size_type new_capacity);
+
+  void push_back(const value_type &value);
+
+  void push_back(value_type &&value);
+
+  template <class... Args> reference emplace_back(Args &&...args);
+
+  void pop_back();
+
+  /// Destroy all elements. Shared elements are left to the other copies, then
+  /// the capacity drops to 0
+  void clear();
+
+  /// Replace the elements with n copies of value, shared elements aren't
+  /// cloned
+  void assign(size_type n, const value_type &value);
+
+  /// Replace the elements with a copy of [first, last), shared elements
+  /// aren't cloned. [first, last) must not refer to this vector
+  template <class InputIter,
+            typename = std::enable_if_t<!std::is_integral_v<InputIter>>>
+  void assign(InputIter first, InputIter last);
+
+  iterator erase(iterator pos);
+
+  iterator erase(iterator first, iterator last);
+
+  iterator insert(iterator pos, const value_type &value);
+
+  iterator insert(iterator pos, value_type &&value);
+
+  iterator insert(iterator pos, size_type n, const value_type &value);
+
+  template <class InputIter,
+            typename = std::enable_if_t<!std::is_integral_v<InputIter>>>
+  iterator insert(iterator pos, InputIter first, InputIter last);
+
+  template <class... Args> iterator emplace(iterator pos, Args &&...args);
+
+  /// Swap the elements of this vector with the ones of v, never copies them
+  void swap(cow_vector &v);
+
+  allocator_type get_allocator() const;
+
+private:
+  /// Allocate a new block owned by this vector, with elements constructed
+  /// from args. The previous block is released afterwards, so args may refer
+  /// to its elements
+  template <class... Args> void reset(Args &&...args);
+
+  /// Drop this vector's reference to the block, the last one destroys it
+  void release();
+
+  /// Share the block of v, or copy its elements, if the allocators differ
+  void share_or_copy(const cow_vector &v);
+
+  /// true, if blocks of a vector using alloc can be shared with this one
+  bool can_share_with(const allocator_type &alloc) const;
+};
+
+template <class T, class Alloc, class GrowthPolicy>
+cow_vector<T, Alloc, GrowthPolicy>::cow_vector() : cow_vector(Alloc()) {}
+
+template <class T, class Alloc, class GrowthPolicy>
+cow_vector<T, Alloc, GrowthPolicy>::cow_vector(const Alloc &alloc)
+    : allocator_(alloc), block_(nullptr) {}
+
+template <class T, class Alloc, class GrowthPolicy>
+cow_vector<T, Alloc, GrowthPolicy>::cow_vector(size_type n, const Alloc &alloc)
+    : cow_vector(alloc) {
+  reset(n, allocator_);
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+cow_vector<T, Alloc, GrowthPolicy>::cow_vector(size_type n,
+                                               const value_type &value,
+                                               const Alloc &alloc)
+    : cow_vector(alloc) {
+  reset(n, value, allocator_);
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+cow_vector<T, Alloc, GrowthPolicy>::cow_vector(
+    std::initializer_list<value_type> values, const Alloc &alloc)
+    : cow_vector(alloc) {
+  reset(values.begin(), values.end(), allocator_);
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+template <typename InputIter, typename>
+cow_vector<T, Alloc, GrowthPolicy>::cow_vector(InputIter first, InputIter last,
+                                               const Alloc &alloc)
+    : cow_vector(alloc) {
+  reset(first, last, allocator_);
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+cow_vector<T, Alloc, GrowthPolicy>::cow_vector(vector_type &&v)
+    : cow_vector(v.get_allocator()) {
+  reset(std::move(v));
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+cow_vector<T, Alloc, GrowthPolicy>::cow_vector(const cow_vector &v)
+    : cow_vector(
+          alloc_traits::select_on_container_copy_construction(v.allocator_)) {
+  share_or_copy(v);
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+cow_vector<T, Alloc, GrowthPolicy>::cow_vector(cow_vector &&v) noexcept
+    : allocator_(v.allocator_), block_(std::exchange(v.block_, nullptr)) {}
+
+template <class T, class Alloc, class GrowthPolicy>
+cow_vector<T, Alloc, GrowthPolicy> &
+cow_vector<T, Alloc, GrowthPolicy>::operator=(const cow_vector &v) {
+  if (this == &v || (block_ != nullptr && block_ == v.block_)) {
+    return *this;
+  }
+
+  release();
+  if (alloc_traits::propagate_on_container_copy_assignment::value) {
+    allocator_ = v.allocator_;
+  }
+  share_or_copy(v);
+  return *this;
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+cow_vector<T, Alloc, GrowthPolicy> &
+cow_vector<T, Alloc, GrowthPolicy>::operator=(cow_vector &&v) {
+  if (this == &v) {
+    return *this;
+  }
+
+  if (alloc_traits::propagate_on_container_move_assignment::value ||
+      can_share_with(v.allocator_)) {
+    release();
+    if (alloc_traits::propagate_on_container_move_assignment::value) {
+      allocator_ = std::move(v.allocator_);
+    }
+    block_ = std::exchange(v.block_, nullptr);
+  } else if (v.is_shared()) {
+    // The block can't be freed by this allocator, copy the elements
+    reset(v.cbegin(), v.cend(), allocator_);
+    v.release();
+  } else if (v.block_) {
+    // The block can't be freed by this allocator, move the elements
+    vector_type &elements = v.block_->elements;
+    reset(std::make_move_iterator(elements.begin()),
+          std::make_move_iterator(elements.end()), allocator_);
+    v.release();
+  } else {
+    release();
+  }
+  return *this;
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+cow_vector<T, Alloc, GrowthPolicy>::~cow_vector() {
+  release();
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+typename cow_vector<T, Alloc, GrowthPolicy>::size_type
+cow_vector<T, Alloc, GrowthPolicy>::size() const {
+  return block_ ? block_->elements.size() : 0;
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+typename cow_vector<T, Alloc, GrowthPolicy>::size_type
+cow_vector<T, Alloc, GrowthPolicy>::max_size() const {
+  return alloc_traits::max_size(allocator_);
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+typename cow_vector<T, Alloc, GrowthPolicy>::size_type
+cow_vector<T, Alloc, GrowthPolicy>::capacity() const {
+  return block_ ? block_->elements.capacity() : 0;
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+bool cow_vector<T, Alloc, GrowthPolicy>::empty() const {
+  return size() == 0;
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+typename cow_vector<T, Alloc, GrowthPolicy>::size_type
+cow_vector<T, Alloc, GrowthPolicy>::use_count() const {
+  return block_ ? block_->use_count.load(std::memory_order_relaxed) : 0;
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+bool cow_vector<T, Alloc, GrowthPolicy>::is_shared() const {
+  return use_count() > 1;
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+typename cow_vector<T, Alloc, GrowthPolicy>::vector_type &
+cow_vector<T, Alloc, GrowthPolicy>::make_unique() {
+  if (!block_) {
+    reset(allocator_);
+  } else if (block_->use_count.load(std::memory_order_acquire) != 1) {
+    // No one else can start sharing the block meanwhile, that would copy this
+    // vector, so the count only drops
+    reset(block_->elements, allocator_);
+  }
+  return block_->elements;
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+const typename cow_vector<T, Alloc, GrowthPolicy>::vector_type &
+cow_vector<T, Alloc, GrowthPolicy>::get() const {
+  if (!block_) {
+    // Vectors without a buffer don't own any memory, so they can be shared
+    static const vector_type empty_vector;
+    return empty_vector;
+  }
+  return block_->elements;
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+typename cow_vector<T, Alloc, GrowthPolicy>::reference
+cow_vector<T, Alloc, GrowthPolicy>::operator[](size_type idx) {
+  return make_unique()[idx];
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+typename cow_vector<T, Alloc, GrowthPolicy>::const_reference
+cow_vector<T, Alloc, GrowthPolicy>::operator[](size_type idx) const {
+  return block_->elements[idx];
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+typename cow_vector<T, Alloc, GrowthPolicy>::reference
+cow_vector<T, Alloc, GrowthPolicy>::front() {
+  return make_unique()[0];
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+typename cow_vector<T, Alloc, GrowthPolicy>::const_reference
+cow_vector<T, Alloc, GrowthPolicy>::front() const {
+  return block_->elements[0];
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+typename cow_vector<T, Alloc, GrowthPolicy>::reference
+cow_vector<T, Alloc, GrowthPolicy>::back() {
+  vector_type &elements = make_unique();
+  return elements[elements.size() - 1];
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+typename cow_vector<T, Alloc, GrowthPolicy>::const_reference
+cow_vector<T, Alloc, GrowthPolicy>::back() const {
+  return block_->elements[block_->elements.size() - 1];
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+typename cow_vector<T, Alloc, GrowthPolicy>::iterator
+cow_vector<T, Alloc, GrowthPolicy>::begin() {
+  return make_unique().begin();
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+typename cow_vector<T, Alloc, GrowthPolicy>::const_iterator
+cow_vector<T, Alloc, GrowthPolicy>::begin() const {
+  return block_ ? block_->elements.begin() : const_iterator(nullptr);
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+typename cow_vector<T, Alloc, GrowthPolicy>::const_iterator
+cow_vector<T, Alloc, GrowthPolicy>::cbegin() const {
+  return block_ ? block_->elements.cbegin() : const_iterator(nullptr);
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+typename cow_vector<T, Alloc, GrowthPolicy>::iterator
+cow_vector<T, Alloc, GrowthPolicy>::end() {
+  return make_unique().end();
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+typename cow_vector<T, Alloc, GrowthPolicy>::const_iterator
+cow_vector<T, Alloc, GrowthPolicy>::end() const {
+  return block_ ? block_->elements.end() : const_iterator(nullptr);
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+typename cow_vector<T, Alloc, GrowthPolicy>::const_iterator
+cow_vector<T, Alloc, GrowthPolicy>::cend() const {
+  return block_ ? block_->elements.cend() : const_iterator(nullptr);
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+typename cow_vector<T, Alloc, GrowthPolicy>::pointer
+cow_vector<T, Alloc, GrowthPolicy>::data() {
+  return make_unique().data();
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+typename cow_vector<T, Alloc, GrowthPolicy>::const_pointer
+cow_vector<T, Alloc, GrowthPolicy>::data() const {
+  return block_ ? block_->elements.data() : nullptr;
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+void cow_vector<T, Alloc, GrowthPolicy>::resize(size_type new_size) {
+  make_unique().resize(new_size);
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+void cow_vector<T, Alloc, GrowthPolicy>::resize(size_type new_size,
+                                                const value_type &value) {
+  make_unique().resize(new_size, value);
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+void cow_vector<T, Alloc, GrowthPolicy>::reserve(size_type new_capacity) {
+  make_unique().reserve(new_capacity);
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+void cow_vector<T, Alloc, GrowthPolicy>::push_back(const value_type &value) {
+  emplace_back(value);
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+void cow_vector<T, Alloc, GrowthPolicy>::push_back(value_type &&value) {
+  emplace_back(std::move(value));
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+template <class... Args>
+typename cow_vector<T, Alloc, GrowthPolicy>::reference
+cow_vector<T, Alloc, GrowthPolicy>::emplace_back(Args &&...args) {
+  // If the elements are cloned, args may still refer to the shared ones, the
+  // other copies keep them alive
+  return make_unique().emplace_back(std::forward<Args>(args)...);
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+void cow_vector<T, Alloc, GrowthPolicy>::pop_back() {
+  make_unique().pop_back();
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+void cow_vector<T, Alloc, GrowthPolicy>::clear() {
+  if (is_shared()) {
+    release();
+  } else if (block_) {
+    block_->elements.clear();
+  }
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+void cow_vector<T, Alloc, GrowthPolicy>::assign(size_type n,
+                                                const value_type &value) {
+  if (is_shared()) {
+    reset(n, value, allocator_);
+  } else {
+    make_unique().assign(n, value);
+  }
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+template <class InputIter, typename>
+void cow_vector<T, Alloc, GrowthPolicy>::assign(InputIter first,
+                                                InputIter last) {
+  if (is_shared()) {
+    reset(first, last, allocator_);
+  } else {
+    make_unique().assign(first, last);
+  }
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+typename cow_vector<T, Alloc, GrowthPolicy>::iterator
+cow_vector<T, Alloc, GrowthPolicy>::erase(iterator pos) {
+  return make_unique().erase(pos);
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+typename cow_vector<T, Alloc, GrowthPolicy>::iterator
+cow_vector<T, Alloc, GrowthPolicy>::erase(iterator first, iterator last) {
+  return make_unique().erase(first, last);
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+typename cow_vector<T, Alloc, GrowthPolicy>::iterator
+cow_vector<T, Alloc, GrowthPolicy>::insert(iterator pos,
+                                           const value_type &value) {
+  return make_unique().insert(pos, value);
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+typename cow_vector<T, Alloc, GrowthPolicy>::iterator
+cow_vector<T, Alloc, GrowthPolicy>::insert(iterator pos, value_type &&value) {
+  return make_unique().insert(pos, std::move(value));
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+typename cow_vector<T, Alloc, GrowthPolicy>::iterator
+cow_vector<T, Alloc, GrowthPolicy>::insert(iterator pos, size_type n,
+                                           const value_type &value) {
+  return make_unique().insert(pos, n, value);
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+template <class InputIter, typename>
+typename cow_vector<T, Alloc, GrowthPolicy>::iterator
+cow_vector<T, Alloc, GrowthPolicy>::insert(iterator pos, InputIter first,
+                                           InputIter last) {
+  return make_unique().insert(pos, first, last);
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+template <class... Args>
+typename cow_vector<T, Alloc, GrowthPolicy>::iterator
+cow_vector<T, Alloc, GrowthPolicy>::emplace(iterator pos, Args &&...args) {
+  return make_unique().emplace(pos, std::forward<Args>(args)...);
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+void cow_vector<T, Alloc, GrowthPolicy>::swap(cow_vector &v) {
+  using std::swap;
+
+  if (alloc_traits::propagate_on_container_swap::value) {
+    swap(allocator_, v.allocator_);
+  } else if (!can_share_with(v.allocator_)) {
+    // The blocks would end up with an allocator, which can't free them
+    throw detail::allocator_mismatch_on_swap();
+  }
+  swap(block_, v.block_);
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+typename cow_vector<T, Alloc, GrowthPolicy>::allocator_type
+cow_vector<T, Alloc, GrowthPolicy>::get_allocator() const {
+  return allocator_;
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+template <class... Args>
+void cow_vector<T, Alloc, GrowthPolicy>::reset(Args &&...args) {
+  block_allocator alloc(allocator_);
+  shared_block *block = block_traits::allocate(alloc, 1);
+
+  try {
+    ::new (static_cast<void *>(block))
+        shared_block(std::forward<Args>(args)...);
+  } catch (...) {
+    block_traits::deallocate(alloc, block, 1);
+    throw;
+  }
+
+  release();
+  block_ = block;
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+void cow_vector<T, Alloc, GrowthPolicy>::release() {
+  shared_block *block = std::exchange(block_, nullptr);
+
+  // The last owner has to see all writes of the others, before destroying
+  if (block && block->use_count.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    block_allocator alloc(allocator_);
+    block->~shared_block();
+    block_traits::deallocate(alloc, block, 1);
+  }
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+void cow_vector<T, Alloc, GrowthPolicy>::share_or_copy(const cow_vector &v) {
+  if (!v.block_) {
+    return;
+  }
+
+  if (can_share_with(v.allocator_)) {
+    v.block_->use_count.fetch_add(1, std::memory_order_relaxed);
+    block_ = v.block_;
+  } else {
+    reset(v.block_->elements, allocator_);
+  }
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+bool cow_vector<T, Alloc, GrowthPolicy>::can_share_with(
+    const allocator_type &alloc) const {
+  if constexpr (alloc_traits::is_always_equal::value) {
+    return true;
+  } else {
+    return allocator_ == alloc;
+  }
+}
+
+} // namespace mem
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstddef>
+
+namespace mem {
+namespace growth {
+
+/**
+ * @brief Geometric growth policy, the capacity grows by a factor of Num / Den
+ * each time the container runs out of space.
+ *
+ * A growth policy is any type providing a static member function
+ * `next_capacity(capacity, required)`, which returns the capacity the container
+ * should reallocate to, when it currently holds `capacity` elements, but has
+ * to store at least `required` elements. The result must be at least
+ * `required`, clamping it to `max_size()` is done by the container.
+ *
+ * @tparam Num numerator of the growth factor
+ * @tparam Den denominator of the growth factor
+ */
+template <std::size_t Num, std::size_t Den> struct geometric {
+  static_assert(Den > 0, "Denominator of growth factor must be non-zero");
+  static_assert(Num > Den, "Growth factor must be larger than 1");
+
+  static constexpr std::size_t next_capacity(std::size_t capacity,
+                                             std::size_t required) {
+    // Compute capacity * Num / Den without overflowing for large capacities
+    const std::size_t grown =
+        capacity / Den * Num + (capacity % Den) * Num / Den;
+
+    // grown < capacity, if the computation overflowed
+    if (grown < capacity || grown < required) {
+      return required;
+    }
+    return grown;
+  }
+};
+
+/// Grow capacity by a factor of 1.5, trades more reallocations for less slack
+using factor_1_5 = geometric<3, 2>;
+
+/// Grow capacity by a factor of 2, the least reallocations of the geometric
+/// policies at the cost of up to 50% unused memory
+using factor_2 = geometric<2, 1>;
+
+/**
+ * @brief Grow capacity by a fixed number of elements. This keeps the slack
+ * bounded by Step elements, but appending is not amortized O(1) anymore, only
+ * use it if an upper bound of the size is roughly known
+ *
+ * @tparam Step number of elements added to the capacity on each growth
+ */
+template <std::size_t Step> struct fixed_step {
+  static_assert(Step > 0, "Step size must be non-zero");
+
+  static constexpr std::size_t next_capacity(std::size_t capacity,
+                                             std::size_t required) {
+    const std::size_t grown = capacity + Step;
+
+    if (grown < capacity || grown < required) {
+      // Round required up to the next multiple of Step
+      const std::size_t rounded = (required + Step - 1) / Step * Step;
+      return rounded < required ? required : rounded;
+    }
+    return grown;
+  }
+};
+
+/**
+ * @brief Grow capacity to the next power of two, which is at least as large as
+ * the required capacity. Behaves like factor_2, but keeps capacities as powers
+ * of two, which plays nicely with allocators using power of two size classes
+ */
+struct next_power_of_two {
+  static constexpr std::size_t next_capacity(std::size_t capacity,
+                                             std::size_t required) {
+    const std::size_t target = capacity < required ? required : capacity + 1;
+
+    std::size_t result = 1;
+    while (result < target) {
+      // Overflow, the largest power of two isn't large enough
+      if (result > (static_cast<std::size_t>(-1) >> 1)) {
+        return target;
+      }
+      result <<= 1;
+    }
+    return result;
+  }
+};
+
+/// Growth policy used by base_vector, if none is given
+using default_policy = factor_2;
+
+} // namespace growth
+} // namespace mem
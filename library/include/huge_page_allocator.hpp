@@ -0,0 +1,224 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+#include <sys/mman.h>
+
+#include "mmap_allocator.hpp"
+
+namespace mem {
+namespace detail {
+
+/// Size of a transparent huge page, 2 MiB if the kernel doesn't tell
+inline std::size_t huge_page_size() {
+  static const std::size_t size = [] {
+    std::size_t bytes = 0;
+    std::ifstream("/sys/kernel/mm/transparent_hugepage/hpage_pmd_size") >>
+        bytes;
+    return bytes > 0 ? bytes : std::size_t(2 * 1024 * 1024);
+  }();
+  return size;
+}
+
+/// Round bytes up to a multiple of the huge page size
+inline std::size_t round_to_huge_pages(std::size_t bytes) {
+  const std::size_t page = huge_page_size();
+  return (bytes + page - 1) / page * page;
+}
+
+/// Map bytes (a multiple of the huge page size) of anonymous memory, aligned
+/// to the huge page size. Returns nullptr on failure
+inline void *map_huge_page_aligned(std::size_t bytes) {
+  const std::size_t alignment = huge_page_size();
+
+  // Map an extra huge page and unmap the unaligned head and tail, mmap only
+  // guarantees page alignment
+  void *p = ::mmap(nullptr, bytes + alignment, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (p == MAP_FAILED) {
+    return nullptr;
+  }
+
+  const auto address = reinterpret_cast<std::uintptr_t>(p);
+  const std::size_t head = (alignment - address % alignment) % alignment;
+  const std::size_t tail = alignment - head;
+
+  if (head > 0) {
+    ::munmap(p, head);
+  }
+  if (tail > 0) {
+    ::munmap(static_cast<char *>(p) + head + bytes, tail);
+  }
+
+  return static_cast<char *>(p) + head;
+}
+
+/// Fault in all pages of the mapping, so later accesses don't page fault
+inline void populate(void *p, std::size_t bytes) {
+#ifdef MADV_POPULATE_WRITE
+  if (::madvise(p, bytes, MADV_POPULATE_WRITE) == 0) {
+    return;
+  }
+#endif
+  // Older kernels: touch one byte per page
+  auto *bytes_p = static_cast<volatile char *>(p);
+  for (std::size_t i = 0; i < bytes; i += page_size()) {
+    bytes_p[i] = 0;
+  }
+}
+
+} // namespace detail
+
+/**
+ * @brief Linux allocator for very large buffers, which are backed by
+ * transparent huge pages.
+ *
+ * Blocks of at least MapThreshold bytes are mapped directly with mmap, aligned
+ * to and rounded up to the huge page size (usually 2 MiB), and the kernel is
+ * asked to back them with huge pages (madvise(MADV_HUGEPAGE)). This reduces
+ * TLB misses and the number of page faults by a factor of 512 compared to
+ * 4 KiB pages. If transparent huge pages are disabled, the blocks are backed
+ * by regular pages. Smaller blocks are served by std::allocator.
+ *
+ * With Populate, all pages are faulted in on allocation, which moves the cost
+ * of page faults out of the first pass over the data.
+ *
+ * Rounding to huge pages leaves room to grow, so try_expand succeeds as long
+ * as the new size fits into the mapping, or the mapping can be extended in
+ * place.
+ *
+ * @tparam T type of the allocated elements
+ * @tparam MapThreshold minimum block size in bytes, which is mapped with mmap
+ * @tparam Populate pre-fault all pages of mapped blocks
+ */
+template <class T, std::size_t MapThreshold = 2 * 1024 * 1024,
+          bool Populate = false>
+class huge_page_allocator {
+public:
+  using value_type = T;
+
+  using pointer = T *;
+  using const_pointer = const T *;
+
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+
+  using is_always_equal = std::true_type;
+  using propagate_on_container_move_assignment = std::true_type;
+
+  template <class U> struct rebind {
+    using other = huge_page_allocator<U, MapThreshold, Populate>;
+  };
+
+  static constexpr std::size_t map_threshold = MapThreshold;
+
+  static constexpr bool populate = Populate;
+
+  huge_page_allocator() noexcept = default;
+
+  template <class U>
+  huge_page_allocator(
+      const huge_page_allocator<U, MapThreshold, Populate> &) noexcept {}
+
+  pointer allocate(size_type n);
+
+  void deallocate(pointer p, size_type n) noexcept;
+
+  /// Grow the block at p from old_n to new_n elements, without moving it
+  bool try_expand(pointer p, size_type old_n, size_type new_n) noexcept;
+
+private:
+  /// Blocks of that many elements are mapped
+  static bool is_mapped(size_type n) { return n * sizeof(T) >= MapThreshold; }
+
+  /// Largest number of elements, which can be rounded to huge pages
+  static size_type max_elements() {
+    return (static_cast<size_type>(-1) - detail::huge_page_size()) / sizeof(T);
+  }
+};
+
+template <class T, std::size_t MapThreshold, bool Populate>
+typename huge_page_allocator<T, MapThreshold, Populate>::pointer
+huge_page_allocator<T, MapThreshold, Populate>::allocate(size_type n) {
+  if (n > max_elements()) {
+    throw std::bad_array_new_length();
+  }
+
+  if (!is_mapped(n)) {
+    return std::allocator<T>().allocate(n);
+  }
+
+  const std::size_t bytes = detail::round_to_huge_pages(n * sizeof(T));
+
+  void *p = detail::map_huge_page_aligned(bytes);
+  if (!p) {
+    throw std::bad_alloc();
+  }
+
+  // Only a hint, fails if transparent huge pages aren't supported
+  ::madvise(p, bytes, MADV_HUGEPAGE);
+
+  if (Populate) {
+    detail::populate(p, bytes);
+  }
+
+  return static_cast<pointer>(p);
+}
+
+template <class T, std::size_t MapThreshold, bool Populate>
+void huge_page_allocator<T, MapThreshold, Populate>::deallocate(
+    pointer p, size_type n) noexcept {
+  if (!is_mapped(n)) {
+    std::allocator<T>().deallocate(p, n);
+  } else {
+    ::munmap(static_cast<void *>(p),
+             detail::round_to_huge_pages(n * sizeof(T)));
+  }
+}
+
+template <class T, std::size_t MapThreshold, bool Populate>
+bool huge_page_allocator<T, MapThreshold, Populate>::try_expand(
+    pointer p, size_type old_n, size_type new_n) noexcept {
+  if (!is_mapped(old_n) || new_n > max_elements()) {
+    return false;
+  }
+
+  const std::size_t old_bytes = detail::round_to_huge_pages(old_n * sizeof(T));
+  const std::size_t new_bytes = detail::round_to_huge_pages(new_n * sizeof(T));
+
+  if (new_bytes <= old_bytes) {
+    // Still fits into the mapping
+    return true;
+  }
+
+  // The extension inherits the huge page advice of the mapping
+  void *result = ::mremap(static_cast<void *>(p), old_bytes, new_bytes, 0);
+  if (result == MAP_FAILED) {
+    return false;
+  }
+
+  if (Populate) {
+    detail::populate(static_cast<char *>(result) + old_bytes,
+                     new_bytes - old_bytes);
+  }
+  return true;
+}
+
+template <class T, class U, std::size_t MapThreshold, bool Populate>
+bool operator==(const huge_page_allocator<T, MapThreshold, Populate> &,
+                const huge_page_allocator<U, MapThreshold, Populate> &) {
+  return true;
+}
+
+template <class T, class U, std::size_t MapThreshold, bool Populate>
+bool operator!=(const huge_page_allocator<T, MapThreshold, Populate> &,
+                const huge_page_allocator<U, MapThreshold, Populate> &) {
+  return false;
+}
+
+} // namespace mem
@@ -0,0 +1,656 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "contiguous_storage.hpp"
+#include "growth_policy.hpp"
+#include "segment_iterator.hpp"
+
+namespace mem {
+
+/**
+ * @brief Vector, which never relocates all of its elements in one call.
+ *
+ * When it runs out of space, a new buffer is allocated as given by the growth
+ * policy, but the elements stay in the old buffer. Each following modifying
+ * call (push_back, emplace_back, pop_back, resize) migrates a bounded number of
+ * them to the new buffer, and operator[] reads an element from the buffer it
+ * currently lives in. The number of elements migrated per call is chosen on
+ * growth, such that the migration is finished, before the new buffer is full
+ * (one element per call for factor_2, two for factor_1_5). So the latency of
+ * push_back doesn't depend on the size of the vector, but both buffers are
+ * alive during migration, and indexing costs a compare.
+ *
+ * As elements move between buffers, any modifying call invalidates iterators
+ * and references. data() finishes the migration, so the elements are
+ * contiguous afterwards, until the next growth.
+ *
+ * @tparam T type of the stored elements
+ * @tparam Alloc allocator used to acquire the buffers
+ * @tparam GrowthPolicy policy computing the new capacity, if the vector runs
+ * out of space (see growth_policy.hpp)
+ */
+template <class T, class Alloc = std::allocator<T>,
+          class GrowthPolicy = growth::default_policy>
+class incremental_vector {
+private:
+  using storage_type = detail::contiguous_storage<T, Alloc>;
+  using alloc_traits = std::allocator_traits<Alloc>;
+
+public:
+  using value_type = T;
+
+  using reference = T &;
+  using const_reference = const T &;
+
+  using pointer = T *;
+  using const_pointer = const T *;
+
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+
+  using allocator_type = Alloc;
+
+  using growth_policy = GrowthPolicy;
+
+  using iterator = iter::segment_iterator<incremental_vector, T>;
+  using const_iterator =
+      iter::segment_iterator<const incremental_vector, const T>;
+
+private:
+  /// Buffer, which holds all elements, once the migration is finished
+  storage_type storage_;
+
+  /// Buffer before the last growth, empty if no migration is pending
+  storage_type old_;
+
+  size_type size_;
+
+  /// Elements [pending_begin_, pending_end_) still live in old_, all others in
+  /// storage_. Both are 0, if no migration is pending
+  size_type pending_begin_;
+  size_type pending_end_;
+
+  /// Number of elements migrated per modifying call
+  size_type step_;
+
+public:
+  /// create empty vector
+  incremental_vector();
+
+  /// create empty vector with given allocator
+  explicit incremental_vector(const Alloc &alloc);
+
+  /// create vector of size n, with value initialized values
+  explicit incremental_vector(size_type n, const Alloc &alloc = Alloc());
+
+  /// create vector of size n, with copies of value
+  incremental_vector(size_type n, const value_type &value,
+                     const Alloc &alloc = Alloc());
+
+  incremental_vector(std::initializer_list<value_type> values,
+                     const Alloc &alloc = Alloc());
+
+  /// Copy constructor, the copy holds all elements in a single buffer
+  incremental_vector(const incremental_vector &v);
+
+  /// Move constructor takes over both buffers, including a pending migration
+  incremental_vector(incremental_vector &&v);
+
+  incremental_vector &operator=(const incremental_vector &v);
+
+  /// Takes over the buffers of v, if the allocator propagates or compares
+  /// equal, otherwise the elements are moved one by one
+  incremental_vector &operator=(incremental_vector &&v);
+
+  ~incremental_vector();
+
+  /// Shrink or grow to new_size, new elements are value initialized
+  void resize(size_type new_size);
+
+  /// Shrink or grow to new_size, new elements will have the given value
+  void resize(size_type new_size, const value_type &value);
+
+  /// Append a copy of value, O(1) worst case apart from the allocation
+  void push_back(const value_type &value);
+
+  /// Append value by moving it, O(1) worst case apart from the allocation
+  void push_back(value_type &&value);
+
+  /// Append an element constructed in place from args, O(1) worst case apart
+  /// from the allocation
+  template <class... Args> reference emplace_back(Args &&...args);
+
+  /// Remove the last element, the vector must not be empty
+  void pop_back();
+
+  size_type size() const;
+
+  size_type max_size() const;
+
+  /// Number of elements, which fit into the (new) buffer
+  size_type capacity() const;
+
+  /// Allocate a buffer for at least new_capacity elements, the elements are
+  /// migrated to it incrementally. Throws std::length_error, if new_capacity
+  /// is larger than max_size()
+  void reserve(size_type new_capacity);
+
+  bool empty() const;
+
+  /// Destroy all elements, the capacity is left unchanged
+  void clear();
+
+  /// Swap the buffers of this vector with the ones of v
+  void swap(incremental_vector &v);
+
+  reference operator[](size_type idx);
+
+  const_reference operator[](size_type idx) const;
+
+  reference front();
+
+  const_reference front() const;
+
+  reference back();
+
+  const_reference back() const;
+
+  iterator begin();
+
+  const_iterator begin() const;
+
+  const_iterator cbegin() const;
+
+  iterator end();
+
+  const_iterator end() const;
+
+  const_iterator cend() const;
+
+  /// Finish the migration and return the buffer, which then holds all
+  /// elements contiguously. This relocates up to size() elements at once
+  pointer data();
+
+  allocator_type get_allocator() const;
+
+  /// true, if some elements still live in the buffer before the last growth
+  bool migrating() const;
+
+  /// Migrate all remaining elements at once, e.g. outside a latency critical
+  /// section
+  void finish_migration();
+
+private:
+  /// Migrate up to n of the remaining elements, the old buffer is freed once
+  /// all are migrated. If relocating throws, the elements stay where they are
+  void migrate(size_type n);
+
+  /// Allocate a buffer for new_capacity elements and construct n elements at
+  /// size() in it with construct(pos, n), before the migration starts. Such
+  /// arguments may refer to elements of this vector
+  template <typename Constructor>
+  void grow(size_type new_capacity, size_type n, Constructor construct);
+
+  /// Append n elements constructed by construct(pos, n), grows the buffer
+  /// using the growth policy if necessary
+  template <typename Constructor>
+  void append(size_type n, Constructor construct);
+
+  /// Capacity to grow to, such that at least required elements fit, as given
+  /// by the growth policy
+  size_type next_capacity(size_type required) const;
+
+  /// Destroy the elements from index n on
+  void shrink_to(size_type n);
+
+  /// Destroy all elements and free both buffers
+  void deallocate();
+};
+
+template <class T, class Alloc, class GrowthPolicy>
+incremental_vector<T, Alloc, GrowthPolicy>::incremental_vector()
+    : incremental_vector(Alloc()) {}
+
+template <class T, class Alloc, class GrowthPolicy>
+incremental_vector<T, Alloc, GrowthPolicy>::incremental_vector(
+    const Alloc &alloc)
+    : storage_(alloc), old_(alloc), size_(0), pending_begin_(0),
+      pending_end_(0), step_(1) {}
+
+template <class T, class Alloc, class GrowthPolicy>
+incremental_vector<T, Alloc, GrowthPolicy>::incremental_vector(
+    size_type n, const Alloc &alloc)
+    : incremental_vector(alloc) {
+  resize(n);
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+incremental_vector<T, Alloc, GrowthPolicy>::incremental_vector(
+    size_type n, const value_type &value, const Alloc &alloc)
+    : incremental_vector(alloc) {
+  resize(n, value);
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+incremental_vector<T, Alloc, GrowthPolicy>::incremental_vector(
+    std::initializer_list<value_type> values, const Alloc &alloc)
+    : incremental_vector(alloc) {
+  append(values.size(),
+         [this, &values](typename storage_type::iterator pos, size_type) {
+           storage_.uninitialized_copy(values.begin(), values.end(), pos);
+         });
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+incremental_vector<T, Alloc, GrowthPolicy>::incremental_vector(
+    const incremental_vector &v)
+    : incremental_vector(alloc_traits::select_on_container_copy_construction(
+          v.get_allocator())) {
+  append(v.size(),
+         [this, &v](typename storage_type::iterator pos, size_type) {
+           storage_.uninitialized_copy(v.begin(), v.end(), pos);
+         });
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+incremental_vector<T, Alloc, GrowthPolicy>::incremental_vector(
+    incremental_vector &&v)
+    : incremental_vector(v.get_allocator()) {
+  storage_.swap(v.storage_);
+  old_.swap(v.old_);
+  std::swap(size_, v.size_);
+  std::swap(pending_begin_, v.pending_begin_);
+  std::swap(pending_end_, v.pending_end_);
+  std::swap(step_, v.step_);
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+incremental_vector<T, Alloc, GrowthPolicy> &
+incremental_vector<T, Alloc, GrowthPolicy>::operator=(
+    const incremental_vector &v) {
+  if (this == &v) {
+    return *this;
+  }
+
+  clear();
+  if (alloc_traits::propagate_on_container_copy_assignment::value &&
+      storage_.is_allocator_not_equal(v.storage_)) {
+    // The buffers have to be freed by the allocator, which allocated them
+    deallocate();
+  }
+  storage_.propagate_allocator(v.storage_);
+  old_.propagate_allocator(v.old_);
+
+  append(v.size(),
+         [this, &v](typename storage_type::iterator pos, size_type) {
+           storage_.uninitialized_copy(v.begin(), v.end(), pos);
+         });
+  return *this;
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+incremental_vector<T, Alloc, GrowthPolicy> &
+incremental_vector<T, Alloc, GrowthPolicy>::operator=(incremental_vector &&v) {
+  if (this == &v) {
+    return *this;
+  }
+
+  if (alloc_traits::propagate_on_container_move_assignment::value ||
+      !storage_.is_allocator_not_equal(v.storage_)) {
+    deallocate();
+    storage_ = std::move(v.storage_);
+    old_ = std::move(v.old_);
+    size_ = std::exchange(v.size_, 0);
+    pending_begin_ = std::exchange(v.pending_begin_, 0);
+    pending_end_ = std::exchange(v.pending_end_, 0);
+    step_ = v.step_;
+  } else {
+    clear();
+    append(v.size(),
+           [this, &v](typename storage_type::iterator pos, size_type) {
+             storage_.uninitialized_copy(std::make_move_iterator(v.begin()),
+                                         std::make_move_iterator(v.end()),
+                                         pos);
+           });
+  }
+  return *this;
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+incremental_vector<T, Alloc, GrowthPolicy>::~incremental_vector() {
+  deallocate();
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+void incremental_vector<T, Alloc, GrowthPolicy>::resize(size_type new_size) {
+  if (new_size < size_) {
+    shrink_to(new_size);
+  } else {
+    append(new_size - size_,
+           [this](typename storage_type::iterator pos, size_type n) {
+             storage_.value_construct_n(pos, n);
+           });
+  }
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+void incremental_vector<T, Alloc, GrowthPolicy>::resize(
+    size_type new_size, const value_type &value) {
+  if (new_size < size_) {
+    shrink_to(new_size);
+  } else {
+    append(new_size - size_,
+           [this, &value](typename storage_type::iterator pos, size_type n) {
+             storage_.uninitialized_fill_n(pos, n, value);
+           });
+  }
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+void incremental_vector<T, Alloc, GrowthPolicy>::push_back(
+    const value_type &value) {
+  emplace_back(value);
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+void incremental_vector<T, Alloc, GrowthPolicy>::push_back(value_type &&value) {
+  emplace_back(std::move(value));
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+template <class... Args>
+typename incremental_vector<T, Alloc, GrowthPolicy>::reference
+incremental_vector<T, Alloc, GrowthPolicy>::emplace_back(Args &&...args) {
+  append(1, [this, &args...](typename storage_type::iterator pos, size_type) {
+    storage_.construct(pos, std::forward<Args>(args)...);
+  });
+  return storage_[size_ - 1];
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+void incremental_vector<T, Alloc, GrowthPolicy>::pop_back() {
+  shrink_to(size_ - 1);
+  migrate(step_);
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+typename incremental_vector<T, Alloc, GrowthPolicy>::size_type
+incremental_vector<T, Alloc, GrowthPolicy>::size() const {
+  return size_;
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+typename incremental_vector<T, Alloc, GrowthPolicy>::size_type
+incremental_vector<T, Alloc, GrowthPolicy>::max_size() const {
+  return storage_.max_size();
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+typename incremental_vector<T, Alloc, GrowthPolicy>::size_type
+incremental_vector<T, Alloc, GrowthPolicy>::capacity() const {
+  return storage_.size();
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+void incremental_vector<T, Alloc, GrowthPolicy>::reserve(
+    size_type new_capacity) {
+  if (new_capacity > max_size()) {
+    throw std::length_error("incremental_vector::reserve: requested capacity "
+                            "exceeds max_size()");
+  }
+
+  if (new_capacity > capacity()) {
+    grow(new_capacity, 0, [](typename storage_type::iterator, size_type) {});
+  }
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+bool incremental_vector<T, Alloc, GrowthPolicy>::empty() const {
+  return size_ == 0;
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+void incremental_vector<T, Alloc, GrowthPolicy>::clear() {
+  shrink_to(0);
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+void incremental_vector<T, Alloc, GrowthPolicy>::swap(incremental_vector &v) {
+  using std::swap;
+
+  // Throws before anything is changed, if the allocators can't be swapped
+  storage_.swap(v.storage_);
+  old_.swap(v.old_);
+  swap(size_, v.size_);
+  swap(pending_begin_, v.pending_begin_);
+  swap(pending_end_, v.pending_end_);
+  swap(step_, v.step_);
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+typename incremental_vector<T, Alloc, GrowthPolicy>::reference
+incremental_vector<T, Alloc, GrowthPolicy>::operator[](size_type idx) {
+  // A single unsigned compare, as pending_begin_ <= pending_end_
+  return idx - pending_begin_ < pending_end_ - pending_begin_ ? old_[idx]
+                                                              : storage_[idx];
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+typename incremental_vector<T, Alloc, GrowthPolicy>::const_reference
+incremental_vector<T, Alloc, GrowthPolicy>::operator[](size_type idx) const {
+  return idx - pending_begin_ < pending_end_ - pending_begin_ ? old_[idx]
+                                                              : storage_[idx];
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+typename incremental_vector<T, Alloc, GrowthPolicy>::reference
+incremental_vector<T, Alloc, GrowthPolicy>::front() {
+  return (*this)[0];
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+typename incremental_vector<T, Alloc, GrowthPolicy>::const_reference
+incremental_vector<T, Alloc, GrowthPolicy>::front() const {
+  return (*this)[0];
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+typename incremental_vector<T, Alloc, GrowthPolicy>::reference
+incremental_vector<T, Alloc, GrowthPolicy>::back() {
+  return (*this)[size_ - 1];
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+typename incremental_vector<T, Alloc, GrowthPolicy>::const_reference
+incremental_vector<T, Alloc, GrowthPolicy>::back() const {
+  return (*this)[size_ - 1];
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+typename incremental_vector<T, Alloc, GrowthPolicy>::iterator
+incremental_vector<T, Alloc, GrowthPolicy>::begin() {
+  return iterator(this, 0);
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+typename incremental_vector<T, Alloc, GrowthPolicy>::const_iterator
+incremental_vector<T, Alloc, GrowthPolicy>::begin() const {
+  return const_iterator(this, 0);
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+typename incremental_vector<T, Alloc, GrowthPolicy>::const_iterator
+incremental_vector<T, Alloc, GrowthPolicy>::cbegin() const {
+  return begin();
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+typename incremental_vector<T, Alloc, GrowthPolicy>::iterator
+incremental_vector<T, Alloc, GrowthPolicy>::end() {
+  return iterator(this, size_);
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+typename incremental_vector<T, Alloc, GrowthPolicy>::const_iterator
+incremental_vector<T, Alloc, GrowthPolicy>::end() const {
+  return const_iterator(this, size_);
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+typename incremental_vector<T, Alloc, GrowthPolicy>::const_iterator
+incremental_vector<T, Alloc, GrowthPolicy>::cend() const {
+  return end();
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+typename incremental_vector<T, Alloc, GrowthPolicy>::pointer
+incremental_vector<T, Alloc, GrowthPolicy>::data() {
+  finish_migration();
+  return storage_.data();
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+typename incremental_vector<T, Alloc, GrowthPolicy>::allocator_type
+incremental_vector<T, Alloc, GrowthPolicy>::get_allocator() const {
+  return storage_.get_allocator();
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+bool incremental_vector<T, Alloc, GrowthPolicy>::migrating() const {
+  return old_.size() > 0;
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+void incremental_vector<T, Alloc, GrowthPolicy>::finish_migration() {
+  migrate(pending_end_ - pending_begin_);
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+void incremental_vector<T, Alloc, GrowthPolicy>::migrate(size_type n) {
+  if (!migrating()) {
+    return;
+  }
+
+  const size_type count = std::min(n, pending_end_ - pending_begin_);
+  storage_.relocate(old_.begin() + pending_begin_,
+                    old_.begin() + (pending_begin_ + count),
+                    storage_.begin() + pending_begin_);
+  pending_begin_ += count;
+
+  if (pending_begin_ == pending_end_) {
+    old_.deallocate();
+    pending_begin_ = 0;
+    pending_end_ = 0;
+  }
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+template <typename Constructor>
+void incremental_vector<T, Alloc, GrowthPolicy>::grow(size_type new_capacity,
+                                                      size_type n,
+                                                      Constructor construct) {
+  storage_type new_storage(detail::copy_allocator_t{}, storage_, new_capacity);
+
+  // The new elements may be constructed from elements of the vector (e.g.
+  // push_back(v[i])), so before finishing the migration moves them
+  construct(new_storage.begin() + size_, n);
+
+  // Only one migration at a time, the step size makes sure, this is a no-op
+  // when growing by push_back
+  try {
+    finish_migration();
+  } catch (...) {
+    new_storage.destroy(new_storage.begin() + size_,
+                        new_storage.begin() + (size_ + n));
+    throw;
+  }
+
+  // The elements stay in the old buffer, until they are migrated
+  old_.swap(new_storage);
+  storage_.swap(old_);
+  pending_begin_ = 0;
+  pending_end_ = size_;
+  size_ += n;
+
+  // Migrate the old elements, before the appends fill the spare capacity. The
+  // call growing the buffer migrates as well
+  const size_type calls = new_capacity - size_ + 1;
+  step_ = std::max<size_type>((pending_end_ + calls - 1) / calls, 1);
+
+  if (pending_end_ == 0) {
+    old_.deallocate();
+  }
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+template <typename Constructor>
+void incremental_vector<T, Alloc, GrowthPolicy>::append(size_type n,
+                                                        Constructor construct) {
+  if (n > capacity() - size_) {
+    grow(next_capacity(size_ + n), n, construct);
+  } else {
+    construct(storage_.begin() + size_, n);
+    size_ += n;
+  }
+
+  // step_ elements per appended one, so appending many at once can't leave
+  // the migration behind
+  const size_type pending = pending_end_ - pending_begin_;
+  migrate(n > pending / step_ ? pending : n * step_);
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+typename incremental_vector<T, Alloc, GrowthPolicy>::size_type
+incremental_vector<T, Alloc, GrowthPolicy>::next_capacity(
+    size_type required) const {
+  if (required > max_size() || required < size_) {
+    throw std::length_error("incremental_vector: required capacity exceeds "
+                            "max_size()");
+  }
+
+  const size_type new_capacity =
+      static_cast<size_type>(GrowthPolicy::next_capacity(capacity(), required));
+
+  return std::min(std::max(new_capacity, required), max_size());
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+void incremental_vector<T, Alloc, GrowthPolicy>::shrink_to(size_type n) {
+  if (n >= size_) {
+    return;
+  }
+
+  // Elements at and after pending_end_ are in the new buffer
+  const size_type tail_begin = std::max(n, pending_end_);
+  storage_.destroy(storage_.begin() + tail_begin, storage_.begin() + size_);
+
+  if (n < pending_end_) {
+    // Elements before pending_begin_ are migrated already
+    const size_type old_begin = std::max(n, pending_begin_);
+    old_.destroy(old_.begin() + old_begin, old_.begin() + pending_end_);
+    storage_.destroy(storage_.begin() + n, storage_.begin() + old_begin);
+    pending_end_ = old_begin;
+
+    if (pending_begin_ == pending_end_) {
+      old_.deallocate();
+      pending_begin_ = 0;
+      pending_end_ = 0;
+    }
+  }
+  size_ = n;
+}
+
+template <class T, class Alloc, class GrowthPolicy>
+void incremental_vector<T, Alloc, GrowthPolicy>::deallocate() {
+  clear();
+  storage_.deallocate();
+}
+
+} // namespace mem
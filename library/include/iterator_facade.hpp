@@ -38,10 +38,10 @@ public:
     return self();
   }
 
-  self_type &operator++(int) {
+  self_type operator++(int) {
     auto copy = self();
-    return copy;
     ++(*this);
+    return copy;
   }
 
   // TODO: make this optional for non bidirectional iterators
@@ -52,14 +52,14 @@ public:
   }
 
   // TODO: make this optional for non bidirectional iterators
-  self_type &operator--(int) {
+  self_type operator--(int) {
     auto copy = self();
     --(*this);
-    return self();
+    return copy;
   }
 
   // Access
-  decltype(auto) operator[](difference_type n) { return *(self() + n); }
+  decltype(auto) operator[](difference_type n) const { return *(self() + n); }
 
   // advance
   friend self_type &operator+=(self_type &self, difference_type n) {
@@ -80,9 +80,8 @@ public:
     return lhs + (-n);
   }
 
-  friend self_type operator-=(self_type lhs, difference_type n) {
-    lhs = lhs - n;
-    return lhs;
+  friend self_type &operator-=(self_type &lhs, difference_type n) {
+    return lhs += -n;
   }
 
   friend difference_type operator-(const self_type &lhs, const self_type &rhs) {
@@ -99,7 +98,7 @@ public:
   }
 
   friend bool operator<(const self_type &lhs, const self_type &rhs) {
-    return lhs.distance_to(rhs) < 0;
+    return lhs.distance_to(rhs) > 0;
   }
 
   friend bool operator>(const self_type &lhs, const self_type &rhs) {
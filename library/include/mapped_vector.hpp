@@ -0,0 +1,517 @@
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "base_vector.hpp"
+#include "fmt/core.h"
+#include "mmap_allocator.hpp"
+
+namespace mem {
+
+/// How mapped_vector opens its file
+enum class map_mode {
+  /// Open an existing file, changes are never written to it (copy on write),
+  /// and the vector can't grow beyond its initial size
+  read_only,
+
+  /// Open an existing file, changes are written to it
+  read_write,
+
+  /// Create a new, empty file, or truncate an existing one
+  create,
+};
+
+/// Thrown, if a file can't be opened as mapped_vector, e.g. because it was
+/// written with a different element type
+class mapped_file_error : public std::runtime_error {
+public:
+  using std::runtime_error::runtime_error;
+};
+
+namespace detail {
+
+/// Header at the start of a mapped_vector file, the elements follow it
+struct mapped_file_header {
+  static constexpr char magic_value[8] = {'m', 'e', 'm', 'v',
+                                          'e', 'c', '\0', '\0'};
+  static constexpr std::uint32_t current_version = 1;
+
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t element_size;
+  std::uint32_t element_alignment;
+  std::uint32_t reserved;
+  std::uint64_t count;
+  unsigned char padding[32];
+};
+
+static_assert(sizeof(mapped_file_header) == 64,
+              "mapped_file_header has to keep its layout");
+
+/// Address space reserved for a file, which may grow
+inline constexpr std::size_t default_max_mapped_bytes =
+    sizeof(void *) >= 8 ? std::size_t(1) << 40 : std::size_t(1) << 30;
+
+/**
+ * @brief A file mapped at the start of a reserved address range, such that it
+ * can grow (see grow) without moving.
+ */
+class mapped_file {
+public:
+  mapped_file(const std::string &path, map_mode mode,
+              std::size_t element_size, std::size_t element_alignment,
+              std::size_t max_bytes);
+
+  /// Truncates a writable file to the elements given by the header count
+  ~mapped_file();
+
+  mapped_file(const mapped_file &) = delete;
+  mapped_file &operator=(const mapped_file &) = delete;
+
+  mapped_file_header &header();
+
+  /// Start of the elements, right after the header
+  void *data();
+
+  /// Bytes available for elements, without growing the file
+  std::size_t capacity_bytes() const;
+
+  /// Maximum bytes available for elements, i.e. the reserved address space
+  std::size_t max_capacity_bytes() const;
+
+  /// Grow the file to hold bytes of elements, and map the new part in place.
+  /// Returns false for read only files, if the reserved address space is
+  /// exhausted, or the file system refused
+  bool grow(std::size_t bytes) noexcept;
+
+  /// Write all changes to the file (msync)
+  void flush();
+
+  bool writable() const;
+
+  /// Hand out the elements, there is only one block at a time
+  void *acquire(std::size_t bytes);
+
+  void release() noexcept;
+
+private:
+  int fd_;
+  void *base_;
+  std::size_t reserved_bytes_;
+  std::size_t file_bytes_;
+  bool writable_;
+  bool acquired_;
+
+  /// Map [0, bytes) of the file at base_
+  bool map(std::size_t bytes) noexcept;
+
+  void validate(std::size_t element_size, std::size_t element_alignment,
+                const std::string &path);
+
+  [[noreturn]] void fail(const std::string &what);
+};
+
+inline mapped_file::mapped_file(const std::string &path, map_mode mode,
+                                std::size_t element_size,
+                                std::size_t element_alignment,
+                                std::size_t max_bytes)
+    : fd_(-1), base_(nullptr), reserved_bytes_(0), file_bytes_(0),
+      writable_(mode != map_mode::read_only), acquired_(false) {
+  const int flags = mode == map_mode::read_only ? O_RDONLY
+                    : mode == map_mode::read_write
+                        ? O_RDWR
+                        : O_RDWR | O_CREAT | O_TRUNC;
+
+  fd_ = ::open(path.c_str(), flags | O_CLOEXEC, 0644);
+  if (fd_ < 0) {
+    fail(fmt::format("mapped_vector: can't open {}", path));
+  }
+
+  if (mode == map_mode::create) {
+    if (::ftruncate(fd_, sizeof(mapped_file_header)) != 0) {
+      fail(fmt::format("mapped_vector: can't write {}", path));
+    }
+  }
+
+  struct stat status;
+  if (::fstat(fd_, &status) != 0) {
+    fail(fmt::format("mapped_vector: can't stat {}", path));
+  }
+  file_bytes_ = static_cast<std::size_t>(status.st_size);
+
+  if (file_bytes_ < sizeof(mapped_file_header)) {
+    ::close(fd_);
+    throw mapped_file_error(
+        fmt::format("mapped_vector: {} is too small for a header", path));
+  }
+
+  // Read only files never grow, so only their size is reserved
+  reserved_bytes_ = round_to_pages(
+      writable_ ? sizeof(mapped_file_header) + max_bytes : file_bytes_);
+  reserved_bytes_ = std::max(reserved_bytes_, round_to_pages(file_bytes_));
+
+  base_ = ::mmap(nullptr, reserved_bytes_, PROT_NONE,
+                 MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  if (base_ == MAP_FAILED) {
+    base_ = nullptr;
+    fail(fmt::format("mapped_vector: can't reserve address space for {}",
+                     path));
+  }
+
+  if (!map(file_bytes_)) {
+    fail(fmt::format("mapped_vector: can't map {}", path));
+  }
+
+  if (mode == map_mode::create) {
+    mapped_file_header &h = header();
+    std::memcpy(h.magic, mapped_file_header::magic_value, sizeof(h.magic));
+    h.version = mapped_file_header::current_version;
+    h.element_size = static_cast<std::uint32_t>(element_size);
+    h.element_alignment = static_cast<std::uint32_t>(element_alignment);
+    h.count = 0;
+  }
+
+  try {
+    validate(element_size, element_alignment, path);
+  } catch (...) {
+    ::munmap(base_, reserved_bytes_);
+    ::close(fd_);
+    throw;
+  }
+}
+
+inline mapped_file::~mapped_file() {
+  if (writable_) {
+    // Drop the unused capacity
+    const auto bytes = sizeof(mapped_file_header) +
+                       header().count * header().element_size;
+    ::munmap(base_, reserved_bytes_);
+    [[maybe_unused]] const int result =
+        ::ftruncate(fd_, static_cast<off_t>(bytes));
+  } else {
+    ::munmap(base_, reserved_bytes_);
+  }
+  ::close(fd_);
+}
+
+inline mapped_file_header &mapped_file::header() {
+  return *static_cast<mapped_file_header *>(base_);
+}
+
+inline void *mapped_file::data() {
+  return static_cast<char *>(base_) + sizeof(mapped_file_header);
+}
+
+inline std::size_t mapped_file::capacity_bytes() const {
+  return file_bytes_ - sizeof(mapped_file_header);
+}
+
+inline std::size_t mapped_file::max_capacity_bytes() const {
+  return reserved_bytes_ - sizeof(mapped_file_header);
+}
+
+inline bool mapped_file::grow(std::size_t bytes) noexcept {
+  const std::size_t new_file_bytes = sizeof(mapped_file_header) + bytes;
+
+  if (new_file_bytes <= file_bytes_) {
+    return true;
+  }
+  if (!writable_ || new_file_bytes > reserved_bytes_) {
+    return false;
+  }
+
+  if (::ftruncate(fd_, static_cast<off_t>(new_file_bytes)) != 0) {
+    return false;
+  }
+
+  // Mapping the file again over the old mapping only adds page table entries
+  // for the new part, the pages in the page cache stay where they are
+  if (!map(new_file_bytes)) {
+    [[maybe_unused]] const int result =
+        ::ftruncate(fd_, static_cast<off_t>(file_bytes_));
+    return false;
+  }
+
+  file_bytes_ = new_file_bytes;
+  return true;
+}
+
+inline void mapped_file::flush() {
+  if (writable_ &&
+      ::msync(base_, round_to_pages(file_bytes_), MS_SYNC) != 0) {
+    throw std::system_error(errno, std::generic_category(),
+                            "mapped_vector: msync failed");
+  }
+}
+
+inline bool mapped_file::writable() const { return writable_; }
+
+inline void *mapped_file::acquire(std::size_t bytes) {
+  // A second block would need a second copy of the file
+  if (acquired_ || !grow(bytes)) {
+    throw std::bad_alloc();
+  }
+  acquired_ = true;
+  return data();
+}
+
+inline void mapped_file::release() noexcept { acquired_ = false; }
+
+inline bool mapped_file::map(std::size_t bytes) noexcept {
+  // Read only files are mapped copy on write, so the elements can still be
+  // changed in memory
+  const int protection = PROT_READ | PROT_WRITE;
+  const int flags = (writable_ ? MAP_SHARED : MAP_PRIVATE) | MAP_FIXED;
+
+  return ::mmap(base_, round_to_pages(bytes), protection, flags, fd_, 0) !=
+         MAP_FAILED;
+}
+
+inline void mapped_file::validate(std::size_t element_size,
+                                  std::size_t element_alignment,
+                                  const std::string &path) {
+  const mapped_file_header &h = header();
+
+  if (std::memcmp(h.magic, mapped_file_header::magic_value,
+                  sizeof(h.magic)) != 0) {
+    throw mapped_file_error(
+        fmt::format("mapped_vector: {} isn't a mapped_vector file", path));
+  }
+  if (h.version != mapped_file_header::current_version) {
+    throw mapped_file_error(
+        fmt::format("mapped_vector: {} has version {}, {} expected", path,
+                    h.version, mapped_file_header::current_version));
+  }
+  if (h.element_size != element_size ||
+      h.element_alignment != element_alignment) {
+    throw mapped_file_error(fmt::format(
+        "mapped_vector: {} stores elements of size {} and alignment {}, "
+        "size {} and alignment {} expected",
+        path, h.element_size, h.element_alignment, element_size,
+        element_alignment));
+  }
+  if (h.count > capacity_bytes() / element_size) {
+    throw mapped_file_error(
+        fmt::format("mapped_vector: {} is truncated, {} elements expected",
+                    path, h.count));
+  }
+}
+
+inline void mapped_file::fail(const std::string &what) {
+  const int error = errno;
+  if (base_ != nullptr) {
+    ::munmap(base_, reserved_bytes_);
+  }
+  if (fd_ >= 0) {
+    ::close(fd_);
+  }
+  throw std::system_error(error, std::generic_category(), what);
+}
+
+} // namespace detail
+
+/**
+ * @brief Allocator handing out the element area of a mapped file (see
+ * mapped_vector). There is only one block per file, it grows in place with
+ * try_expand, up to max_size().
+ */
+template <class T> class mapped_file_allocator {
+public:
+  using value_type = T;
+
+  using pointer = T *;
+  using const_pointer = const T *;
+
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+
+  using is_always_equal = std::false_type;
+  using propagate_on_container_copy_assignment = std::false_type;
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+
+  template <class U> struct rebind {
+    using other = mapped_file_allocator<U>;
+  };
+
+  explicit mapped_file_allocator(std::shared_ptr<detail::mapped_file> file)
+      : file_(std::move(file)) {}
+
+  template <class U>
+  mapped_file_allocator(const mapped_file_allocator<U> &other) noexcept
+      : file_(other.file()) {}
+
+  pointer allocate(size_type n);
+
+  void deallocate(pointer p, size_type n) noexcept;
+
+  /// Grow the file from old_n to new_n elements, the block doesn't move
+  bool try_expand(pointer p, size_type old_n, size_type new_n) noexcept;
+
+  size_type max_size() const noexcept;
+
+  const std::shared_ptr<detail::mapped_file> &file() const { return file_; }
+
+private:
+  std::shared_ptr<detail::mapped_file> file_;
+};
+
+template <class T>
+typename mapped_file_allocator<T>::pointer
+mapped_file_allocator<T>::allocate(size_type n) {
+  if (n > max_size()) {
+    throw std::bad_array_new_length();
+  }
+  return static_cast<pointer>(file_->acquire(n * sizeof(T)));
+}
+
+template <class T>
+void mapped_file_allocator<T>::deallocate(pointer, size_type) noexcept {
+  file_->release();
+}
+
+template <class T>
+bool mapped_file_allocator<T>::try_expand(pointer, size_type,
+                                          size_type new_n) noexcept {
+  return new_n <= max_size() && file_->grow(new_n * sizeof(T));
+}
+
+template <class T>
+typename mapped_file_allocator<T>::size_type
+mapped_file_allocator<T>::max_size() const noexcept {
+  return file_->max_capacity_bytes() / sizeof(T);
+}
+
+template <class T, class U>
+bool operator==(const mapped_file_allocator<T> &a,
+                const mapped_file_allocator<U> &b) {
+  return a.file() == b.file();
+}
+
+template <class T, class U>
+bool operator!=(const mapped_file_allocator<T> &a,
+                const mapped_file_allocator<U> &b) {
+  return !(a == b);
+}
+
+/**
+ * @brief base_vector, whose elements live in a memory mapped file.
+ *
+ * Opening a file is O(1), the elements are paged in on first access. The file
+ * starts with a header (magic, version, element size and alignment, count),
+ * so opening a file written with another element type fails with
+ * mapped_file_error.
+ *
+ * The vector grows the file with ftruncate and maps the new part in place, so
+ * elements never move. The address space for max_bytes of elements is
+ * reserved when opening. flush writes the size to the header and syncs the
+ * file, the destructor writes the size and drops the unused capacity.
+ *
+ * @tparam T type of the stored elements, has to be trivially copyable
+ * @tparam GrowthPolicy policy computing the new capacity (see
+ * growth_policy.hpp)
+ */
+template <class T, class GrowthPolicy = growth::default_policy>
+class mapped_vector
+    : public base_vector<T, mapped_file_allocator<T>, GrowthPolicy> {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "mapped_vector stores the bytes of the elements in a file");
+  static_assert(alignof(T) <= sizeof(detail::mapped_file_header),
+                "mapped_vector aligns elements to at most the header size");
+
+  using base_type = base_vector<T, mapped_file_allocator<T>, GrowthPolicy>;
+  using storage_type = typename base_type::storage_type;
+
+public:
+  using size_type = typename base_type::size_type;
+
+  /// Open the file at path, see map_mode. The address space for max_bytes of
+  /// elements is reserved for growing
+  mapped_vector(const std::string &path, map_mode mode,
+                std::size_t max_bytes = detail::default_max_mapped_bytes);
+
+  mapped_vector(const mapped_vector &) = delete;
+
+  mapped_vector(mapped_vector &&v);
+
+  mapped_vector &operator=(const mapped_vector &) = delete;
+
+  mapped_vector &operator=(mapped_vector &&) = delete;
+
+  /// Writes the size to the file
+  ~mapped_vector();
+
+  /// Write the size to the header, and all changes to the file (msync)
+  void flush();
+
+  /// false, if opened with map_mode::read_only
+  bool writable() const;
+
+private:
+  std::shared_ptr<detail::mapped_file> file_;
+
+  void write_count();
+};
+
+template <class T, class GrowthPolicy>
+mapped_vector<T, GrowthPolicy>::mapped_vector(const std::string &path,
+                                              map_mode mode,
+                                              std::size_t max_bytes)
+    : base_type(mapped_file_allocator<T>(std::make_shared<detail::mapped_file>(
+          path, mode, sizeof(T), alignof(T), max_bytes))) {
+  file_ = this->get_allocator().file();
+
+  // Take over the elements in the file, without touching them
+  const auto count = static_cast<size_type>(file_->header().count);
+  if (count > 0) {
+    this->storage_ = storage_type(count, this->get_allocator());
+    this->size_ = count;
+  }
+}
+
+template <class T, class GrowthPolicy>
+mapped_vector<T, GrowthPolicy>::mapped_vector(mapped_vector &&v)
+    : base_type(std::move(v)), file_(std::move(v.file_)) {}
+
+template <class T, class GrowthPolicy>
+mapped_vector<T, GrowthPolicy>::~mapped_vector() {
+  write_count();
+}
+
+template <class T, class GrowthPolicy>
+void mapped_vector<T, GrowthPolicy>::flush() {
+  write_count();
+  if (file_) {
+    file_->flush();
+  }
+}
+
+template <class T, class GrowthPolicy>
+bool mapped_vector<T, GrowthPolicy>::writable() const {
+  return file_ && file_->writable();
+}
+
+template <class T, class GrowthPolicy>
+void mapped_vector<T, GrowthPolicy>::write_count() {
+  // A moved from vector doesn't own the file anymore
+  if (writable()) {
+    file_->header().count = this->size();
+  }
+}
+
+} // namespace mem
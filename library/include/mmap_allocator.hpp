@@ -0,0 +1,166 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace mem {
+namespace detail {
+
+/// Size of a memory page
+inline std::size_t page_size() {
+  static const std::size_t size =
+      static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+  return size;
+}
+
+/// Round bytes up to a multiple of the page size
+inline std::size_t round_to_pages(std::size_t bytes) {
+  const std::size_t page = page_size();
+  return (bytes + page - 1) / page * page;
+}
+
+} // namespace detail
+
+/**
+ * @brief Linux allocator, which maps large blocks directly with mmap, and can
+ * grow them with mremap.
+ *
+ * Blocks of at least MapThreshold bytes are mapped as anonymous memory, smaller
+ * ones are served by std::allocator. The allocator implements the extensions
+ * used by contiguous_storage to grow a buffer without copying it:
+ * - try_expand grows a mapped block in place, either because the requested
+ *   size still fits into its last page, or by mremap without moving it
+ * - try_reallocate lets mremap move the block, which only updates page tables
+ *   instead of copying the bytes, and never needs old and new block at once
+ *
+ * @tparam T type of the allocated elements
+ * @tparam MapThreshold minimum block size in bytes, which is mapped with mmap
+ */
+template <class T, std::size_t MapThreshold = 128 * 1024>
+class mmap_allocator {
+public:
+  using value_type = T;
+
+  using pointer = T *;
+  using const_pointer = const T *;
+
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+
+  using is_always_equal = std::true_type;
+  using propagate_on_container_move_assignment = std::true_type;
+
+  template <class U> struct rebind {
+    using other = mmap_allocator<U, MapThreshold>;
+  };
+
+  static constexpr std::size_t map_threshold = MapThreshold;
+
+  mmap_allocator() noexcept = default;
+
+  template <class U>
+  mmap_allocator(const mmap_allocator<U, MapThreshold> &) noexcept {}
+
+  pointer allocate(size_type n);
+
+  void deallocate(pointer p, size_type n) noexcept;
+
+  /// Grow the block at p from old_n to new_n elements, without moving it
+  bool try_expand(pointer p, size_type old_n, size_type new_n) noexcept;
+
+  /// Grow the block at p from old_n to new_n elements, possibly moving it.
+  /// Returns nullptr, if the block isn't mapped or mremap failed
+  pointer try_reallocate(pointer p, size_type old_n, size_type new_n) noexcept;
+
+private:
+  /// Blocks of that many elements are mapped
+  static bool is_mapped(size_type n) { return n * sizeof(T) >= MapThreshold; }
+};
+
+template <class T, std::size_t MapThreshold>
+typename mmap_allocator<T, MapThreshold>::pointer
+mmap_allocator<T, MapThreshold>::allocate(size_type n) {
+  if (n > static_cast<size_type>(-1) / sizeof(T)) {
+    throw std::bad_array_new_length();
+  }
+
+  if (!is_mapped(n)) {
+    return std::allocator<T>().allocate(n);
+  }
+
+  void *p = ::mmap(nullptr, detail::round_to_pages(n * sizeof(T)),
+                   PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+  if (p == MAP_FAILED) {
+    throw std::bad_alloc();
+  }
+  return static_cast<pointer>(p);
+}
+
+template <class T, std::size_t MapThreshold>
+void mmap_allocator<T, MapThreshold>::deallocate(pointer p,
+                                                 size_type n) noexcept {
+  if (!is_mapped(n)) {
+    std::allocator<T>().deallocate(p, n);
+  } else {
+    ::munmap(static_cast<void *>(p), detail::round_to_pages(n * sizeof(T)));
+  }
+}
+
+template <class T, std::size_t MapThreshold>
+bool mmap_allocator<T, MapThreshold>::try_expand(pointer p, size_type old_n,
+                                                 size_type new_n) noexcept {
+  if (!is_mapped(old_n) || new_n > static_cast<size_type>(-1) / sizeof(T)) {
+    return false;
+  }
+
+  const std::size_t old_bytes = detail::round_to_pages(old_n * sizeof(T));
+  const std::size_t new_bytes = detail::round_to_pages(new_n * sizeof(T));
+
+  if (new_bytes <= old_bytes) {
+    // Still fits into the mapped pages
+    return true;
+  }
+
+  void *result = ::mremap(static_cast<void *>(p), old_bytes, new_bytes, 0);
+  return result != MAP_FAILED;
+}
+
+template <class T, std::size_t MapThreshold>
+typename mmap_allocator<T, MapThreshold>::pointer
+mmap_allocator<T, MapThreshold>::try_reallocate(pointer p, size_type old_n,
+                                                size_type new_n) noexcept {
+  if (!is_mapped(old_n) || new_n > static_cast<size_type>(-1) / sizeof(T)) {
+    return nullptr;
+  }
+
+  const std::size_t old_bytes = detail::round_to_pages(old_n * sizeof(T));
+  const std::size_t new_bytes = detail::round_to_pages(new_n * sizeof(T));
+
+  void *result =
+      ::mremap(static_cast<void *>(p), old_bytes, new_bytes, MREMAP_MAYMOVE);
+
+  if (result == MAP_FAILED) {
+    return nullptr;
+  }
+  return static_cast<pointer>(result);
+}
+
+template <class T, class U, std::size_t MapThreshold>
+bool operator==(const mmap_allocator<T, MapThreshold> &,
+                const mmap_allocator<U, MapThreshold> &) {
+  return true;
+}
+
+template <class T, class U, std::size_t MapThreshold>
+bool operator!=(const mmap_allocator<T, MapThreshold> &,
+                const mmap_allocator<U, MapThreshold> &) {
+  return false;
+}
+
+} // namespace mem
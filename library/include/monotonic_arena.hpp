@@ -0,0 +1,228 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <new>
+
+#include "resource_allocator.hpp"
+
+namespace mem {
+
+/**
+ * @brief Memory resource, which hands out memory by bumping a pointer through
+ * a list of blocks, and releases everything at once.
+ *
+ * Deallocation is a no-op, the memory is only released by release() or on
+ * destruction. This makes it a good fit for short lived scratch containers
+ * (e.g. per request), which are all thrown away together. The most recent
+ * allocation can be expanded in place (see try_expand), which lets a single
+ * growing base_vector avoid copies.
+ *
+ * It's a std::pmr::memory_resource, so it can be used with
+ * std::pmr::polymorphic_allocator as well as with arena_allocator, which
+ * avoids the virtual dispatch. It isn't thread safe.
+ */
+class monotonic_arena final : public std::pmr::memory_resource {
+private:
+  /// Header in front of each block allocated from upstream
+  struct block_header {
+    block_header *next;
+    std::size_t size;
+  };
+
+  std::pmr::memory_resource *upstream_;
+
+  /// Blocks allocated from upstream, most recent first
+  block_header *blocks_;
+
+  /// Optional buffer given by the user, used before any block is allocated
+  char *initial_buffer_;
+  std::size_t initial_size_;
+
+  /// Free part of the current block
+  char *current_;
+  char *end_;
+
+  /// Start of the most recent allocation, which can be expanded in place
+  void *last_allocation_;
+
+  std::size_t initial_block_size_;
+  std::size_t next_block_size_;
+
+  std::size_t bytes_allocated_;
+
+public:
+  /// Arena allocating blocks from upstream, starting with initial_block_size
+  /// bytes, each further block is twice as large
+  explicit monotonic_arena(
+      std::size_t initial_block_size = 4096,
+      std::pmr::memory_resource *upstream = std::pmr::get_default_resource());
+
+  /// Arena using the given buffer first (e.g. on the stack), only if that is
+  /// exhausted blocks are allocated from upstream
+  monotonic_arena(
+      void *buffer, std::size_t size,
+      std::pmr::memory_resource *upstream = std::pmr::get_default_resource());
+
+  monotonic_arena(const monotonic_arena &) = delete;
+
+  monotonic_arena &operator=(const monotonic_arena &) = delete;
+
+  ~monotonic_arena() override;
+
+  /// Grow the allocation at p from old_bytes to new_bytes. Only succeeds, if
+  /// it's the most recent allocation and the current block has enough space.
+  /// The allocation is already aligned, so alignment isn't needed
+  bool try_expand(void *p, std::size_t old_bytes, std::size_t new_bytes,
+                  std::size_t alignment = alignof(std::max_align_t)) noexcept;
+
+  /// Release all memory allocated from upstream, and start over. All memory
+  /// handed out so far becomes invalid
+  void release() noexcept;
+
+  /// Number of bytes handed out since construction or the last release()
+  std::size_t bytes_allocated() const noexcept;
+
+  std::pmr::memory_resource *upstream_resource() const noexcept;
+
+protected:
+  void *do_allocate(std::size_t bytes, std::size_t alignment) override;
+
+  void do_deallocate(void *p, std::size_t bytes,
+                     std::size_t alignment) override;
+
+  bool do_is_equal(const std::pmr::memory_resource &other) const
+      noexcept override;
+
+private:
+  /// Allocate a new block from upstream, which can hold at least bytes with
+  /// the given alignment
+  void allocate_block(std::size_t bytes, std::size_t alignment);
+};
+
+/// Allocator bump allocating from a monotonic_arena
+template <class T>
+using arena_allocator = resource_allocator<T, monotonic_arena>;
+
+inline monotonic_arena::monotonic_arena(std::size_t initial_block_size,
+                                        std::pmr::memory_resource *upstream)
+    : upstream_(upstream), blocks_(nullptr), initial_buffer_(nullptr),
+      initial_size_(0), current_(nullptr), end_(nullptr),
+      last_allocation_(nullptr),
+      initial_block_size_(initial_block_size > 0 ? initial_block_size : 1),
+      next_block_size_(initial_block_size_), bytes_allocated_(0) {}
+
+inline monotonic_arena::monotonic_arena(void *buffer, std::size_t size,
+                                        std::pmr::memory_resource *upstream)
+    : upstream_(upstream), blocks_(nullptr),
+      initial_buffer_(static_cast<char *>(buffer)), initial_size_(size),
+      current_(initial_buffer_), end_(initial_buffer_ + size),
+      last_allocation_(nullptr),
+      initial_block_size_(size > 0 ? size : 4096),
+      next_block_size_(initial_block_size_), bytes_allocated_(0) {}
+
+inline monotonic_arena::~monotonic_arena() { release(); }
+
+inline bool monotonic_arena::try_expand(void *p, std::size_t old_bytes,
+                                        std::size_t new_bytes,
+                                        std::size_t) noexcept {
+  char *block = static_cast<char *>(p);
+
+  if (p == nullptr || p != last_allocation_ || block + old_bytes != current_ ||
+      new_bytes < old_bytes ||
+      new_bytes - old_bytes > static_cast<std::size_t>(end_ - current_)) {
+    return false;
+  }
+
+  current_ = block + new_bytes;
+  bytes_allocated_ += new_bytes - old_bytes;
+  return true;
+}
+
+inline void monotonic_arena::release() noexcept {
+  while (blocks_) {
+    block_header *next = blocks_->next;
+    upstream_->deallocate(blocks_, sizeof(block_header) + blocks_->size,
+                          alignof(std::max_align_t));
+    blocks_ = next;
+  }
+
+  current_ = initial_buffer_;
+  end_ = initial_buffer_ ? initial_buffer_ + initial_size_ : nullptr;
+  last_allocation_ = nullptr;
+  next_block_size_ = initial_block_size_;
+  bytes_allocated_ = 0;
+}
+
+inline std::size_t monotonic_arena::bytes_allocated() const noexcept {
+  return bytes_allocated_;
+}
+
+inline std::pmr::memory_resource *
+monotonic_arena::upstream_resource() const noexcept {
+  return upstream_;
+}
+
+inline void *monotonic_arena::do_allocate(std::size_t bytes,
+                                          std::size_t alignment) {
+  // Every allocation needs a unique address
+  if (bytes == 0) {
+    bytes = 1;
+  }
+
+  void *p = current_;
+  std::size_t space = static_cast<std::size_t>(end_ - current_);
+
+  if (!current_ || !std::align(alignment, bytes, p, space)) {
+    allocate_block(bytes, alignment);
+
+    p = current_;
+    space = static_cast<std::size_t>(end_ - current_);
+    std::align(alignment, bytes, p, space);
+  }
+
+  current_ = static_cast<char *>(p) + bytes;
+  last_allocation_ = p;
+  bytes_allocated_ += bytes;
+
+  return p;
+}
+
+inline void monotonic_arena::do_deallocate(void *, std::size_t, std::size_t) {}
+
+inline bool monotonic_arena::do_is_equal(
+    const std::pmr::memory_resource &other) const noexcept {
+  return this == &other;
+}
+
+inline void monotonic_arena::allocate_block(std::size_t bytes,
+                                            std::size_t alignment) {
+  // Sizes beyond this would overflow, when adding the header or doubling
+  constexpr std::size_t max_size =
+      std::numeric_limits<std::size_t>::max() - sizeof(block_header);
+  if (bytes > max_size - alignment) {
+    throw std::bad_alloc();
+  }
+  // Make sure the allocation fits, even if the block has to be aligned
+  std::size_t size = next_block_size_;
+  while (size < bytes + alignment) {
+    if (size > max_size / 2) {
+      throw std::bad_alloc();
+    }
+    size *= 2;
+  }
+
+  void *memory = upstream_->allocate(sizeof(block_header) + size,
+                                     alignof(std::max_align_t));
+
+  auto *block = ::new (memory) block_header{blocks_, size};
+  blocks_ = block;
+
+  current_ = reinterpret_cast<char *>(block + 1);
+  end_ = current_ + size;
+  next_block_size_ = size > max_size / 2 ? max_size : size * 2;
+}
+
+} // namespace mem
@@ -2,11 +2,17 @@
 
 #include "iterator_facade.hpp"
 
+#include <cstddef>
 #include <iterator>
+#include <memory>
+#include <type_traits>
 
 namespace mem {
 namespace iter {
 
+/// Random access iterator over a contiguous buffer, which wraps a pointer.
+/// With C++20 it models std::contiguous_iterator, so std::to_address and the
+/// ranges algorithms see the pointer
 template <class T>
 struct normal_iterator
     : iterator_facade<normal_iterator<T>, T, std::random_access_iterator_tag> {
@@ -16,7 +22,11 @@ private:
 
 public:
   using value_type = typename super_t::value_type;
+  using element_type = T;
   using iterator_category = typename super_t::iterator_category;
+#if defined(__cpp_lib_concepts)
+  using iterator_concept = std::contiguous_iterator_tag;
+#endif
 
   using reference = typename super_t::reference;
   using const_reference = typename super_t::const_reference;
@@ -30,12 +40,16 @@ private:
   pointer cur_;
 
 public:
+  normal_iterator() : cur_(nullptr) {}
+
   normal_iterator(pointer cur) : cur_(cur) {}
 
   pointer base() { return cur_; }
 
   const_pointer base() const { return cur_; }
 
+  pointer operator->() const { return cur_; }
+
   const_reference dereference() const { return *cur_; }
 
   reference dereference() { return *cur_; }
@@ -47,7 +61,7 @@ public:
   void advance(difference_type n) { cur_ += n; }
 
   difference_type distance_to(const normal_iterator &other) const {
-    return cur_ - other.cur_;
+    return other.cur_ - cur_;
   }
 
   bool equal_to(const normal_iterator &other) const {
@@ -55,6 +69,58 @@ public:
   }
 };
 } // namespace iter
+
+namespace detail {
+
+/// true, if the elements Iterator refers to are contiguous in memory, so it
+/// can be replaced by a pointer (see unwrap_iterator). With C++20 this holds
+/// for every std::contiguous_iterator (e.g. of std::vector), otherwise for
+/// pointers and normal_iterators
+#if defined(__cpp_lib_concepts)
+template <class Iterator>
+struct is_contiguous_iterator
+    : std::bool_constant<std::contiguous_iterator<Iterator>> {};
+#else
+template <class Iterator>
+struct is_contiguous_iterator : std::is_pointer<Iterator> {};
+
+template <class T>
+struct is_contiguous_iterator<iter::normal_iterator<T>> : std::true_type {};
+#endif
+
+template <class T> T *to_address(T *p) { return p; }
+
+/// Pointer to the element a contiguous iterator refers to, without
+/// dereferencing it, i.e. it may be an end iterator
+template <class Iterator> auto to_address(const Iterator &it) {
+#if defined(__cpp_lib_to_address)
+  return std::to_address(it);
+#else
+  return std::pointer_traits<Iterator>::to_address(it);
+#endif
+}
+
+/// Underlying pointer of a contiguous iterator (e.g. normal_iterator), other
+/// iterators are returned as they are. The standard algorithms only take
+/// their memmove, memset and vectorized paths for pointers, so internal
+/// algorithms unwrap their iterators first
+template <class Iterator> auto unwrap_iterator(Iterator it) {
+  if constexpr (is_contiguous_iterator<Iterator>::value) {
+    return detail::to_address(it);
+  } else {
+    return it;
+  }
+}
+
+/// Iterator of the same type as original, which refers to the same element as
+/// unwrapped, the result of an algorithm run on unwrap_iterator(original)
+template <class Iterator, class Unwrapped>
+Iterator rewrap_iterator(Iterator original, Unwrapped unwrapped) {
+  return std::next(original,
+                   std::distance(unwrap_iterator(original), unwrapped));
+}
+
+} // namespace detail
 } // namespace mem
 
 template <typename T>
@@ -62,7 +128,24 @@ struct std::iterator_traits<::mem::iter::normal_iterator<T>> {
   using self = ::mem::iter::normal_iterator<T>;
   using pointer = typename self::pointer;
   using iterator_category = typename self::iterator_category;
+#if defined(__cpp_lib_concepts)
+  using iterator_concept = typename self::iterator_concept;
+#endif
   using value_type = typename self::value_type;
   using difference_type = typename self::difference_type;
   using reference = typename self::reference;
 };
+
+/// Makes std::to_address work on normal_iterators, also with C++17
+template <typename T>
+struct std::pointer_traits<::mem::iter::normal_iterator<T>> {
+  using pointer = ::mem::iter::normal_iterator<T>;
+  using element_type = T;
+  using difference_type = std::ptrdiff_t;
+
+  template <class U> using rebind = ::mem::iter::normal_iterator<U>;
+
+  static element_type *to_address(const pointer &it) noexcept {
+    return it.base();
+  }
+};
@@ -0,0 +1,283 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <memory>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "mmap_allocator.hpp"
+
+namespace mem {
+namespace numa {
+
+/// NUMA nodes, which are online. A single node 0, if the kernel doesn't tell
+inline const std::vector<int> &online_nodes() {
+  static const std::vector<int> nodes = [] {
+    // Format is a list of ranges, e.g. "0-1,4"
+    std::vector<int> result;
+    std::string list;
+    std::ifstream("/sys/devices/system/node/online") >> list;
+
+    std::size_t pos = 0;
+    while (pos < list.size()) {
+      std::size_t end = list.find(',', pos);
+      if (end == std::string::npos) {
+        end = list.size();
+      }
+      const std::string range = list.substr(pos, end - pos);
+      const std::size_t dash = range.find('-');
+
+      try {
+        const int first = std::stoi(range.substr(0, dash));
+        const int last = dash == std::string::npos
+                             ? first
+                             : std::stoi(range.substr(dash + 1));
+        for (int node = first; node <= last; ++node) {
+          result.push_back(node);
+        }
+      } catch (const std::exception &) {
+        // Malformed entry, ignore it
+      }
+      pos = end + 1;
+    }
+
+    if (result.empty()) {
+      result.push_back(0);
+    }
+    return result;
+  }();
+  return nodes;
+}
+
+/// Number of online NUMA nodes, at least 1
+inline std::size_t node_count() { return online_nodes().size(); }
+
+/**
+ * @brief Node backing each page of [p, p + bytes), -1 for pages which aren't
+ * backed by memory yet (not touched), or if the kernel doesn't tell (e.g.
+ * move_pages isn't permitted).
+ */
+inline std::vector<int> page_nodes(const void *p, std::size_t bytes) {
+  const std::size_t page = detail::page_size();
+  const auto first = reinterpret_cast<std::uintptr_t>(p) / page * page;
+  const auto last = reinterpret_cast<std::uintptr_t>(p) + bytes;
+
+  std::vector<void *> pages;
+  for (std::uintptr_t address = first; address < last; address += page) {
+    pages.push_back(reinterpret_cast<void *>(address));
+  }
+
+  std::vector<int> status(pages.size(), -1);
+  if (pages.empty()) {
+    return status;
+  }
+
+  // With nodes == nullptr, move_pages only queries the node of each page
+  const long result = ::syscall(SYS_move_pages, 0, pages.size(), pages.data(),
+                                nullptr, status.data(), 0);
+
+  if (result != 0) {
+    std::fill(status.begin(), status.end(), -1);
+  }
+  for (auto &node : status) {
+    // Negative values are errors, e.g. -ENOENT for pages not present
+    if (node < 0) {
+      node = -1;
+    }
+  }
+  return status;
+}
+
+/// Node backing each page of the elements [first, last) of a contiguous
+/// container (see page_nodes)
+template <class Container>
+std::vector<int> page_nodes(const Container &c, std::size_t first,
+                            std::size_t last) {
+  using value_type = typename Container::value_type;
+  return page_nodes(c.data() + first, (last - first) * sizeof(value_type));
+}
+
+} // namespace numa
+
+/// Where the pages of a buffer allocated by numa_allocator are placed
+enum class numa_placement {
+  /// On the node of the thread touching them first, which is the default of
+  /// the kernel. Construct in parallel (see parallel_policy) to spread them
+  first_touch,
+
+  /// Round robin on all nodes, page by page
+  interleaved,
+
+  /// Split into one contiguous part per node, part i is placed on the i-th
+  /// node, so threads working on part i should run on that node
+  partitioned,
+};
+
+namespace detail {
+
+// Memory policies of mbind, see <numaif.h>
+constexpr int mpol_preferred = 1;
+constexpr int mpol_interleave = 3;
+
+/// Apply the memory policy mode to [p, p + bytes) for the given nodes. Returns
+/// false, if the kernel refused (e.g. no NUMA support or not permitted)
+inline bool mbind(void *p, std::size_t bytes, int mode,
+                  const std::vector<int> &nodes) {
+  constexpr std::size_t bits = 8 * sizeof(unsigned long);
+
+  int max_node = 0;
+  for (int node : nodes) {
+    max_node = node > max_node ? node : max_node;
+  }
+
+  std::vector<unsigned long> mask(static_cast<std::size_t>(max_node) / bits +
+                                  1);
+  for (int node : nodes) {
+    mask[static_cast<std::size_t>(node) / bits] |=
+        1UL << (static_cast<std::size_t>(node) % bits);
+  }
+
+  // The kernel only reads maxnode - 1 bits of the mask, so one more is passed
+  // (like libnuma does), otherwise the highest bit of the last word is lost
+  return ::syscall(SYS_mbind, p, bytes, mode, mask.data(),
+                   mask.size() * bits + 1, 0) == 0;
+}
+
+/// Set the memory policy for a freshly mapped, untouched block
+inline void apply_placement(void *p, std::size_t bytes,
+                            numa_placement placement) {
+  const auto &nodes = numa::online_nodes();
+
+  // With a single node, there is nothing to place
+  if (placement == numa_placement::first_touch || nodes.size() < 2) {
+    return;
+  }
+
+  if (placement == numa_placement::interleaved) {
+    mbind(p, bytes, mpol_interleave, nodes);
+    return;
+  }
+
+  // Partitioned, each part a multiple of the page size
+  const std::size_t pages = bytes / page_size();
+  for (std::size_t i = 0; i < nodes.size(); ++i) {
+    const std::size_t first = pages * i / nodes.size() * page_size();
+    const std::size_t last = pages * (i + 1) / nodes.size() * page_size();
+    if (last > first) {
+      mbind(static_cast<char *>(p) + first, last - first, mpol_preferred,
+            {nodes[i]});
+    }
+  }
+}
+
+} // namespace detail
+
+/**
+ * @brief Linux allocator placing the pages of large buffers on the NUMA nodes
+ * according to Placement.
+ *
+ * Blocks of at least MapThreshold bytes are mapped with mmap, and their memory
+ * policy is set with mbind before any page is touched. Smaller blocks are
+ * served by std::allocator, and placed by the kernel as usual.
+ *
+ * The placement is only a policy, it degrades gracefully: on a single node
+ * machine, or if mbind isn't permitted (e.g. in a container), the pages are
+ * placed by first touch. numa::page_nodes tells, where the pages actually are.
+ *
+ * @tparam T type of the allocated elements
+ * @tparam Placement placement of the pages on the nodes
+ * @tparam MapThreshold minimum block size in bytes, which is mapped with mmap
+ */
+template <class T, numa_placement Placement = numa_placement::interleaved,
+          std::size_t MapThreshold = 1024 * 1024>
+class numa_allocator {
+public:
+  using value_type = T;
+
+  using pointer = T *;
+  using const_pointer = const T *;
+
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+
+  using is_always_equal = std::true_type;
+  using propagate_on_container_move_assignment = std::true_type;
+
+  template <class U> struct rebind {
+    using other = numa_allocator<U, Placement, MapThreshold>;
+  };
+
+  static constexpr numa_placement placement = Placement;
+
+  static constexpr std::size_t map_threshold = MapThreshold;
+
+  numa_allocator() noexcept = default;
+
+  template <class U>
+  numa_allocator(const numa_allocator<U, Placement, MapThreshold> &) noexcept {}
+
+  pointer allocate(size_type n);
+
+  void deallocate(pointer p, size_type n) noexcept;
+
+private:
+  /// Blocks of that many elements are mapped
+  static bool is_mapped(size_type n) { return n * sizeof(T) >= MapThreshold; }
+};
+
+template <class T, numa_placement Placement, std::size_t MapThreshold>
+typename numa_allocator<T, Placement, MapThreshold>::pointer
+numa_allocator<T, Placement, MapThreshold>::allocate(size_type n) {
+  if (n > static_cast<size_type>(-1) / sizeof(T)) {
+    throw std::bad_array_new_length();
+  }
+
+  if (!is_mapped(n)) {
+    return std::allocator<T>().allocate(n);
+  }
+
+  const std::size_t bytes = detail::round_to_pages(n * sizeof(T));
+  void *p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+  if (p == MAP_FAILED) {
+    throw std::bad_alloc();
+  }
+
+  detail::apply_placement(p, bytes, Placement);
+  return static_cast<pointer>(p);
+}
+
+template <class T, numa_placement Placement, std::size_t MapThreshold>
+void numa_allocator<T, Placement, MapThreshold>::deallocate(
+    pointer p, size_type n) noexcept {
+  if (!is_mapped(n)) {
+    std::allocator<T>().deallocate(p, n);
+  } else {
+    ::munmap(static_cast<void *>(p), detail::round_to_pages(n * sizeof(T)));
+  }
+}
+
+template <class T, class U, numa_placement Placement, std::size_t MapThreshold>
+bool operator==(const numa_allocator<T, Placement, MapThreshold> &,
+                const numa_allocator<U, Placement, MapThreshold> &) {
+  return true;
+}
+
+template <class T, class U, numa_placement Placement, std::size_t MapThreshold>
+bool operator!=(const numa_allocator<T, Placement, MapThreshold> &,
+                const numa_allocator<U, Placement, MapThreshold> &) {
+  return false;
+}
+
+} // namespace mem
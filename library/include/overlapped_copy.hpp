@@ -1,23 +1,47 @@
 #pragma once
 
 #include "fmt/core.h"
+#include "normal_iterator.hpp"
 #include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
 
 namespace mem {
+namespace detail {
+
+/// true, if copying from Source to Target can be done by a single memmove,
+/// i.e. both are pointers to the same trivially copyable type
+template <class Source, class Target>
+struct is_memmove_copyable
+    : std::integral_constant<
+          bool,
+          std::is_pointer_v<Source> && std::is_pointer_v<Target> &&
+              std::is_same_v<
+                  std::remove_cv_t<std::remove_pointer_t<Source>>,
+                  std::remove_cv_t<std::remove_pointer_t<Target>>> &&
+              std::is_trivially_copyable_v<std::remove_pointer_t<Target>> &&
+              !std::is_volatile_v<std::remove_pointer_t<Source>> &&
+              !std::is_volatile_v<std::remove_pointer_t<Target>>> {};
 
-/**
- * @brief Copy range [first, last) to the range [result, result + (last -
- * first)), if the range is overlapping, i.e. result lies in [first, last), this
- * will still yield expected results
- *
- * @param first start of source range
- * @param last end of source range
- * @param result start of result range
- */
 template <typename RandomAccessIterator1, typename RandomAccessIterator2>
-RandomAccessIterator2 overlapped_copy(RandomAccessIterator1 first,
-                                      RandomAccessIterator1 last,
-                                      RandomAccessIterator2 result) {
+RandomAccessIterator2 overlapped_copy_dispatch(RandomAccessIterator1 first,
+                                               RandomAccessIterator1 last,
+                                               RandomAccessIterator2 result,
+                                               std::true_type) {
+  // memmove handles overlapping ranges in both directions
+  const auto n = last - first;
+  if (n > 0) {
+    std::memmove(result, first, static_cast<std::size_t>(n) * sizeof(*first));
+  }
+  return result + n;
+}
+
+template <typename RandomAccessIterator1, typename RandomAccessIterator2>
+RandomAccessIterator2 overlapped_copy_dispatch(RandomAccessIterator1 first,
+                                               RandomAccessIterator1 last,
+                                               RandomAccessIterator2 result,
+                                               std::false_type) {
   if (first < last && first <= result && result < last) {
     // result lies in [first, last)
     // it's safe to use std::copy_backward here
@@ -33,4 +57,35 @@ RandomAccessIterator2 overlapped_copy(RandomAccessIterator1 first,
   return result;
 }
 
+} // namespace detail
+
+/**
+ * @brief Copy range [first, last) to the range [result, result + (last -
+ * first)), if the range is overlapping, i.e. result lies in [first, last), this
+ * will still yield expected results
+ *
+ * Contiguous iterators (e.g. normal_iterator) are unwrapped to pointers (see
+ * detail::unwrap_iterator), so the standard algorithms see raw pointers, and
+ * ranges of trivially copyable types are copied by a single memmove.
+ *
+ * @param first start of source range
+ * @param last end of source range
+ * @param result start of result range
+ */
+template <typename RandomAccessIterator1, typename RandomAccessIterator2>
+RandomAccessIterator2 overlapped_copy(RandomAccessIterator1 first,
+                                      RandomAccessIterator1 last,
+                                      RandomAccessIterator2 result) {
+  auto first_base = detail::unwrap_iterator(first);
+  auto last_base = detail::unwrap_iterator(last);
+  auto result_base = detail::unwrap_iterator(result);
+
+  auto result_end = detail::overlapped_copy_dispatch(
+      first_base, last_base, result_base,
+      detail::is_memmove_copyable<decltype(first_base),
+                                  decltype(result_base)>());
+
+  return detail::rewrap_iterator(result, result_end);
+}
+
 } // namespace mem
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstddef>
+#include <exception>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace mem {
+
+/**
+ * @brief Execution policy to construct the elements of large containers with
+ * several threads, e.g. base_vector(mem::par, n).
+ *
+ * Ranges with fewer than threshold elements are constructed by the calling
+ * thread only, as starting threads costs more than it saves.
+ */
+struct parallel_policy {
+  /// Number of threads, including the calling thread
+  std::size_t threads;
+
+  /// Minimum number of elements to construct in parallel
+  std::size_t threshold;
+
+  explicit parallel_policy(std::size_t threads = default_threads(),
+                           std::size_t threshold = 1 << 16)
+      : threads(threads > 0 ? threads : 1), threshold(threshold) {}
+
+  /// Number of hardware threads, at least 1
+  static std::size_t default_threads() {
+    const unsigned n = std::thread::hardware_concurrency();
+    return n > 0 ? n : 1;
+  }
+};
+
+/// Default parallel policy, using all hardware threads
+inline const parallel_policy par{};
+
+namespace detail {
+
+/**
+ * @brief Split [0, n) into chunks and call construct(begin, end) for each
+ * chunk on its own thread.
+ *
+ * construct has to either construct all elements of its chunk, or throw and
+ * leave none constructed (like the std::uninitialized_* algorithms). If any
+ * chunk throws, destroy(begin, end) is called for all chunks, which were
+ * constructed successfully, and the first exception is rethrown. So either
+ * all n elements are constructed or none.
+ */
+template <class Construct, class Destroy>
+void parallel_chunks(const parallel_policy &policy, std::size_t n,
+                     Construct construct, Destroy destroy) {
+  std::size_t chunks = policy.threads;
+  if (n < policy.threshold || n < chunks) {
+    chunks = 1;
+  }
+
+  if (chunks == 1) {
+    construct(std::size_t(0), n);
+    return;
+  }
+
+  std::vector<std::exception_ptr> errors(chunks);
+
+  auto run_chunk = [&](std::size_t i) {
+    try {
+      construct(i * n / chunks, (i + 1) * n / chunks);
+    } catch (...) {
+      errors[i] = std::current_exception();
+    }
+  };
+
+  {
+    std::vector<std::thread> threads;
+    threads.reserve(chunks - 1);
+
+    for (std::size_t i = 1; i < chunks; ++i) {
+      try {
+        threads.emplace_back(run_chunk, i);
+      } catch (const std::system_error &) {
+        // No more threads available, construct the chunk here
+        run_chunk(i);
+      }
+    }
+
+    run_chunk(0);
+
+    for (auto &thread : threads) {
+      thread.join();
+    }
+  }
+
+  std::exception_ptr first_error;
+  for (const auto &error : errors) {
+    if (error) {
+      first_error = error;
+      break;
+    }
+  }
+
+  if (first_error) {
+    for (std::size_t i = 0; i < chunks; ++i) {
+      if (!errors[i]) {
+        destroy(i * n / chunks, (i + 1) * n / chunks);
+      }
+    }
+    std::rethrow_exception(first_error);
+  }
+}
+
+} // namespace detail
+} // namespace mem
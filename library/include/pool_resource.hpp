@@ -0,0 +1,232 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+
+#include "resource_allocator.hpp"
+
+namespace mem {
+
+/**
+ * @brief Memory resource with a free list for each size class.
+ *
+ * Requests are rounded up to a power of two (at least 8 bytes) and served from
+ * the free list of that size class. Empty free lists are refilled from chunks
+ * allocated from upstream, each chunk twice as large as the previous one of
+ * the same class. Freed blocks are put back to their free list, so memory is
+ * reused by later allocations of the same class. Requests larger than
+ * largest_pooled_size, or aligned stricter than std::max_align_t, are passed
+ * to upstream directly.
+ *
+ * The chunks are only returned to upstream by release() or on destruction.
+ * It isn't thread safe.
+ */
+class pool_resource final : public std::pmr::memory_resource {
+private:
+  /// Header of each chunk allocated from upstream
+  struct alignas(std::max_align_t) chunk_header {
+    chunk_header *next;
+    std::size_t size;
+  };
+
+  /// Node of a free list, stored in the free block itself
+  struct free_block {
+    free_block *next;
+  };
+
+  struct pool {
+    free_block *free_list = nullptr;
+    std::size_t next_chunk_blocks = 0;
+  };
+
+  static constexpr std::size_t smallest_block_size = 8;
+
+  static constexpr std::size_t first_chunk_blocks = 16;
+
+  /// Chunks stop growing, once they reach this size
+  static constexpr std::size_t largest_chunk_size = 1024 * 1024;
+
+  std::pmr::memory_resource *upstream_;
+
+  std::size_t largest_pooled_size_;
+
+  /// One pool for each size class, pools_[i] has blocks of 8 << i bytes
+  std::vector<pool> pools_;
+
+  /// Chunks allocated from upstream, most recent first
+  chunk_header *chunks_;
+
+public:
+  /// Pool resource with size classes up to largest_pooled_size (rounded up to
+  /// a power of two)
+  explicit pool_resource(
+      std::size_t largest_pooled_size = 4096,
+      std::pmr::memory_resource *upstream = std::pmr::get_default_resource());
+
+  pool_resource(const pool_resource &) = delete;
+
+  pool_resource &operator=(const pool_resource &) = delete;
+
+  ~pool_resource() override;
+
+  /// Grow the allocation at p from old_bytes to new_bytes. Only succeeds, if
+  /// it was served from the pools, and both sizes fall into the same size
+  /// class, i.e. the block is large enough
+  bool try_expand(void *p, std::size_t old_bytes, std::size_t new_bytes,
+                  std::size_t alignment = alignof(std::max_align_t)) noexcept;
+
+  /// Return all chunks to upstream. All pooled memory handed out so far
+  /// becomes invalid, allocations passed to upstream aren't affected
+  void release() noexcept;
+
+  /// Largest request served from the pools
+  std::size_t largest_pooled_size() const noexcept;
+
+  std::pmr::memory_resource *upstream_resource() const noexcept;
+
+protected:
+  void *do_allocate(std::size_t bytes, std::size_t alignment) override;
+
+  void do_deallocate(void *p, std::size_t bytes,
+                     std::size_t alignment) override;
+
+  bool do_is_equal(const std::pmr::memory_resource &other) const
+      noexcept override;
+
+private:
+  /// true, if the request is served from the pools
+  bool is_pooled(std::size_t bytes, std::size_t alignment) const noexcept;
+
+  /// Index of the size class for the request
+  static std::size_t pool_index(std::size_t bytes,
+                                std::size_t alignment) noexcept;
+
+  /// Allocate a new chunk for the given pool, and put its blocks on the free
+  /// list
+  void refill(std::size_t index);
+};
+
+/// Allocator serving its allocations from a pool_resource
+template <class T>
+using pool_allocator = resource_allocator<T, pool_resource>;
+
+inline pool_resource::pool_resource(std::size_t largest_pooled_size,
+                                    std::pmr::memory_resource *upstream)
+    : upstream_(upstream), largest_pooled_size_(smallest_block_size),
+      pools_(1), chunks_(nullptr) {
+  while (largest_pooled_size_ < largest_pooled_size) {
+    largest_pooled_size_ *= 2;
+    pools_.emplace_back();
+  }
+}
+
+inline pool_resource::~pool_resource() { release(); }
+
+inline bool pool_resource::try_expand(void *p, std::size_t old_bytes,
+                                      std::size_t new_bytes,
+                                      std::size_t alignment) noexcept {
+  // Over-aligned requests were passed to upstream, whatever their size
+  return p != nullptr && is_pooled(old_bytes, alignment) &&
+         is_pooled(new_bytes, alignment) &&
+         pool_index(old_bytes, alignment) == pool_index(new_bytes, alignment);
+}
+
+inline void pool_resource::release() noexcept {
+  while (chunks_) {
+    chunk_header *next = chunks_->next;
+    upstream_->deallocate(chunks_, chunks_->size, alignof(chunk_header));
+    chunks_ = next;
+  }
+
+  for (auto &p : pools_) {
+    p = pool();
+  }
+}
+
+inline std::size_t pool_resource::largest_pooled_size() const noexcept {
+  return largest_pooled_size_;
+}
+
+inline std::pmr::memory_resource *
+pool_resource::upstream_resource() const noexcept {
+  return upstream_;
+}
+
+inline void *pool_resource::do_allocate(std::size_t bytes,
+                                        std::size_t alignment) {
+  if (!is_pooled(bytes, alignment)) {
+    return upstream_->allocate(bytes, alignment);
+  }
+
+  std::size_t index = pool_index(bytes, alignment);
+  if (!pools_[index].free_list) {
+    refill(index);
+  }
+
+  free_block *block = pools_[index].free_list;
+  pools_[index].free_list = block->next;
+  return block;
+}
+
+inline void pool_resource::do_deallocate(void *p, std::size_t bytes,
+                                         std::size_t alignment) {
+  if (!is_pooled(bytes, alignment)) {
+    upstream_->deallocate(p, bytes, alignment);
+    return;
+  }
+
+  std::size_t index = pool_index(bytes, alignment);
+  pools_[index].free_list = ::new (p) free_block{pools_[index].free_list};
+}
+
+inline bool pool_resource::do_is_equal(
+    const std::pmr::memory_resource &other) const noexcept {
+  return this == &other;
+}
+
+inline bool pool_resource::is_pooled(std::size_t bytes,
+                                     std::size_t alignment) const noexcept {
+  return bytes <= largest_pooled_size_ &&
+         alignment <= alignof(std::max_align_t);
+}
+
+inline std::size_t pool_resource::pool_index(std::size_t bytes,
+                                             std::size_t alignment) noexcept {
+  // A block of size 2^k is aligned to min(2^k, max_align_t)
+  std::size_t size = bytes > alignment ? bytes : alignment;
+
+  std::size_t index = 0;
+  for (std::size_t block_size = smallest_block_size; block_size < size;
+       block_size *= 2) {
+    ++index;
+  }
+  return index;
+}
+
+inline void pool_resource::refill(std::size_t index) {
+  pool &p = pools_[index];
+  const std::size_t block_size = smallest_block_size << index;
+
+  if (p.next_chunk_blocks == 0) {
+    p.next_chunk_blocks = first_chunk_blocks;
+  }
+
+  const std::size_t size =
+      sizeof(chunk_header) + p.next_chunk_blocks * block_size;
+  void *memory = upstream_->allocate(size, alignof(chunk_header));
+
+  chunks_ = ::new (memory) chunk_header{chunks_, size};
+
+  // Link the blocks in address order, so they're handed out sequentially
+  char *first = reinterpret_cast<char *>(chunks_ + 1);
+  for (std::size_t i = p.next_chunk_blocks; i > 0; --i) {
+    p.free_list = ::new (first + (i - 1) * block_size) free_block{p.free_list};
+  }
+
+  if (p.next_chunk_blocks * block_size < largest_chunk_size) {
+    p.next_chunk_blocks *= 2;
+  }
+}
+
+} // namespace mem
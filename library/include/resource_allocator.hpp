@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace mem {
+
+/**
+ * @brief Typed allocator on top of a concrete memory resource (e.g.
+ * monotonic_arena or pool_resource).
+ *
+ * Other than std::pmr::polymorphic_allocator, the resource type is known at
+ * compile time, so allocations aren't dispatched virtually, and the optional
+ * try_expand extension of the resource is forwarded to contiguous_storage.
+ *
+ * Like polymorphic_allocator, it doesn't propagate: a container keeps the
+ * resource it was created with. Two allocators compare equal, if they use the
+ * same resource.
+ *
+ * @tparam T type of the allocated elements
+ * @tparam Resource memory resource, needs to provide allocate(bytes, alignment)
+ * and deallocate(p, bytes, alignment)
+ */
+template <class T, class Resource> class resource_allocator {
+public:
+  using value_type = T;
+
+  using pointer = T *;
+
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+
+  using propagate_on_container_copy_assignment = std::false_type;
+  using propagate_on_container_move_assignment = std::false_type;
+  using propagate_on_container_swap = std::false_type;
+  using is_always_equal = std::false_type;
+
+  using resource_type = Resource;
+
+private:
+  resource_type *resource_;
+
+public:
+  resource_allocator(resource_type &resource) noexcept;
+
+  template <class U>
+  resource_allocator(const resource_allocator<U, Resource> &other) noexcept;
+
+  pointer allocate(size_type n);
+
+  void deallocate(pointer p, size_type n) noexcept;
+
+  /// Forwards to the try_expand extension of the resource, with the alignment
+  /// of T, only available, if the resource provides it
+  template <class R = Resource>
+  auto try_expand(pointer p, size_type old_n, size_type new_n) noexcept
+      -> decltype(std::declval<R &>().try_expand(p, old_n, new_n, alignof(T)));
+
+  /// Copies use the same resource
+  resource_allocator select_on_container_copy_construction() const;
+
+  resource_type *resource() const noexcept;
+};
+
+template <class T, class Resource>
+resource_allocator<T, Resource>::resource_allocator(
+    resource_type &resource) noexcept
+    : resource_(&resource) {}
+
+template <class T, class Resource>
+template <class U>
+resource_allocator<T, Resource>::resource_allocator(
+    const resource_allocator<U, Resource> &other) noexcept
+    : resource_(other.resource()) {}
+
+template <class T, class Resource>
+typename resource_allocator<T, Resource>::pointer
+resource_allocator<T, Resource>::allocate(size_type n) {
+  if (n > static_cast<size_type>(-1) / sizeof(T)) {
+    throw std::bad_array_new_length();
+  }
+  return static_cast<pointer>(resource_->allocate(n * sizeof(T), alignof(T)));
+}
+
+template <class T, class Resource>
+void resource_allocator<T, Resource>::deallocate(pointer p,
+                                                 size_type n) noexcept {
+  resource_->deallocate(p, n * sizeof(T), alignof(T));
+}
+
+template <class T, class Resource>
+template <class R>
+auto resource_allocator<T, Resource>::try_expand(pointer p, size_type old_n,
+                                                 size_type new_n) noexcept
+    -> decltype(std::declval<R &>().try_expand(p, old_n, new_n, alignof(T))) {
+  if (new_n > static_cast<size_type>(-1) / sizeof(T)) {
+    return false;
+  }
+  return resource_->try_expand(p, old_n * sizeof(T), new_n * sizeof(T),
+                               alignof(T));
+}
+
+template <class T, class Resource>
+resource_allocator<T, Resource>
+resource_allocator<T, Resource>::select_on_container_copy_construction()
+    const {
+  return *this;
+}
+
+template <class T, class Resource>
+typename resource_allocator<T, Resource>::resource_type *
+resource_allocator<T, Resource>::resource() const noexcept {
+  return resource_;
+}
+
+template <class T, class U, class Resource>
+bool operator==(const resource_allocator<T, Resource> &lhs,
+                const resource_allocator<U, Resource> &rhs) {
+  return lhs.resource() == rhs.resource();
+}
+
+template <class T, class U, class Resource>
+bool operator!=(const resource_allocator<T, Resource> &lhs,
+                const resource_allocator<U, Resource> &rhs) {
+  return !(lhs == rhs);
+}
+
+} // namespace mem
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+#include "iterator_facade.hpp"
+
+namespace mem {
+namespace iter {
+
+/// Random access iterator over the elements of a segmented container, which
+/// provides operator[] (e.g. concurrent_vector and segmented_vector)
+template <class Container, class Value>
+struct segment_iterator
+    : iterator_facade<segment_iterator<Container, Value>, Value,
+                      std::random_access_iterator_tag> {
+private:
+  using super_t = iterator_facade<segment_iterator<Container, Value>, Value,
+                                  std::random_access_iterator_tag>;
+
+public:
+  using reference = typename super_t::reference;
+  using difference_type = typename super_t::difference_type;
+
+private:
+  Container *container_;
+  std::size_t index_;
+
+public:
+  segment_iterator() : container_(nullptr), index_(0) {}
+
+  segment_iterator(Container *container, std::size_t index)
+      : container_(container), index_(index) {}
+
+  /// Iterator to const from iterator
+  template <class OtherContainer, class OtherValue,
+            typename = std::enable_if_t<
+                std::is_convertible_v<OtherContainer *, Container *>>>
+  segment_iterator(const segment_iterator<OtherContainer, OtherValue> &other)
+      : container_(other.container()), index_(other.index()) {}
+
+  Container *container() const { return container_; }
+
+  std::size_t index() const { return index_; }
+
+  reference dereference() const { return (*container_)[index_]; }
+
+  void increment() { ++index_; }
+
+  void decrement() { --index_; }
+
+  void advance(difference_type n) {
+    index_ = static_cast<std::size_t>(static_cast<difference_type>(index_) +
+                                      n);
+  }
+
+  difference_type distance_to(const segment_iterator &other) const {
+    return static_cast<difference_type>(other.index_) -
+           static_cast<difference_type>(index_);
+  }
+
+  bool equal_to(const segment_iterator &other) const {
+    return index_ == other.index_;
+  }
+};
+
+} // namespace iter
+} // namespace mem
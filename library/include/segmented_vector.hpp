@@ -0,0 +1,693 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "base_vector.hpp"
+#include "contiguous_storage.hpp"
+#include "segment_iterator.hpp"
+
+namespace mem {
+namespace detail {
+
+/// Number of elements of T fitting into 64 KiB, rounded down to a power of
+/// two, at least 1
+template <class T> constexpr std::size_t default_block_size() {
+  std::size_t n = 1;
+  while (n * 2 * sizeof(T) <= 64 * 1024) {
+    n *= 2;
+  }
+  return n;
+}
+
+/// Exponent of the power of two x
+constexpr std::size_t log2_of_power_of_two(std::size_t x) {
+  std::size_t result = 0;
+  while (x > 1) {
+    x >>= 1;
+    ++result;
+  }
+  return result;
+}
+
+} // namespace detail
+
+/**
+ * @brief Vector storing its elements in fixed size blocks (segments), which
+ * are allocated one by one as it grows, and never moved.
+ *
+ * Growing never relocates existing elements, so references to them stay
+ * valid on append, and there is no latency spike nor transient 2x memory peak
+ * when a large vector runs out of capacity. Only the index of the blocks is
+ * reallocated, which holds one pointer per block.
+ *
+ * Indexing is O(1), a shift and a mask, as BlockSize is a power of two. Hot
+ * loops can run on the raw contiguous blocks instead (see for_each_segment).
+ *
+ * @tparam T type of the stored elements
+ * @tparam Alloc allocator of the blocks
+ * @tparam BlockSize number of elements per block, a power of two. Blocks of
+ * about 64 KiB by default
+ */
+template <class T, class Alloc = std::allocator<T>,
+          std::size_t BlockSize = detail::default_block_size<T>()>
+class segmented_vector {
+  static_assert(BlockSize > 0 && (BlockSize & (BlockSize - 1)) == 0,
+                "BlockSize has to be a power of two");
+
+private:
+  using storage_type = detail::contiguous_storage<T, Alloc>;
+  using alloc_traits = std::allocator_traits<Alloc>;
+  using block_allocator = typename alloc_traits::template rebind_alloc<T *>;
+
+public:
+  using value_type = T;
+
+  using reference = T &;
+  using const_reference = const T &;
+
+  using pointer = T *;
+  using const_pointer = const T *;
+
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+
+  using allocator_type = Alloc;
+
+  using iterator = iter::segment_iterator<segmented_vector, T>;
+  using const_iterator =
+      iter::segment_iterator<const segmented_vector, const T>;
+
+  /// Number of elements per block
+  static constexpr size_type block_size = BlockSize;
+
+private:
+  static constexpr size_type block_shift =
+      detail::log2_of_power_of_two(BlockSize);
+  static constexpr size_type block_mask = BlockSize - 1;
+
+  allocator_type allocator_;
+
+  /// Buffers of the blocks, each holding block_size elements. Only this index
+  /// is reallocated when the vector grows, never the elements
+  base_vector<T *, block_allocator> blocks_;
+
+  size_type size_;
+
+  /// Empty storage, only used to construct and destroy elements
+  storage_type constructor_;
+
+public:
+  /// create empty vector
+  segmented_vector();
+
+  /// create empty vector with given allocator
+  explicit segmented_vector(const Alloc &alloc);
+
+  /// create vector of size n, with value initialized values
+  explicit segmented_vector(size_type n, const Alloc &alloc = Alloc());
+
+  /// create vector of size n, with copies of value
+  segmented_vector(size_type n, const value_type &value,
+                   const Alloc &alloc = Alloc());
+
+  segmented_vector(std::initializer_list<value_type> values,
+                   const Alloc &alloc = Alloc());
+
+  /// Copy constructor, the blocks are copied one by one
+  segmented_vector(const segmented_vector &v);
+
+  /// Move constructor takes over the blocks
+  segmented_vector(segmented_vector &&v);
+
+  segmented_vector &operator=(const segmented_vector &v);
+
+  /// Takes over the blocks of v, if the allocator propagates or compares
+  /// equal, otherwise the elements are moved one by one
+  segmented_vector &operator=(segmented_vector &&v);
+
+  ~segmented_vector();
+
+  /// Shrink or grow to new_size, new elements are value initialized
+  void resize(size_type new_size);
+
+  /// Shrink or grow to new_size, new elements will have the given value
+  void resize(size_type new_size, const value_type &value);
+
+  /// Append a copy of value, O(1), existing elements are never moved
+  void push_back(const value_type &value);
+
+  /// Append value by moving it, O(1), existing elements are never moved
+  void push_back(value_type &&value);
+
+  /// Append an element constructed in place from args, O(1)
+  template <class... Args> reference emplace_back(Args &&...args);
+
+  /// Remove the last element, the vector must not be empty
+  void pop_back();
+
+  size_type size() const;
+
+  size_type max_size() const;
+
+  /// Number of elements, which fit into the allocated blocks
+  size_type capacity() const;
+
+  /// Allocate blocks for at least new_capacity elements. Throws
+  /// std::length_error, if new_capacity is larger than max_size()
+  void reserve(size_type new_capacity);
+
+  /// Free the blocks, which hold no elements
+  void shrink_to_fit();
+
+  bool empty() const;
+
+  /// Destroy all elements, the blocks are kept
+  void clear();
+
+  /// Swap the blocks of this vector with the ones of v
+  void swap(segmented_vector &v);
+
+  reference operator[](size_type idx);
+
+  const_reference operator[](size_type idx) const;
+
+  reference front();
+
+  const_reference front() const;
+
+  reference back();
+
+  const_reference back() const;
+
+  iterator begin();
+
+  const_iterator begin() const;
+
+  const_iterator cbegin() const;
+
+  iterator end();
+
+  const_iterator end() const;
+
+  const_iterator cend() const;
+
+  allocator_type get_allocator() const;
+
+  /// Number of blocks holding elements
+  size_type segment_count() const;
+
+  /// First element of block k, k has to be smaller than segment_count()
+  pointer segment_data(size_type k);
+
+  /// First element of block k, k has to be smaller than segment_count()
+  const_pointer segment_data(size_type k) const;
+
+  /// Number of elements in block k, block_size for all but the last one
+  size_type segment_size(size_type k) const;
+
+  /// Call f(first, last) with the pointer range of each block holding
+  /// elements, in order. For hot loops, which vectorize on contiguous ranges
+  template <class Function> void for_each_segment(Function f);
+
+  /// Call f(first, last) with the pointer range of each block holding
+  /// elements, in order. For hot loops, which vectorize on contiguous ranges
+  template <class Function> void for_each_segment(Function f) const;
+
+private:
+  /// Iterator of constructor_ to element idx, its block must be allocated
+  typename storage_type::iterator slot(size_type idx);
+
+  /// Allocate one more block
+  void add_block();
+
+  /// Free all blocks, the vector must be empty
+  void deallocate_blocks();
+
+  /// Grow to n elements, constructing them with construct(pos, count) for
+  /// each contiguous piece. If it throws, the size is left unchanged
+  template <typename Constructor>
+  void grow_to(size_type n, Constructor construct);
+
+  /// Destroy the elements from index n on
+  void shrink_to(size_type n);
+
+  /// Append copies of the elements of v, block by block
+  void append_copy(const segmented_vector &v);
+
+  /// Append the elements of v by moving them, block by block
+  void append_move(segmented_vector &v);
+};
+
+template <class T, class Alloc, std::size_t BlockSize>
+segmented_vector<T, Alloc, BlockSize>::segmented_vector()
+    : segmented_vector(Alloc()) {}
+
+template <class T, class Alloc, std::size_t BlockSize>
+segmented_vector<T, Alloc, BlockSize>::segmented_vector(const Alloc &alloc)
+    : allocator_(alloc), blocks_(block_allocator(alloc)), size_(0),
+      constructor_(alloc) {}
+
+// The constructors below delegate to the one above, so the destructor cleans
+// up, if constructing the elements throws
+
+template <class T, class Alloc, std::size_t BlockSize>
+segmented_vector<T, Alloc, BlockSize>::segmented_vector(size_type n,
+                                                        const Alloc &alloc)
+    : segmented_vector(alloc) {
+  resize(n);
+}
+
+template <class T, class Alloc, std::size_t BlockSize>
+segmented_vector<T, Alloc, BlockSize>::segmented_vector(
+    size_type n, const value_type &value, const Alloc &alloc)
+    : segmented_vector(alloc) {
+  resize(n, value);
+}
+
+template <class T, class Alloc, std::size_t BlockSize>
+segmented_vector<T, Alloc, BlockSize>::segmented_vector(
+    std::initializer_list<value_type> values, const Alloc &alloc)
+    : segmented_vector(alloc) {
+  reserve(values.size());
+  for (const auto &value : values) {
+    push_back(value);
+  }
+}
+
+template <class T, class Alloc, std::size_t BlockSize>
+segmented_vector<T, Alloc, BlockSize>::segmented_vector(
+    const segmented_vector &v)
+    : segmented_vector(
+          alloc_traits::select_on_container_copy_construction(v.allocator_)) {
+  append_copy(v);
+}
+
+template <class T, class Alloc, std::size_t BlockSize>
+segmented_vector<T, Alloc, BlockSize>::segmented_vector(segmented_vector &&v)
+    : allocator_(std::move(v.allocator_)), blocks_(std::move(v.blocks_)),
+      size_(v.size_), constructor_(allocator_) {
+  v.size_ = 0;
+}
+
+template <class T, class Alloc, std::size_t BlockSize>
+segmented_vector<T, Alloc, BlockSize> &
+segmented_vector<T, Alloc, BlockSize>::operator=(const segmented_vector &v) {
+  if (this == &v) {
+    return *this;
+  }
+
+  clear();
+  if (alloc_traits::propagate_on_container_copy_assignment::value &&
+      allocator_ != v.allocator_) {
+    // The blocks have to be freed by the allocator, which allocated them
+    deallocate_blocks();
+    allocator_ = v.allocator_;
+
+    // The index and the element construction use the new allocator as well.
+    // Copy assignment propagates the allocator of the empty index, moving it
+    // would only do so for propagate_on_container_move_assignment
+    const base_vector<T *, block_allocator> empty_blocks{
+        block_allocator(allocator_)};
+    blocks_ = empty_blocks;
+    constructor_.propagate_allocator(v.constructor_);
+  }
+  append_copy(v);
+  return *this;
+}
+
+template <class T, class Alloc, std::size_t BlockSize>
+segmented_vector<T, Alloc, BlockSize> &
+segmented_vector<T, Alloc, BlockSize>::operator=(segmented_vector &&v) {
+  if (this == &v) {
+    return *this;
+  }
+
+  clear();
+  if (alloc_traits::propagate_on_container_move_assignment::value ||
+      allocator_ == v.allocator_) {
+    deallocate_blocks();
+    if (alloc_traits::propagate_on_container_move_assignment::value) {
+      allocator_ = std::move(v.allocator_);
+    }
+    blocks_.swap(v.blocks_);
+    std::swap(size_, v.size_);
+  } else {
+    append_move(v);
+  }
+  return *this;
+}
+
+template <class T, class Alloc, std::size_t BlockSize>
+segmented_vector<T, Alloc, BlockSize>::~segmented_vector() {
+  clear();
+  deallocate_blocks();
+}
+
+template <class T, class Alloc, std::size_t BlockSize>
+void segmented_vector<T, Alloc, BlockSize>::resize(size_type new_size) {
+  if (new_size < size_) {
+    shrink_to(new_size);
+  } else {
+    grow_to(new_size, [this](typename storage_type::iterator pos,
+                             size_type n) {
+      constructor_.value_construct_n(pos, n);
+    });
+  }
+}
+
+template <class T, class Alloc, std::size_t BlockSize>
+void segmented_vector<T, Alloc, BlockSize>::resize(size_type new_size,
+                                                   const value_type &value) {
+  if (new_size < size_) {
+    shrink_to(new_size);
+  } else {
+    grow_to(new_size, [this, &value](typename storage_type::iterator pos,
+                                     size_type n) {
+      constructor_.uninitialized_fill_n(pos, n, value);
+    });
+  }
+}
+
+template <class T, class Alloc, std::size_t BlockSize>
+void segmented_vector<T, Alloc, BlockSize>::push_back(
+    const value_type &value) {
+  emplace_back(value);
+}
+
+template <class T, class Alloc, std::size_t BlockSize>
+void segmented_vector<T, Alloc, BlockSize>::push_back(value_type &&value) {
+  emplace_back(std::move(value));
+}
+
+template <class T, class Alloc, std::size_t BlockSize>
+template <class... Args>
+typename segmented_vector<T, Alloc, BlockSize>::reference
+segmented_vector<T, Alloc, BlockSize>::emplace_back(Args &&...args) {
+  if (size_ == capacity()) {
+    // Existing elements stay where they are, so args may refer to them
+    add_block();
+  }
+  constructor_.construct(slot(size_), std::forward<Args>(args)...);
+  return (*this)[size_++];
+}
+
+template <class T, class Alloc, std::size_t BlockSize>
+void segmented_vector<T, Alloc, BlockSize>::pop_back() {
+  shrink_to(size_ - 1);
+}
+
+template <class T, class Alloc, std::size_t BlockSize>
+typename segmented_vector<T, Alloc, BlockSize>::size_type
+segmented_vector<T, Alloc, BlockSize>::size() const {
+  return size_;
+}
+
+template <class T, class Alloc, std::size_t BlockSize>
+typename segmented_vector<T, Alloc, BlockSize>::size_type
+segmented_vector<T, Alloc, BlockSize>::max_size() const {
+  // Keep the capacity of all blocks representable
+  return std::min(blocks_.max_size(), static_cast<size_type>(-1) / BlockSize) *
+         BlockSize;
+}
+
+template <class T, class Alloc, std::size_t BlockSize>
+typename segmented_vector<T, Alloc, BlockSize>::size_type
+segmented_vector<T, Alloc, BlockSize>::capacity() const {
+  return blocks_.size() * BlockSize;
+}
+
+template <class T, class Alloc, std::size_t BlockSize>
+void segmented_vector<T, Alloc, BlockSize>::reserve(size_type new_capacity) {
+  if (new_capacity > max_size()) {
+    throw std::length_error("segmented_vector::reserve: requested capacity "
+                            "exceeds max_size()");
+  }
+
+  const size_type blocks = (new_capacity + block_mask) >> block_shift;
+  if (blocks > blocks_.size()) {
+    blocks_.reserve(blocks);
+    while (blocks_.size() < blocks) {
+      add_block();
+    }
+  }
+}
+
+template <class T, class Alloc, std::size_t BlockSize>
+void segmented_vector<T, Alloc, BlockSize>::shrink_to_fit() {
+  const size_type used = segment_count();
+  for (size_type k = used; k < blocks_.size(); ++k) {
+    alloc_traits::deallocate(allocator_, blocks_[k], BlockSize);
+  }
+  blocks_.resize(used);
+}
+
+template <class T, class Alloc, std::size_t BlockSize>
+bool segmented_vector<T, Alloc, BlockSize>::empty() const {
+  return size_ == 0;
+}
+
+template <class T, class Alloc, std::size_t BlockSize>
+void segmented_vector<T, Alloc, BlockSize>::clear() {
+  shrink_to(0);
+}
+
+template <class T, class Alloc, std::size_t BlockSize>
+void segmented_vector<T, Alloc, BlockSize>::swap(segmented_vector &v) {
+  using std::swap;
+
+  if (alloc_traits::propagate_on_container_swap::value) {
+    swap(allocator_, v.allocator_);
+  } else if (allocator_ != v.allocator_) {
+    // The blocks would end up with an allocator, which can't free them
+    throw detail::allocator_mismatch_on_swap();
+  }
+  blocks_.swap(v.blocks_);
+  swap(size_, v.size_);
+}
+
+template <class T, class Alloc, std::size_t BlockSize>
+typename segmented_vector<T, Alloc, BlockSize>::reference
+segmented_vector<T, Alloc, BlockSize>::operator[](size_type idx) {
+  return blocks_[idx >> block_shift][idx & block_mask];
+}
+
+template <class T, class Alloc, std::size_t BlockSize>
+typename segmented_vector<T, Alloc, BlockSize>::const_reference
+segmented_vector<T, Alloc, BlockSize>::operator[](size_type idx) const {
+  return blocks_[idx >> block_shift][idx & block_mask];
+}
+
+template <class T, class Alloc, std::size_t BlockSize>
+typename segmented_vector<T, Alloc, BlockSize>::reference
+segmented_vector<T, Alloc, BlockSize>::front() {
+  return (*this)[0];
+}
+
+template <class T, class Alloc, std::size_t BlockSize>
+typename segmented_vector<T, Alloc, BlockSize>::const_reference
+segmented_vector<T, Alloc, BlockSize>::front() const {
+  return (*this)[0];
+}
+
+template <class T, class Alloc, std::size_t BlockSize>
+typename segmented_vector<T, Alloc, BlockSize>::reference
+segmented_vector<T, Alloc, BlockSize>::back() {
+  return (*this)[size_ - 1];
+}
+
+template <class T, class Alloc, std::size_t BlockSize>
+typename segmented_vector<T, Alloc, BlockSize>::const_reference
+segmented_vector<T, Alloc, BlockSize>::back() const {
+  return (*this)[size_ - 1];
+}
+
+template <class T, class Alloc, std::size_t BlockSize>
+typename segmented_vector<T, Alloc, BlockSize>::iterator
+segmented_vector<T, Alloc, BlockSize>::begin() {
+  return iterator(this, 0);
+}
+
+template <class T, class Alloc, std::size_t BlockSize>
+typename segmented_vector<T, Alloc, BlockSize>::const_iterator
+segmented_vector<T, Alloc, BlockSize>::begin() const {
+  return const_iterator(this, 0);
+}
+
+template <class T, class Alloc, std::size_t BlockSize>
+typename segmented_vector<T, Alloc, BlockSize>::const_iterator
+segmented_vector<T, Alloc, BlockSize>::cbegin() const {
+  return begin();
+}
+
+template <class T, class Alloc, std::size_t BlockSize>
+typename segmented_vector<T, Alloc, BlockSize>::iterator
+segmented_vector<T, Alloc, BlockSize>::end() {
+  return iterator(this, size_);
+}
+
+template <class T, class Alloc, std::size_t BlockSize>
+typename segmented_vector<T, Alloc, BlockSize>::const_iterator
+segmented_vector<T, Alloc, BlockSize>::end() const {
+  return const_iterator(this, size_);
+}
+
+template <class T, class Alloc, std::size_t BlockSize>
+typename segmented_vector<T, Alloc, BlockSize>::const_iterator
+segmented_vector<T, Alloc, BlockSize>::cend() const {
+  return end();
+}
+
+template <class T, class Alloc, std::size_t BlockSize>
+typename segmented_vector<T, Alloc, BlockSize>::allocator_type
+segmented_vector<T, Alloc, BlockSize>::get_allocator() const {
+  return allocator_;
+}
+
+template <class T, class Alloc, std::size_t BlockSize>
+typename segmented_vector<T, Alloc, BlockSize>::size_type
+segmented_vector<T, Alloc, BlockSize>::segment_count() const {
+  return (size_ + block_mask) >> block_shift;
+}
+
+template <class T, class Alloc, std::size_t BlockSize>
+typename segmented_vector<T, Alloc, BlockSize>::pointer
+segmented_vector<T, Alloc, BlockSize>::segment_data(size_type k) {
+  return blocks_[k];
+}
+
+template <class T, class Alloc, std::size_t BlockSize>
+typename segmented_vector<T, Alloc, BlockSize>::const_pointer
+segmented_vector<T, Alloc, BlockSize>::segment_data(size_type k) const {
+  return blocks_[k];
+}
+
+template <class T, class Alloc, std::size_t BlockSize>
+typename segmented_vector<T, Alloc, BlockSize>::size_type
+segmented_vector<T, Alloc, BlockSize>::segment_size(size_type k) const {
+  return std::min(size_ - (k << block_shift), BlockSize);
+}
+
+template <class T, class Alloc, std::size_t BlockSize>
+template <class Function>
+void segmented_vector<T, Alloc, BlockSize>::for_each_segment(Function f) {
+  const size_type count = segment_count();
+  for (size_type k = 0; k < count; ++k) {
+    f(segment_data(k), segment_data(k) + segment_size(k));
+  }
+}
+
+template <class T, class Alloc, std::size_t BlockSize>
+template <class Function>
+void segmented_vector<T, Alloc, BlockSize>::for_each_segment(
+    Function f) const {
+  const size_type count = segment_count();
+  for (size_type k = 0; k < count; ++k) {
+    f(segment_data(k), segment_data(k) + segment_size(k));
+  }
+}
+
+template <class T, class Alloc, std::size_t BlockSize>
+typename segmented_vector<T, Alloc, BlockSize>::storage_type::iterator
+segmented_vector<T, Alloc, BlockSize>::slot(size_type idx) {
+  return typename storage_type::iterator(&(*this)[idx]);
+}
+
+template <class T, class Alloc, std::size_t BlockSize>
+void segmented_vector<T, Alloc, BlockSize>::add_block() {
+  if (capacity() + BlockSize > max_size()) {
+    throw std::length_error("segmented_vector: required capacity exceeds "
+                            "max_size()");
+  }
+
+  T *block = alloc_traits::allocate(allocator_, BlockSize);
+  try {
+    blocks_.push_back(block);
+  } catch (...) {
+    alloc_traits::deallocate(allocator_, block, BlockSize);
+    throw;
+  }
+}
+
+template <class T, class Alloc, std::size_t BlockSize>
+void segmented_vector<T, Alloc, BlockSize>::deallocate_blocks() {
+  for (T *block : blocks_) {
+    alloc_traits::deallocate(allocator_, block, BlockSize);
+  }
+  blocks_.clear();
+}
+
+template <class T, class Alloc, std::size_t BlockSize>
+template <typename Constructor>
+void segmented_vector<T, Alloc, BlockSize>::grow_to(size_type n,
+                                                    Constructor construct) {
+  const size_type old_size = size_;
+  reserve(n);
+
+  try {
+    // Construct block by block, the size covers the constructed pieces
+    while (size_ < n) {
+      const size_type piece =
+          std::min(n - size_, BlockSize - (size_ & block_mask));
+      construct(slot(size_), piece);
+      size_ += piece;
+    }
+  } catch (...) {
+    shrink_to(old_size);
+    throw;
+  }
+}
+
+template <class T, class Alloc, std::size_t BlockSize>
+void segmented_vector<T, Alloc, BlockSize>::shrink_to(size_type n) {
+  while (size_ > n) {
+    const size_type piece =
+        std::min(size_ - n, ((size_ - 1) & block_mask) + 1);
+    constructor_.destroy(slot(size_ - piece), slot(size_ - 1) + 1);
+    size_ -= piece;
+  }
+}
+
+template <class T, class Alloc, std::size_t BlockSize>
+void segmented_vector<T, Alloc, BlockSize>::append_copy(
+    const segmented_vector &v) {
+  reserve(size_ + v.size_);
+
+  // Both vectors have the same block size, so the blocks are copied as a
+  // whole, if this vector is empty
+  v.for_each_segment([this](const T *first, const T *last) {
+    while (first != last) {
+      const size_type piece =
+          std::min(static_cast<size_type>(last - first),
+                   BlockSize - (size_ & block_mask));
+      constructor_.uninitialized_copy(first, first + piece, slot(size_));
+      size_ += piece;
+      first += piece;
+    }
+  });
+}
+
+template <class T, class Alloc, std::size_t BlockSize>
+void segmented_vector<T, Alloc, BlockSize>::append_move(segmented_vector &v) {
+  reserve(size_ + v.size_);
+
+  v.for_each_segment([this](T *first, T *last) {
+    while (first != last) {
+      const size_type piece =
+          std::min(static_cast<size_type>(last - first),
+                   BlockSize - (size_ & block_mask));
+      constructor_.uninitialized_copy(std::make_move_iterator(first),
+                                      std::make_move_iterator(first + piece),
+                                      slot(size_));
+      size_ += piece;
+      first += piece;
+    }
+  });
+}
+
+} // namespace mem
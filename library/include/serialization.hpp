@@ -0,0 +1,344 @@
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "base_vector.hpp"
+#include "fmt/core.h"
+
+namespace mem {
+
+/// Thrown, if a stream doesn't hold a vector of the expected type, or ends
+/// early
+class serialization_error : public std::runtime_error {
+public:
+  using std::runtime_error::runtime_error;
+};
+
+namespace detail {
+
+/// Written in native byte order, so a reader sees the bytes reversed, if the
+/// writer had the other endianness
+inline constexpr std::uint32_t byte_order_mark = 0x01020304;
+
+inline constexpr std::uint32_t swapped_byte_order_mark = 0x04030201;
+
+/// Header in front of the elements of a serialized vector
+struct binary_header {
+  static constexpr char magic_value[8] = {'m', 'e', 'm', 'v',
+                                          'b', 'i', 'n', '\0'};
+  static constexpr std::uint32_t current_version = 1;
+
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t byte_order;
+  std::uint32_t element_size;
+  std::uint32_t element_alignment;
+  std::uint64_t count;
+};
+
+static_assert(sizeof(binary_header) == 32,
+              "binary_header has to keep its layout");
+
+/// Largest number of bytes passed to a single write
+inline constexpr std::size_t default_chunk_bytes = std::size_t(1) << 30;
+
+/// Bytes load allocates before any element arrived. The count in the header
+/// isn't trusted beyond that, the buffer grows with the received elements
+inline constexpr std::size_t initial_load_bytes = std::size_t(1) << 20;
+
+template <class T> binary_header make_binary_header(std::size_t count) {
+  binary_header header{};
+  std::memcpy(header.magic, binary_header::magic_value, sizeof(header.magic));
+  header.version = binary_header::current_version;
+  header.byte_order = byte_order_mark;
+  header.element_size = sizeof(T);
+  header.element_alignment = alignof(T);
+  header.count = count;
+  return header;
+}
+
+inline std::uint32_t byteswap(std::uint32_t x) {
+  return (x >> 24) | ((x >> 8) & 0xff00u) | ((x << 8) & 0xff0000u) |
+         (x << 24);
+}
+
+inline std::uint64_t byteswap(std::uint64_t x) {
+  return (std::uint64_t(byteswap(static_cast<std::uint32_t>(x))) << 32) |
+         byteswap(static_cast<std::uint32_t>(x >> 32));
+}
+
+/// Reverse the bytes of each of the n elements at p
+template <class T> void byteswap_elements(T *p, std::size_t n) {
+  auto *bytes = reinterpret_cast<unsigned char *>(p);
+  for (std::size_t i = 0; i < n; ++i, bytes += sizeof(T)) {
+    std::reverse(bytes, bytes + sizeof(T));
+  }
+}
+
+/// Check the header is for elements of type T, and return the number of
+/// elements. swap is set, if the elements have the other byte order
+template <class T>
+std::size_t check_binary_header(binary_header &header, bool &swap) {
+  if (std::memcmp(header.magic, binary_header::magic_value,
+                  sizeof(header.magic)) != 0) {
+    throw serialization_error("mem: stream doesn't hold a serialized vector");
+  }
+
+  swap = header.byte_order == swapped_byte_order_mark;
+  if (swap) {
+    header.version = byteswap(header.version);
+    header.element_size = byteswap(header.element_size);
+    header.element_alignment = byteswap(header.element_alignment);
+    header.count = byteswap(header.count);
+  } else if (header.byte_order != byte_order_mark) {
+    throw serialization_error("mem: serialized vector has no byte order mark");
+  }
+
+  if (header.version != binary_header::current_version) {
+    throw serialization_error(
+        fmt::format("mem: serialized vector has version {}, {} expected",
+                    header.version, binary_header::current_version));
+  }
+  if (header.element_size != sizeof(T) ||
+      header.element_alignment != alignof(T)) {
+    throw serialization_error(fmt::format(
+        "mem: serialized vector stores elements of size {} and alignment {}, "
+        "size {} and alignment {} expected",
+        header.element_size, header.element_alignment, sizeof(T), alignof(T)));
+  }
+  if (swap && !std::is_arithmetic_v<T>) {
+    // The layout of the members is unknown, so they can't be swapped
+    throw serialization_error("mem: serialized vector has the other byte "
+                              "order, which is only supported for numbers");
+  }
+
+  return static_cast<std::size_t>(header.count);
+}
+
+/// Write all bytes of the buffers, retrying partial writes and interrupts
+inline void write_all(int fd, iovec *buffers, int count) {
+  while (count > 0) {
+    const ssize_t written = ::writev(fd, buffers, count);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw std::system_error(errno, std::generic_category(),
+                              "mem: writing a vector failed");
+    }
+
+    auto remaining = static_cast<std::size_t>(written);
+    while (count > 0 && remaining >= buffers->iov_len) {
+      remaining -= buffers->iov_len;
+      ++buffers;
+      --count;
+    }
+    if (count > 0) {
+      buffers->iov_base = static_cast<char *>(buffers->iov_base) + remaining;
+      buffers->iov_len -= remaining;
+    }
+  }
+}
+
+/// Read exactly bytes into p, throws serialization_error on end of stream
+inline void read_all(int fd, void *p, std::size_t bytes) {
+  auto *out = static_cast<char *>(p);
+  while (bytes > 0) {
+    const ssize_t n = ::read(fd, out, std::min(bytes, default_chunk_bytes));
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw std::system_error(errno, std::generic_category(),
+                              "mem: reading a vector failed");
+    }
+    if (n == 0) {
+      throw serialization_error("mem: stream ended inside a vector");
+    }
+    out += n;
+    bytes -= static_cast<std::size_t>(n);
+  }
+}
+
+} // namespace detail
+
+/**
+ * @brief Write v to the file descriptor fd: a header (format version, byte
+ * order, element size and alignment, count) followed by the bytes of the
+ * elements.
+ *
+ * Header and elements are written by a single writev, vectors larger than
+ * chunk_bytes in chunks of that size. Throws std::invalid_argument, if
+ * chunk_bytes is 0.
+ */
+template <class T, class Alloc, class GrowthPolicy>
+void save(int fd, const base_vector<T, Alloc, GrowthPolicy> &v,
+          std::size_t chunk_bytes = detail::default_chunk_bytes) {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "only trivially copyable elements can be saved bytewise");
+
+  if (chunk_bytes == 0) {
+    throw std::invalid_argument("mem::save: chunk_bytes has to be larger "
+                                "than 0");
+  }
+
+  detail::binary_header header = detail::make_binary_header<T>(v.size());
+
+  const auto *data = reinterpret_cast<const char *>(v.data());
+  std::size_t bytes = v.size() * sizeof(T);
+  std::size_t chunk = std::min(bytes, chunk_bytes);
+
+  iovec buffers[2] = {{&header, sizeof(header)},
+                      {const_cast<char *>(data), chunk}};
+  detail::write_all(fd, buffers, chunk > 0 ? 2 : 1);
+
+  for (data += chunk, bytes -= chunk; bytes > 0;
+       data += chunk, bytes -= chunk) {
+    chunk = std::min(bytes, chunk_bytes);
+    iovec buffer = {const_cast<char *>(data), chunk};
+    detail::write_all(fd, &buffer, 1);
+  }
+}
+
+/**
+ * @brief Replace the elements of v with a vector read from the file
+ * descriptor fd (see save). The elements are read straight into the buffer of
+ * v, which isn't initialized before (see resize_for_overwrite). Vectors
+ * written with the other byte order are converted, if T is a number.
+ *
+ * The buffer grows with the elements read so far (at most doubling each
+ * time), so a corrupt or truncated stream can't make it allocate much more
+ * memory than the stream actually holds.
+ *
+ * Throws serialization_error, if the stream holds no vector of T or ends
+ * early, v is left empty then.
+ */
+template <class T, class Alloc, class GrowthPolicy>
+void load(int fd, base_vector<T, Alloc, GrowthPolicy> &v) {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "only trivially copyable elements can be loaded bytewise");
+
+  detail::binary_header header;
+  detail::read_all(fd, &header, sizeof(header));
+
+  bool swap = false;
+  const std::size_t n = detail::check_binary_header<T>(header, swap);
+  if (n > v.max_size()) {
+    throw serialization_error("mem: serialized vector exceeds max_size()");
+  }
+
+  v.clear();
+
+  // The existing buffer is used up first
+  const std::size_t first_piece =
+      std::max({v.capacity(), detail::initial_load_bytes / sizeof(T),
+                std::size_t(1)});
+
+  try {
+    for (std::size_t read = 0; read < n;) {
+      const std::size_t piece =
+          std::min(n - read, std::max(read, first_piece));
+      v.resize_for_overwrite(read + piece);
+      detail::read_all(fd, v.data() + read, piece * sizeof(T));
+      read += piece;
+    }
+  } catch (...) {
+    v.clear();
+    throw;
+  }
+
+  if (swap) {
+    detail::byteswap_elements(v.data(), n);
+  }
+}
+
+/**
+ * @brief Reads a serialized vector (see save) chunk by chunk, e.g. from a
+ * pipe, such that only a bounded part of it is in memory at once.
+ */
+template <class T> class stream_reader {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "only trivially copyable elements can be read bytewise");
+
+public:
+  using size_type = std::size_t;
+
+  /// Reads the header from fd, throws serialization_error, if it isn't a
+  /// vector of T
+  explicit stream_reader(int fd);
+
+  /// Number of elements of the whole vector
+  size_type size() const;
+
+  /// Number of elements, which weren't read yet
+  size_type remaining() const;
+
+  /// Append up to max_elements of the remaining elements to v, returns the
+  /// number of appended elements, 0 at the end of the vector
+  template <class Alloc, class GrowthPolicy>
+  size_type read(base_vector<T, Alloc, GrowthPolicy> &v,
+                 size_type max_elements);
+
+private:
+  int fd_;
+  size_type size_;
+  size_type remaining_;
+  bool swap_;
+};
+
+template <class T>
+stream_reader<T>::stream_reader(int fd)
+    : fd_(fd), size_(0), remaining_(0), swap_(false) {
+  detail::binary_header header;
+  detail::read_all(fd_, &header, sizeof(header));
+
+  size_ = detail::check_binary_header<T>(header, swap_);
+  remaining_ = size_;
+}
+
+template <class T>
+typename stream_reader<T>::size_type stream_reader<T>::size() const {
+  return size_;
+}
+
+template <class T>
+typename stream_reader<T>::size_type stream_reader<T>::remaining() const {
+  return remaining_;
+}
+
+template <class T>
+template <class Alloc, class GrowthPolicy>
+typename stream_reader<T>::size_type
+stream_reader<T>::read(base_vector<T, Alloc, GrowthPolicy> &v,
+                       size_type max_elements) {
+  const size_type n = std::min(remaining_, max_elements);
+  const size_type old_size = v.size();
+
+  v.resize_for_overwrite(old_size + n);
+
+  try {
+    detail::read_all(fd_, v.data() + old_size, n * sizeof(T));
+  } catch (...) {
+    v.resize(old_size);
+    throw;
+  }
+
+  if (swap_) {
+    detail::byteswap_elements(v.data() + old_size, n);
+  }
+
+  remaining_ -= n;
+  return n;
+}
+
+} // namespace mem
@@ -0,0 +1,226 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+#include "base_vector.hpp"
+
+namespace mem {
+namespace detail {
+
+/// Uninitialized memory for N elements of type T, aligned to Alignment bytes.
+/// Copying it doesn't copy any bytes, the owner is responsible for the elements
+template <class T, std::size_t N, std::size_t Alignment = alignof(T)>
+class inline_buffer {
+private:
+  alignas(Alignment) unsigned char buffer_[N * sizeof(T)];
+
+public:
+  inline_buffer() {}
+
+  inline_buffer(const inline_buffer &) {}
+
+  inline_buffer &operator=(const inline_buffer &) { return *this; }
+
+  T *inline_data() { return reinterpret_cast<T *>(buffer_); }
+
+  const T *inline_data() const { return reinterpret_cast<const T *>(buffer_); }
+};
+
+} // namespace detail
+
+/**
+ * @brief Vector storing up to N elements inline, i.e. without allocating
+ * memory. Only if it grows larger, the elements are moved to a buffer
+ * allocated by Alloc. It offers the complete base_vector interface, and can be
+ * passed as reference to base_vector.
+ *
+ * Moving a small_vector, whose elements are stored inline, moves the elements
+ * one by one (at most N). Otherwise the allocated buffer is taken over.
+ *
+ * The inline buffer is aligned like the buffers of Alloc, so aligned_data()
+ * holds for both.
+ *
+ * @tparam T type of the stored elements
+ * @tparam N number of elements stored inline
+ * @tparam Alloc allocator used, once more than N elements are stored
+ * @tparam GrowthPolicy policy computing the new capacity, if the vector runs
+ * out of space
+ */
+template <class T, std::size_t N, class Alloc = std::allocator<T>,
+          class GrowthPolicy = growth::default_policy>
+class small_vector
+    : private detail::inline_buffer<T, N,
+                                    detail::allocator_alignment<Alloc>::value>,
+      public base_vector<T, Alloc, GrowthPolicy> {
+  static_assert(N > 0, "small_vector needs an inline capacity, use "
+                       "base_vector otherwise");
+
+private:
+  using buffer_type =
+      detail::inline_buffer<T, N, detail::allocator_alignment<Alloc>::value>;
+  using base_type = base_vector<T, Alloc, GrowthPolicy>;
+  using storage_type = typename base_type::storage_type;
+
+public:
+  using value_type = typename base_type::value_type;
+
+  using size_type = typename base_type::size_type;
+
+  using allocator_type = typename base_type::allocator_type;
+
+  /// Number of elements, which can be stored without allocating
+  static constexpr size_type inline_capacity = N;
+
+  /// create empty vector
+  small_vector();
+
+  /// create empty vector with given allocator
+  explicit small_vector(const Alloc &alloc);
+
+  /// create vector of size n, with value initialized values
+  explicit small_vector(size_type n, const Alloc &alloc = Alloc());
+
+  /// create vector of size n, with copies of value
+  small_vector(size_type n, const value_type &value,
+               const Alloc &alloc = Alloc());
+
+  /// Construct small_vector from iterator range
+  template <typename InputIter>
+  small_vector(InputIter first, InputIter last, const Alloc &alloc = Alloc());
+
+  /// Copy constructor copies from a exemplar base_vector
+  explicit small_vector(const base_type &v);
+
+  /// Copy constructor copies from a exemplar small_vector
+  small_vector(const small_vector &v);
+
+  /// Move constructor, takes over the buffer of v, if it's allocated, moves
+  /// the elements otherwise
+  small_vector(small_vector &&v);
+
+  /// Copy assignment copies from a exemplar small_vector
+  small_vector &operator=(const small_vector &v);
+
+  /// Move assignment, takes over the buffer of v, if it's allocated, moves the
+  /// elements otherwise
+  small_vector &operator=(small_vector &&v);
+
+  /// true, if the elements are stored in the inline buffer
+  bool is_inline() const;
+
+  /// Swap elements of this vector with given vector. Allocated buffers are
+  /// swapped, inline elements are moved
+  void swap(small_vector &v);
+
+private:
+  /// Let the (empty) vector use its inline buffer again
+  void reset_to_inline();
+};
+
+template <class T, std::size_t N, class Alloc, class GrowthPolicy>
+small_vector<T, N, Alloc, GrowthPolicy>::small_vector()
+    : buffer_type(), base_type(detail::external_buffer_t{},
+                               this->inline_data(), N, Alloc()) {}
+
+template <class T, std::size_t N, class Alloc, class GrowthPolicy>
+small_vector<T, N, Alloc, GrowthPolicy>::small_vector(const Alloc &alloc)
+    : buffer_type(), base_type(detail::external_buffer_t{},
+                               this->inline_data(), N, alloc) {}
+
+template <class T, std::size_t N, class Alloc, class GrowthPolicy>
+small_vector<T, N, Alloc, GrowthPolicy>::small_vector(size_type n,
+                                                      const Alloc &alloc)
+    : small_vector(alloc) {
+  this->resize(n);
+}
+
+template <class T, std::size_t N, class Alloc, class GrowthPolicy>
+small_vector<T, N, Alloc, GrowthPolicy>::small_vector(size_type n,
+                                                      const value_type &value,
+                                                      const Alloc &alloc)
+    : small_vector(alloc) {
+  this->assign(n, value);
+}
+
+template <class T, std::size_t N, class Alloc, class GrowthPolicy>
+template <typename InputIter>
+small_vector<T, N, Alloc, GrowthPolicy>::small_vector(InputIter first,
+                                                      InputIter last,
+                                                      const Alloc &alloc)
+    : small_vector(alloc) {
+  // assign interprets integral types as (size_type, value_type)
+  this->assign(first, last);
+}
+
+template <class T, std::size_t N, class Alloc, class GrowthPolicy>
+small_vector<T, N, Alloc, GrowthPolicy>::small_vector(const base_type &v)
+    : small_vector(std::allocator_traits<Alloc>::
+                       select_on_container_copy_construction(
+                           v.get_allocator())) {
+  this->assign(v.begin(), v.end());
+}
+
+template <class T, std::size_t N, class Alloc, class GrowthPolicy>
+small_vector<T, N, Alloc, GrowthPolicy>::small_vector(const small_vector &v)
+    : small_vector(std::allocator_traits<Alloc>::
+                       select_on_container_copy_construction(
+                           v.get_allocator())) {
+  this->assign(v.begin(), v.end());
+}
+
+template <class T, std::size_t N, class Alloc, class GrowthPolicy>
+small_vector<T, N, Alloc, GrowthPolicy>::small_vector(small_vector &&v)
+    : small_vector(v.get_allocator()) {
+  *this = std::move(v);
+}
+
+template <class T, std::size_t N, class Alloc, class GrowthPolicy>
+small_vector<T, N, Alloc, GrowthPolicy> &
+small_vector<T, N, Alloc, GrowthPolicy>::operator=(const small_vector &v) {
+  base_type::operator=(v);
+  return *this;
+}
+
+template <class T, std::size_t N, class Alloc, class GrowthPolicy>
+small_vector<T, N, Alloc, GrowthPolicy> &
+small_vector<T, N, Alloc, GrowthPolicy>::operator=(small_vector &&v) {
+  if (this != &v) {
+    base_type::operator=(std::move(v));
+
+    // If the buffer of v was taken over, v is left without one
+    if (!v.is_inline()) {
+      v.reset_to_inline();
+    }
+  }
+
+  return *this;
+}
+
+template <class T, std::size_t N, class Alloc, class GrowthPolicy>
+bool small_vector<T, N, Alloc, GrowthPolicy>::is_inline() const {
+  return this->data() == this->inline_data();
+}
+
+template <class T, std::size_t N, class Alloc, class GrowthPolicy>
+void small_vector<T, N, Alloc, GrowthPolicy>::swap(small_vector &v) {
+  if (!is_inline() && !v.is_inline()) {
+    base_type::swap(v);
+  } else {
+    // At most N elements are moved for each inline vector, allocated buffers
+    // are only handed over
+    small_vector tmp(std::move(v));
+    v = std::move(*this);
+    *this = std::move(tmp);
+  }
+}
+
+template <class T, std::size_t N, class Alloc, class GrowthPolicy>
+void small_vector<T, N, Alloc, GrowthPolicy>::reset_to_inline() {
+  this->clear();
+  this->storage_ = storage_type(detail::external_buffer_t{},
+                                this->inline_data(), N, this->get_allocator());
+}
+
+} // namespace mem
@@ -0,0 +1,735 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "contiguous_storage.hpp"
+#include "growth_policy.hpp"
+#include "iterator_facade.hpp"
+#include "trivially_relocatable.hpp"
+#include "vector_view.hpp"
+
+namespace mem {
+namespace iter {
+
+/// Random access iterator over the rows of a structure of arrays (e.g.
+/// soa_vector). Dereferencing yields a proxy, a std::tuple of references to
+/// the fields of the row
+template <class... Ts>
+struct zip_iterator
+    : iterator_facade<zip_iterator<Ts...>, std::tuple<Ts...>,
+                      std::random_access_iterator_tag> {
+private:
+  using super_t = iterator_facade<zip_iterator<Ts...>, std::tuple<Ts...>,
+                                  std::random_access_iterator_tag>;
+
+public:
+  using value_type = std::tuple<std::remove_cv_t<Ts>...>;
+  using reference = std::tuple<Ts &...>;
+  using pointer = void;
+  using difference_type = typename super_t::difference_type;
+  using iterator_category = std::random_access_iterator_tag;
+
+private:
+  std::tuple<Ts *...> columns_;
+  difference_type index_;
+
+public:
+  zip_iterator() : columns_(), index_(0) {}
+
+  zip_iterator(std::tuple<Ts *...> columns, difference_type index)
+      : columns_(columns), index_(index) {}
+
+  /// Iterator to const from iterator
+  template <class... Us,
+            typename = std::enable_if_t<
+                (std::is_convertible_v<Us *, Ts *> && ...)>>
+  zip_iterator(const zip_iterator<Us...> &other)
+      : columns_(other.columns()), index_(other.index()) {}
+
+  const std::tuple<Ts *...> &columns() const { return columns_; }
+
+  difference_type index() const { return index_; }
+
+  reference dereference() const {
+    return std::apply(
+        [this](Ts *...columns) { return reference(columns[index_]...); },
+        columns_);
+  }
+
+  void increment() { ++index_; }
+
+  void decrement() { --index_; }
+
+  void advance(difference_type n) { index_ += n; }
+
+  difference_type distance_to(const zip_iterator &other) const {
+    return other.index_ - index_;
+  }
+
+  bool equal_to(const zip_iterator &other) const {
+    return index_ == other.index_;
+  }
+};
+
+} // namespace iter
+
+/**
+ * @brief Vector of rows with the fields Ts..., which stores each field in its
+ * own contiguous buffer (structure of arrays).
+ *
+ * Loops reading only some fields touch only their buffers, so no cache line
+ * is wasted on the other fields, and column<I>() is a vector_view over a
+ * plain array, which vectorizes like a base_vector<T>.
+ *
+ * Rows are accessed through proxies, std::tuple<Ts &...>, e.g. by operator[]
+ * or the zip iterators. Algorithms reading and assigning through them work
+ * (std::for_each, std::copy, std::find_if), algorithms swapping elements (e.g.
+ * std::sort) don't, as the proxies can't be swapped.
+ *
+ * All buffers grow together, like the one of base_vector.
+ *
+ * @tparam Alloc allocator, rebound to the type of each field
+ * @tparam GrowthPolicy policy computing the new capacity, if the vector runs
+ * out of space (see growth_policy.hpp)
+ * @tparam Ts types of the fields of a row
+ */
+template <class Alloc, class GrowthPolicy, class... Ts>
+class basic_soa_vector {
+  static_assert(sizeof...(Ts) > 0, "soa_vector needs at least one field");
+
+private:
+  template <class T>
+  using column_allocator =
+      typename std::allocator_traits<Alloc>::template rebind_alloc<T>;
+
+  template <class T>
+  using column_storage = detail::contiguous_storage<T, column_allocator<T>>;
+
+  using columns_type = std::tuple<column_storage<Ts>...>;
+
+  using column_indices = std::index_sequence_for<Ts...>;
+
+  /// Relocating a T to a new buffer can't throw
+  template <class T>
+  static constexpr bool is_nothrow_relocatable =
+      is_trivially_relocatable<T>::value ||
+      std::is_nothrow_move_constructible_v<T>;
+
+public:
+  using value_type = std::tuple<Ts...>;
+
+  using reference = std::tuple<Ts &...>;
+  using const_reference = std::tuple<const Ts &...>;
+
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+
+  using allocator_type = Alloc;
+
+  using growth_policy = GrowthPolicy;
+
+  using iterator = iter::zip_iterator<Ts...>;
+  using const_iterator = iter::zip_iterator<const Ts...>;
+
+  /// Type of field I
+  template <std::size_t I>
+  using column_type = std::tuple_element_t<I, value_type>;
+
+  /// Number of fields
+  static constexpr size_type column_count = sizeof...(Ts);
+
+private:
+  /// The buffers of all fields hold capacity() elements
+  columns_type columns_;
+
+  size_type size_;
+
+public:
+  /// create empty vector
+  basic_soa_vector();
+
+  /// create empty vector with given allocator
+  explicit basic_soa_vector(const Alloc &alloc);
+
+  /// create vector of size n, with value initialized fields
+  explicit basic_soa_vector(size_type n, const Alloc &alloc = Alloc());
+
+  basic_soa_vector(const basic_soa_vector &v);
+
+  /// Move constructor takes over the buffers
+  basic_soa_vector(basic_soa_vector &&v);
+
+  basic_soa_vector &operator=(const basic_soa_vector &v);
+
+  /// Takes over the buffers of v, if the allocator propagates or compares
+  /// equal, otherwise the rows are moved one by one
+  basic_soa_vector &operator=(basic_soa_vector &&v);
+
+  ~basic_soa_vector();
+
+  size_type size() const;
+
+  size_type max_size() const;
+
+  size_type capacity() const;
+
+  bool empty() const;
+
+  /// Grow all buffers to at least new_capacity elements. Throws
+  /// std::length_error, if new_capacity is larger than max_size()
+  void reserve(size_type new_capacity);
+
+  /// Shrink or grow to new_size rows, new fields are value initialized
+  void resize(size_type new_size);
+
+  /// Append a copy of row
+  void push_back(const value_type &row);
+
+  /// Append row by moving its fields
+  void push_back(value_type &&row);
+
+  /// Append a row, whose field I is constructed from args number I
+  template <class... Args> reference emplace_back(Args &&...args);
+
+  /// Remove the last row, the vector must not be empty
+  void pop_back();
+
+  /// Destroy all rows, the capacity is left unchanged
+  void clear();
+
+  /// Swap the buffers of this vector with the ones of v
+  void swap(basic_soa_vector &v);
+
+  /// Proxy of row idx
+  reference operator[](size_type idx);
+
+  /// Proxy of row idx
+  const_reference operator[](size_type idx) const;
+
+  /// Contiguous view of field I of all rows
+  template <std::size_t I> vector_view<column_type<I>> column();
+
+  /// Contiguous view of field I of all rows
+  template <std::size_t I> vector_view<const column_type<I>> column() const;
+
+  iterator begin();
+
+  const_iterator begin() const;
+
+  const_iterator cbegin() const;
+
+  iterator end();
+
+  const_iterator end() const;
+
+  const_iterator cend() const;
+
+  allocator_type get_allocator() const;
+
+private:
+  /// Construct n rows at index first in columns. For each field I in order,
+  /// construct(std::integral_constant<std::size_t, I>, column, pos, n) is
+  /// called. If it throws, the fields constructed before are destroyed
+  template <class Construct>
+  static void construct_rows(columns_type &columns, size_type first,
+                             size_type n, Construct construct);
+
+  /// Destroy n rows at index first in columns
+  static void destroy_rows(columns_type &columns, size_type first,
+                           size_type n);
+
+  /// Append n rows constructed by construct (see construct_rows), the
+  /// buffers grow using the growth policy if necessary. On growth, the new
+  /// rows are constructed before the existing ones are relocated, so
+  /// arguments referring to rows of this vector stay valid
+  template <class Construct> void append(size_type n, Construct construct);
+
+  /// Grow all buffers to new_capacity, and construct n rows at size() in
+  /// them (see append). If it throws, nothing is changed
+  template <class Construct>
+  void reallocate_append(size_type new_capacity, size_type n,
+                         Construct construct);
+
+  /// Relocate the rows to new_columns. If it throws, nothing is changed
+  void relocate_rows(columns_type &new_columns);
+
+  /// Append a row, whose field I is constructed from std::get<I>(row)
+  template <class Tuple> reference emplace_from_tuple(Tuple &&row);
+
+  /// Capacity to grow to, such that at least required rows fit, as given by
+  /// the growth policy
+  size_type next_capacity(size_type required) const;
+
+  /// Empty columns using alloc
+  static columns_type make_columns(const Alloc &alloc);
+
+  /// Call f(std::integral_constant<std::size_t, I>()) for each field I in
+  /// order
+  template <class Function> static void for_each_column(Function f);
+
+  template <class Function, std::size_t... Is>
+  static void for_each_column(Function f, std::index_sequence<Is...>);
+
+  template <std::size_t... Is>
+  std::tuple<Ts *...> column_data(std::index_sequence<Is...>);
+
+  template <std::size_t... Is>
+  std::tuple<const Ts *...> column_data(std::index_sequence<Is...>) const;
+};
+
+/// soa_vector using std::allocator and the default growth policy
+template <class... Ts>
+using soa_vector =
+    basic_soa_vector<std::allocator<std::byte>, growth::default_policy, Ts...>;
+
+template <class Alloc, class GrowthPolicy, class... Ts>
+basic_soa_vector<Alloc, GrowthPolicy, Ts...>::basic_soa_vector()
+    : basic_soa_vector(Alloc()) {}
+
+template <class Alloc, class GrowthPolicy, class... Ts>
+basic_soa_vector<Alloc, GrowthPolicy, Ts...>::basic_soa_vector(
+    const Alloc &alloc)
+    : columns_(make_columns(alloc)), size_(0) {}
+
+template <class Alloc, class GrowthPolicy, class... Ts>
+basic_soa_vector<Alloc, GrowthPolicy, Ts...>::basic_soa_vector(
+    size_type n, const Alloc &alloc)
+    : basic_soa_vector(alloc) {
+  resize(n);
+}
+
+template <class Alloc, class GrowthPolicy, class... Ts>
+basic_soa_vector<Alloc, GrowthPolicy, Ts...>::basic_soa_vector(
+    const basic_soa_vector &v)
+    : basic_soa_vector(
+          std::allocator_traits<Alloc>::select_on_container_copy_construction(
+              v.get_allocator())) {
+  reserve(v.size_);
+  append(v.size_, [&v](auto index, auto &column, auto pos, size_type n) {
+    const auto &source = std::get<decltype(index)::value>(v.columns_);
+    column.uninitialized_copy(source.begin(), source.begin() + n, pos);
+  });
+}
+
+template <class Alloc, class GrowthPolicy, class... Ts>
+basic_soa_vector<Alloc, GrowthPolicy, Ts...>::basic_soa_vector(
+    basic_soa_vector &&v)
+    : basic_soa_vector(v.get_allocator()) {
+  swap(v);
+}
+
+template <class Alloc, class GrowthPolicy, class... Ts>
+basic_soa_vector<Alloc, GrowthPolicy, Ts...> &
+basic_soa_vector<Alloc, GrowthPolicy, Ts...>::operator=(
+    const basic_soa_vector &v) {
+  if (this == &v) {
+    return *this;
+  }
+
+  clear();
+  for_each_column([this, &v](auto index) {
+    auto &column = std::get<decltype(index)::value>(columns_);
+    const auto &other = std::get<decltype(index)::value>(v.columns_);
+    column.deallocate_on_allocator_mismatch(other);
+    column.propagate_allocator(other);
+  });
+
+  append(v.size_, [&v](auto index, auto &column, auto pos, size_type n) {
+    const auto &source = std::get<decltype(index)::value>(v.columns_);
+    column.uninitialized_copy(source.begin(), source.begin() + n, pos);
+  });
+  return *this;
+}
+
+template <class Alloc, class GrowthPolicy, class... Ts>
+basic_soa_vector<Alloc, GrowthPolicy, Ts...> &
+basic_soa_vector<Alloc, GrowthPolicy, Ts...>::operator=(
+    basic_soa_vector &&v) {
+  if (this == &v) {
+    return *this;
+  }
+
+  constexpr bool propagate = std::allocator_traits<
+      Alloc>::propagate_on_container_move_assignment::value;
+
+  clear();
+  if (!propagate &&
+      std::get<0>(columns_).is_allocator_not_equal(std::get<0>(v.columns_))) {
+    // Our allocator can't deallocate the buffers of v, so move the rows
+    // instead
+    append(v.size_, [&v](auto index, auto &column, auto pos, size_type n) {
+      auto &source = std::get<decltype(index)::value>(v.columns_);
+      column.uninitialized_copy(std::make_move_iterator(source.begin()),
+                                std::make_move_iterator(source.begin() + n),
+                                pos);
+    });
+    v.clear();
+    return *this;
+  }
+
+  for_each_column([this, &v](auto index) {
+    std::get<decltype(index)::value>(columns_) =
+        std::move(std::get<decltype(index)::value>(v.columns_));
+  });
+  size_ = std::exchange(v.size_, 0);
+  return *this;
+}
+
+template <class Alloc, class GrowthPolicy, class... Ts>
+basic_soa_vector<Alloc, GrowthPolicy, Ts...>::~basic_soa_vector() {
+  clear();
+}
+
+template <class Alloc, class GrowthPolicy, class... Ts>
+typename basic_soa_vector<Alloc, GrowthPolicy, Ts...>::size_type
+basic_soa_vector<Alloc, GrowthPolicy, Ts...>::size() const {
+  return size_;
+}
+
+template <class Alloc, class GrowthPolicy, class... Ts>
+typename basic_soa_vector<Alloc, GrowthPolicy, Ts...>::size_type
+basic_soa_vector<Alloc, GrowthPolicy, Ts...>::max_size() const {
+  return std::apply(
+      [](const auto &...columns) { return std::min({columns.max_size()...}); },
+      columns_);
+}
+
+template <class Alloc, class GrowthPolicy, class... Ts>
+typename basic_soa_vector<Alloc, GrowthPolicy, Ts...>::size_type
+basic_soa_vector<Alloc, GrowthPolicy, Ts...>::capacity() const {
+  return std::get<0>(columns_).size();
+}
+
+template <class Alloc, class GrowthPolicy, class... Ts>
+bool basic_soa_vector<Alloc, GrowthPolicy, Ts...>::empty() const {
+  return size_ == 0;
+}
+
+template <class Alloc, class GrowthPolicy, class... Ts>
+void basic_soa_vector<Alloc, GrowthPolicy, Ts...>::reserve(
+    size_type new_capacity) {
+  if (new_capacity > max_size()) {
+    throw std::length_error("soa_vector::reserve: requested capacity exceeds "
+                            "max_size()");
+  }
+
+  if (new_capacity > capacity()) {
+    reallocate_append(new_capacity, 0, [](auto, auto &, auto, size_type) {});
+  }
+}
+
+template <class Alloc, class GrowthPolicy, class... Ts>
+void basic_soa_vector<Alloc, GrowthPolicy, Ts...>::resize(size_type new_size) {
+  if (new_size < size_) {
+    destroy_rows(columns_, new_size, size_ - new_size);
+    size_ = new_size;
+  } else {
+    append(new_size - size_,
+           [](auto, auto &column, auto pos, size_type n) {
+             column.value_construct_n(pos, n);
+           });
+  }
+}
+
+template <class Alloc, class GrowthPolicy, class... Ts>
+void basic_soa_vector<Alloc, GrowthPolicy, Ts...>::push_back(
+    const value_type &row) {
+  emplace_from_tuple(row);
+}
+
+template <class Alloc, class GrowthPolicy, class... Ts>
+void basic_soa_vector<Alloc, GrowthPolicy, Ts...>::push_back(
+    value_type &&row) {
+  emplace_from_tuple(std::move(row));
+}
+
+template <class Alloc, class GrowthPolicy, class... Ts>
+template <class... Args>
+typename basic_soa_vector<Alloc, GrowthPolicy, Ts...>::reference
+basic_soa_vector<Alloc, GrowthPolicy, Ts...>::emplace_back(Args &&...args) {
+  static_assert(sizeof...(Args) == sizeof...(Ts),
+                "emplace_back takes one argument per field");
+  return emplace_from_tuple(std::forward_as_tuple(std::forward<Args>(args)...));
+}
+
+template <class Alloc, class GrowthPolicy, class... Ts>
+void basic_soa_vector<Alloc, GrowthPolicy, Ts...>::pop_back() {
+  --size_;
+  destroy_rows(columns_, size_, 1);
+}
+
+template <class Alloc, class GrowthPolicy, class... Ts>
+void basic_soa_vector<Alloc, GrowthPolicy, Ts...>::clear() {
+  destroy_rows(columns_, 0, size_);
+  size_ = 0;
+}
+
+template <class Alloc, class GrowthPolicy, class... Ts>
+void basic_soa_vector<Alloc, GrowthPolicy, Ts...>::swap(basic_soa_vector &v) {
+  // All columns use the same allocator, so if it can't be swapped, the first
+  // column throws before anything is swapped
+  for_each_column([this, &v](auto index) {
+    std::get<decltype(index)::value>(columns_).swap(
+        std::get<decltype(index)::value>(v.columns_));
+  });
+  std::swap(size_, v.size_);
+}
+
+template <class Alloc, class GrowthPolicy, class... Ts>
+typename basic_soa_vector<Alloc, GrowthPolicy, Ts...>::reference
+basic_soa_vector<Alloc, GrowthPolicy, Ts...>::operator[](size_type idx) {
+  return std::apply(
+      [idx](auto &...columns) { return reference(columns[idx]...); },
+      columns_);
+}
+
+template <class Alloc, class GrowthPolicy, class... Ts>
+typename basic_soa_vector<Alloc, GrowthPolicy, Ts...>::const_reference
+basic_soa_vector<Alloc, GrowthPolicy, Ts...>::operator[](size_type idx) const {
+  return std::apply(
+      [idx](const auto &...columns) {
+        return const_reference(columns.data()[idx]...);
+      },
+      columns_);
+}
+
+template <class Alloc, class GrowthPolicy, class... Ts>
+template <std::size_t I>
+vector_view<typename basic_soa_vector<Alloc, GrowthPolicy,
+                                      Ts...>::template column_type<I>>
+basic_soa_vector<Alloc, GrowthPolicy, Ts...>::column() {
+  return {std::get<I>(columns_).data(), size_};
+}
+
+template <class Alloc, class GrowthPolicy, class... Ts>
+template <std::size_t I>
+vector_view<const typename basic_soa_vector<Alloc, GrowthPolicy,
+                                            Ts...>::template column_type<I>>
+basic_soa_vector<Alloc, GrowthPolicy, Ts...>::column() const {
+  return {std::get<I>(columns_).data(), size_};
+}
+
+template <class Alloc, class GrowthPolicy, class... Ts>
+typename basic_soa_vector<Alloc, GrowthPolicy, Ts...>::iterator
+basic_soa_vector<Alloc, GrowthPolicy, Ts...>::begin() {
+  return iterator(column_data(column_indices()), 0);
+}
+
+template <class Alloc, class GrowthPolicy, class... Ts>
+typename basic_soa_vector<Alloc, GrowthPolicy, Ts...>::const_iterator
+basic_soa_vector<Alloc, GrowthPolicy, Ts...>::begin() const {
+  return const_iterator(column_data(column_indices()), 0);
+}
+
+template <class Alloc, class GrowthPolicy, class... Ts>
+typename basic_soa_vector<Alloc, GrowthPolicy, Ts...>::const_iterator
+basic_soa_vector<Alloc, GrowthPolicy, Ts...>::cbegin() const {
+  return begin();
+}
+
+template <class Alloc, class GrowthPolicy, class... Ts>
+typename basic_soa_vector<Alloc, GrowthPolicy, Ts...>::iterator
+basic_soa_vector<Alloc, GrowthPolicy, Ts...>::end() {
+  return iterator(column_data(column_indices()),
+                  static_cast<difference_type>(size_));
+}
+
+template <class Alloc, class GrowthPolicy, class... Ts>
+typename basic_soa_vector<Alloc, GrowthPolicy, Ts...>::const_iterator
+basic_soa_vector<Alloc, GrowthPolicy, Ts...>::end() const {
+  return const_iterator(column_data(column_indices()),
+                        static_cast<difference_type>(size_));
+}
+
+template <class Alloc, class GrowthPolicy, class... Ts>
+typename basic_soa_vector<Alloc, GrowthPolicy, Ts...>::const_iterator
+basic_soa_vector<Alloc, GrowthPolicy, Ts...>::cend() const {
+  return end();
+}
+
+template <class Alloc, class GrowthPolicy, class... Ts>
+typename basic_soa_vector<Alloc, GrowthPolicy, Ts...>::allocator_type
+basic_soa_vector<Alloc, GrowthPolicy, Ts...>::get_allocator() const {
+  return allocator_type(std::get<0>(columns_).get_allocator());
+}
+
+template <class Alloc, class GrowthPolicy, class... Ts>
+template <class Construct>
+void basic_soa_vector<Alloc, GrowthPolicy, Ts...>::construct_rows(
+    columns_type &columns, size_type first, size_type n, Construct construct) {
+  std::size_t constructed = 0;
+  try {
+    for_each_column([&](auto index) {
+      auto &column = std::get<decltype(index)::value>(columns);
+      construct(index, column, column.begin() + first, n);
+      ++constructed;
+    });
+  } catch (...) {
+    for_each_column([&](auto index) {
+      auto &column = std::get<decltype(index)::value>(columns);
+      if (decltype(index)::value < constructed) {
+        column.destroy(column.begin() + first, column.begin() + (first + n));
+      }
+    });
+    throw;
+  }
+}
+
+template <class Alloc, class GrowthPolicy, class... Ts>
+void basic_soa_vector<Alloc, GrowthPolicy, Ts...>::destroy_rows(
+    columns_type &columns, size_type first, size_type n) {
+  for_each_column([&](auto index) {
+    auto &column = std::get<decltype(index)::value>(columns);
+    column.destroy(column.begin() + first, column.begin() + (first + n));
+  });
+}
+
+template <class Alloc, class GrowthPolicy, class... Ts>
+template <class Construct>
+void basic_soa_vector<Alloc, GrowthPolicy, Ts...>::append(
+    size_type n, Construct construct) {
+  if (n > capacity() - size_) {
+    reallocate_append(next_capacity(size_ + n), n, construct);
+  } else {
+    construct_rows(columns_, size_, n, construct);
+    size_ += n;
+  }
+}
+
+template <class Alloc, class GrowthPolicy, class... Ts>
+template <class Construct>
+void basic_soa_vector<Alloc, GrowthPolicy, Ts...>::reallocate_append(
+    size_type new_capacity, size_type n, Construct construct) {
+  columns_type new_columns = make_columns(get_allocator());
+  for_each_column([&](auto index) {
+    std::get<decltype(index)::value>(new_columns).allocate(new_capacity);
+  });
+
+  construct_rows(new_columns, size_, n, construct);
+
+  try {
+    relocate_rows(new_columns);
+  } catch (...) {
+    destroy_rows(new_columns, size_, n);
+    throw;
+  }
+
+  // Frees the old buffers, their elements were relocated above
+  for_each_column([&](auto index) {
+    std::get<decltype(index)::value>(columns_) =
+        std::move(std::get<decltype(index)::value>(new_columns));
+  });
+  size_ += n;
+}
+
+template <class Alloc, class GrowthPolicy, class... Ts>
+void basic_soa_vector<Alloc, GrowthPolicy, Ts...>::relocate_rows(
+    columns_type &new_columns) {
+  // Copy the fields, whose move may throw, first. Once they all succeeded,
+  // the remaining fields are relocated, which can't throw
+  std::size_t copied = 0;
+  try {
+    for_each_column([&](auto index) {
+      constexpr std::size_t I = decltype(index)::value;
+      if constexpr (!is_nothrow_relocatable<column_type<I>>) {
+        auto &source = std::get<I>(columns_);
+        std::get<I>(new_columns)
+            .uninitialized_copy(source.begin(), source.begin() + size_,
+                                std::get<I>(new_columns).begin());
+      }
+      ++copied;
+    });
+  } catch (...) {
+    for_each_column([&](auto index) {
+      constexpr std::size_t I = decltype(index)::value;
+      if constexpr (!is_nothrow_relocatable<column_type<I>>) {
+        auto &column = std::get<I>(new_columns);
+        if (I < copied) {
+          column.destroy(column.begin(), column.begin() + size_);
+        }
+      }
+    });
+    throw;
+  }
+
+  for_each_column([&](auto index) {
+    constexpr std::size_t I = decltype(index)::value;
+    auto &source = std::get<I>(columns_);
+    if constexpr (is_nothrow_relocatable<column_type<I>>) {
+      source.relocate(source.begin(), source.begin() + size_,
+                      std::get<I>(new_columns).begin());
+    } else {
+      source.destroy(source.begin(), source.begin() + size_);
+    }
+  });
+}
+
+template <class Alloc, class GrowthPolicy, class... Ts>
+template <class Tuple>
+typename basic_soa_vector<Alloc, GrowthPolicy, Ts...>::reference
+basic_soa_vector<Alloc, GrowthPolicy, Ts...>::emplace_from_tuple(Tuple &&row) {
+  append(1, [&row](auto index, auto &column, auto pos, size_type) {
+    column.construct(pos,
+                     std::get<decltype(index)::value>(std::forward<Tuple>(row)));
+  });
+  return (*this)[size_ - 1];
+}
+
+template <class Alloc, class GrowthPolicy, class... Ts>
+typename basic_soa_vector<Alloc, GrowthPolicy, Ts...>::size_type
+basic_soa_vector<Alloc, GrowthPolicy, Ts...>::next_capacity(
+    size_type required) const {
+  if (required > max_size() || required < size_) {
+    throw std::length_error("soa_vector: required capacity exceeds "
+                            "max_size()");
+  }
+
+  const size_type new_capacity =
+      static_cast<size_type>(GrowthPolicy::next_capacity(capacity(), required));
+
+  return std::min(std::max(new_capacity, required), max_size());
+}
+
+template <class Alloc, class GrowthPolicy, class... Ts>
+typename basic_soa_vector<Alloc, GrowthPolicy, Ts...>::columns_type
+basic_soa_vector<Alloc, GrowthPolicy, Ts...>::make_columns(const Alloc &alloc) {
+  return columns_type(column_allocator<Ts>(alloc)...);
+}
+
+template <class Alloc, class GrowthPolicy, class... Ts>
+template <class Function>
+void basic_soa_vector<Alloc, GrowthPolicy, Ts...>::for_each_column(
+    Function f) {
+  for_each_column(f, column_indices());
+}
+
+template <class Alloc, class GrowthPolicy, class... Ts>
+template <class Function, std::size_t... Is>
+void basic_soa_vector<Alloc, GrowthPolicy, Ts...>::for_each_column(
+    Function f, std::index_sequence<Is...>) {
+  (f(std::integral_constant<std::size_t, Is>()), ...);
+}
+
+template <class Alloc, class GrowthPolicy, class... Ts>
+template <std::size_t... Is>
+std::tuple<Ts *...> basic_soa_vector<Alloc, GrowthPolicy, Ts...>::column_data(
+    std::index_sequence<Is...>) {
+  return std::tuple<Ts *...>(std::get<Is>(columns_).data()...);
+}
+
+template <class Alloc, class GrowthPolicy, class... Ts>
+template <std::size_t... Is>
+std::tuple<const Ts *...>
+basic_soa_vector<Alloc, GrowthPolicy, Ts...>::column_data(
+    std::index_sequence<Is...>) const {
+  return std::tuple<const Ts *...>(std::get<Is>(columns_).data()...);
+}
+
+} // namespace mem
@@ -0,0 +1,747 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "base_vector.hpp"
+#include "compact.hpp"
+#include "normal_iterator.hpp"
+
+namespace mem {
+namespace overflow {
+
+/// Throw std::length_error, if a static_vector would exceed its capacity
+struct throw_length_error {
+  static constexpr void check(bool fits, const char *what) {
+    if (!fits) {
+      throw std::length_error(what);
+    }
+  }
+};
+
+/// Check the capacity with assert only, i.e. not at all if NDEBUG is defined.
+/// For hot paths, which bound the number of elements themselves
+struct assert_capacity {
+  static constexpr void check(bool fits, const char *what) {
+    static_cast<void>(what);
+    assert(fits && "static_vector: capacity exceeded");
+  }
+};
+
+} // namespace overflow
+
+namespace detail {
+
+/// Tag to value initialize the whole buffer of a static_vector, which makes it
+/// usable in constant expressions
+struct value_init_t {
+  explicit value_init_t() = default;
+};
+
+/// Memory for N elements of type T, which are constructed and destroyed by
+/// the owner. Trivial types are kept in a plain array, constructing them is an
+/// assignment, so they can be used in constant expressions
+template <class T, std::size_t N,
+          bool = std::is_trivial_v<T> && std::is_trivially_move_assignable_v<T>,
+          bool = std::is_trivially_destructible_v<T>>
+struct uninitialized_array {
+  union {
+    T data[N];
+  };
+
+  uninitialized_array() {}
+
+  explicit uninitialized_array(value_init_t) {}
+
+  ~uninitialized_array() {}
+
+  template <class... Args> T &construct(std::size_t idx, Args &&...args) {
+    return *::new (static_cast<void *>(data + idx))
+        T(std::forward<Args>(args)...);
+  }
+
+  void default_construct(std::size_t first, std::size_t last) {
+    std::uninitialized_default_construct(data + first, data + last);
+  }
+
+  void destroy(std::size_t first, std::size_t last) {
+    std::destroy(data + first, data + last);
+  }
+};
+
+template <class T, std::size_t N>
+struct uninitialized_array<T, N, false, true> {
+  union {
+    T data[N];
+  };
+
+  uninitialized_array() {}
+
+  explicit uninitialized_array(value_init_t) {}
+
+  template <class... Args> T &construct(std::size_t idx, Args &&...args) {
+    return *::new (static_cast<void *>(data + idx))
+        T(std::forward<Args>(args)...);
+  }
+
+  void default_construct(std::size_t first, std::size_t last) {
+    std::uninitialized_default_construct(data + first, data + last);
+  }
+
+  void destroy(std::size_t, std::size_t) {}
+};
+
+template <class T, std::size_t N> struct uninitialized_array<T, N, true, true> {
+  T data[N];
+
+  uninitialized_array() = default;
+
+  constexpr explicit uninitialized_array(value_init_t) : data{} {}
+
+  template <class... Args>
+  constexpr T &construct(std::size_t idx, Args &&...args) {
+    data[idx] = T(std::forward<Args>(args)...);
+    return data[idx];
+  }
+
+  constexpr void default_construct(std::size_t, std::size_t) {}
+
+  constexpr void destroy(std::size_t, std::size_t) {}
+};
+
+/// Elements and size of a static_vector. Copying, moving and destroying it is
+/// trivial, if it is for T
+template <class T, std::size_t N, bool = std::is_trivially_copyable_v<T>>
+struct static_vector_base {
+  uninitialized_array<T, N> elements_;
+  std::size_t size_ = 0;
+
+  static_vector_base() = default;
+
+  constexpr explicit static_vector_base(value_init_t tag) : elements_(tag) {}
+};
+
+template <class T, std::size_t N> struct static_vector_base<T, N, false> {
+  uninitialized_array<T, N> elements_;
+  std::size_t size_ = 0;
+
+  static_vector_base() = default;
+
+  explicit static_vector_base(value_init_t tag) : elements_(tag) {}
+
+  static_vector_base(const static_vector_base &other) {
+    construct_from(other.elements_.data, other.size_);
+  }
+
+  static_vector_base(static_vector_base &&other) noexcept(
+      std::is_nothrow_move_constructible_v<T>) {
+    construct_from(std::make_move_iterator(other.elements_.data), other.size_);
+  }
+
+  static_vector_base &operator=(const static_vector_base &other) {
+    if (this != &other) {
+      assign_from(other.elements_.data, other.size_);
+    }
+    return *this;
+  }
+
+  static_vector_base &operator=(static_vector_base &&other) noexcept(
+      std::is_nothrow_move_constructible_v<T> &&
+      std::is_nothrow_move_assignable_v<T>) {
+    if (this != &other) {
+      assign_from(std::make_move_iterator(other.elements_.data), other.size_);
+    }
+    return *this;
+  }
+
+  ~static_vector_base() { elements_.destroy(0, size_); }
+
+private:
+  /// Construct n elements from first in the empty vector. If a constructor
+  /// throws, the ones constructed before are destroyed
+  template <class Iterator> void construct_from(Iterator first, std::size_t n) {
+    try {
+      for (; size_ < n; ++size_, ++first) {
+        elements_.construct(size_, *first);
+      }
+    } catch (...) {
+      elements_.destroy(0, size_);
+      throw;
+    }
+  }
+
+  /// Assign to the existing elements, construct or destroy the remaining ones
+  template <class Iterator> void assign_from(Iterator first, std::size_t n) {
+    for (std::size_t i = 0; i < std::min(size_, n); ++i, ++first) {
+      elements_.data[i] = *first;
+    }
+
+    if (n < size_) {
+      elements_.destroy(n, size_);
+      size_ = n;
+    } else {
+      for (; size_ < n; ++size_, ++first) {
+        elements_.construct(size_, *first);
+      }
+    }
+  }
+};
+
+} // namespace detail
+
+/**
+ * @brief Vector of up to N elements, which are stored inline, i.e. it never
+ * allocates and has no allocator. It offers the base_vector interface, except
+ * for the allocator, with a capacity fixed at N.
+ *
+ * A static_vector of a trivially copyable T is trivially copyable itself, so
+ * it can be copied with memcpy (e.g. as part of a packet). Copying or moving
+ * it otherwise copies or moves the elements one by one, the source of a move
+ * keeps its (moved from) elements.
+ *
+ * For trivial types T, the vector can be used in constant expressions, e.g.
+ * to build a table at compile time. The constructors taking a size or values
+ * value initialize the whole buffer for that, the default constructor leaves
+ * it uninitialized. Only the members, which don't take iterators, are
+ * constexpr.
+ *
+ * Exceeding the capacity is handled by OverflowPolicy: overflow::
+ * throw_length_error throws std::length_error, like base_vector beyond
+ * max_size(); overflow::assert_capacity only checks with assert, for hot paths
+ * which bound the number of elements themselves.
+ *
+ * @tparam T type of the stored elements
+ * @tparam N capacity
+ * @tparam OverflowPolicy check applied, before the capacity is exceeded
+ */
+template <class T, std::size_t N,
+          class OverflowPolicy = overflow::throw_length_error>
+class static_vector : private detail::static_vector_base<T, N> {
+  static_assert(N > 0, "static_vector needs a capacity larger than 0");
+
+private:
+  using base_type = detail::static_vector_base<T, N>;
+
+public:
+  using value_type = T;
+
+  using reference = T &;
+  using const_reference = const T &;
+
+  using pointer = T *;
+  using const_pointer = const T *;
+
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+
+  using overflow_policy = OverflowPolicy;
+
+  using iterator = iter::normal_iterator<T>;
+  using const_iterator = iter::normal_iterator<T>;
+
+  /// Number of elements, which can be stored
+  static constexpr size_type static_capacity = N;
+
+  /// create empty vector
+  static_vector() = default;
+
+  /// create vector of size n, with value initialized values
+  constexpr explicit static_vector(size_type n);
+
+  /// create vector of size n, with default initialized values, i.e. trivial
+  /// types are left uninitialized, for buffers which are overwritten anyway
+  static_vector(default_init_t, size_type n);
+
+  /// create vector of size n, with copies of value
+  constexpr static_vector(size_type n, const value_type &value);
+
+  /// Construct static_vector from iterator range
+  template <typename InputIter,
+            typename = std::enable_if_t<!std::is_integral_v<InputIter>>>
+  static_vector(InputIter first, InputIter last);
+
+  /// Construct static_vector from the given values
+  constexpr static_vector(std::initializer_list<value_type> values);
+
+  /// Shrink or grow current size, new elements are value initialized
+  constexpr void resize(size_type new_size);
+
+  /// Shrink or grow current size, new elements will have the given value
+  constexpr void resize(size_type new_size, const value_type &value);
+
+  /// Shrink or grow current size, new elements are default initialized, i.e.
+  /// trivial types are left uninitialized. For buffers, which are overwritten
+  /// right away (e.g. by a read from a socket)
+  void resize_for_overwrite(size_type new_size);
+
+  /// Append a copy of value
+  constexpr void push_back(const value_type &value);
+
+  /// Append value by moving it
+  constexpr void push_back(value_type &&value);
+
+  /// Append an element constructed in place from args
+  template <class... Args> constexpr reference emplace_back(Args &&...args);
+
+  /// Remove the last element, the vector must not be empty
+  constexpr void pop_back();
+
+  /// return the current number of elements
+  constexpr size_type size() const;
+
+  /// The capacity N
+  constexpr size_type max_size() const;
+
+  /// Check, that new_capacity elements fit (see OverflowPolicy), nothing is
+  /// allocated
+  constexpr void reserve(size_type new_capacity) const;
+
+  /// The capacity N
+  constexpr size_type capacity() const;
+
+  /// subscript operator to access a mutable reference
+  constexpr reference operator[](size_type idx);
+
+  /// subscript operator to access a immutable reference
+  constexpr const_reference operator[](size_type idx) const;
+
+  iterator begin();
+
+  const_iterator begin() const;
+
+  const_iterator cbegin() const;
+
+  iterator end();
+
+  const_iterator end() const;
+
+  const_iterator cend() const;
+
+  constexpr pointer data();
+
+  constexpr const_pointer data() const;
+
+  /// returns true iff size() == 0
+  constexpr bool empty() const;
+
+  /// Destroy all elements
+  constexpr void clear();
+
+  /// Swap elements of this vector with given vector, O(N)
+  void swap(static_vector &v);
+
+  /// Replace the elements by n copies of value
+  constexpr void assign(size_type n, const value_type &value);
+
+  /// Make static_vector a copy of given range
+  template <class InputIter,
+            typename = std::enable_if_t<!std::is_integral_v<InputIter>>>
+  void assign(InputIter first, InputIter last);
+
+  iterator erase(iterator pos);
+
+  iterator erase(iterator first, iterator last);
+
+  /// Erase the elements, for which mask is true, in a single pass. mask is a
+  /// range of size() values convertible to bool (e.g. std::vector<bool>).
+  /// Returns the number of erased elements
+  template <class MaskRange,
+            typename = std::enable_if_t<
+                !std::is_convertible_v<const MaskRange &, iterator>>>
+  size_type erase(const MaskRange &mask);
+
+  /// Insert a copy of value before pos, returns an iterator to it
+  iterator insert(iterator pos, const value_type &value);
+
+  /// Insert value before pos by moving it, returns an iterator to it
+  iterator insert(iterator pos, value_type &&value);
+
+  /// Insert n copies of value before pos, returns an iterator to the first
+  iterator insert(iterator pos, size_type n, const value_type &value);
+
+  /// Insert a copy of [first, last) before pos, returns an iterator to the
+  /// first inserted element. [first, last) must not refer to this vector
+  template <class InputIter,
+            typename = std::enable_if_t<!std::is_integral_v<InputIter>>>
+  iterator insert(iterator pos, InputIter first, InputIter last);
+
+  /// Insert an element constructed in place from args before pos, returns an
+  /// iterator to it
+  template <class... Args> iterator emplace(iterator pos, Args &&...args);
+
+private:
+  /// Destroy the elements from index new_size on
+  constexpr void truncate(size_type new_size);
+
+  /// Rotate the elements from index first on into place before pos. The new
+  /// elements are appended first, such that arguments referring to elements
+  /// of this vector stay valid while they are constructed
+  iterator rotate_into_place(iterator pos, size_type first);
+};
+
+template <class T, std::size_t N, class OverflowPolicy>
+constexpr static_vector<T, N, OverflowPolicy>::static_vector(size_type n)
+    : base_type(detail::value_init_t{}) {
+  resize(n);
+}
+
+template <class T, std::size_t N, class OverflowPolicy>
+static_vector<T, N, OverflowPolicy>::static_vector(default_init_t, size_type n)
+    : static_vector() {
+  resize_for_overwrite(n);
+}
+
+template <class T, std::size_t N, class OverflowPolicy>
+constexpr static_vector<T, N, OverflowPolicy>::static_vector(
+    size_type n, const value_type &value)
+    : base_type(detail::value_init_t{}) {
+  assign(n, value);
+}
+
+template <class T, std::size_t N, class OverflowPolicy>
+template <typename InputIter, typename>
+static_vector<T, N, OverflowPolicy>::static_vector(InputIter first,
+                                                   InputIter last)
+    : static_vector() {
+  assign(first, last);
+}
+
+template <class T, std::size_t N, class OverflowPolicy>
+constexpr static_vector<T, N, OverflowPolicy>::static_vector(
+    std::initializer_list<value_type> values)
+    : base_type(detail::value_init_t{}) {
+  OverflowPolicy::check(values.size() <= N,
+                        "static_vector: initializer list exceeds capacity");
+  for (const value_type &value : values) {
+    this->elements_.construct(this->size_, value);
+    ++this->size_;
+  }
+}
+
+template <class T, std::size_t N, class OverflowPolicy>
+constexpr void
+static_vector<T, N, OverflowPolicy>::resize(size_type new_size) {
+  OverflowPolicy::check(new_size <= N, "static_vector::resize: new size "
+                                       "exceeds capacity");
+  if (new_size < this->size_) {
+    truncate(new_size);
+  } else {
+    for (; this->size_ < new_size; ++this->size_) {
+      this->elements_.construct(this->size_);
+    }
+  }
+}
+
+template <class T, std::size_t N, class OverflowPolicy>
+constexpr void
+static_vector<T, N, OverflowPolicy>::resize(size_type new_size,
+                                            const value_type &value) {
+  OverflowPolicy::check(new_size <= N, "static_vector::resize: new size "
+                                       "exceeds capacity");
+  if (new_size < this->size_) {
+    truncate(new_size);
+  } else {
+    for (; this->size_ < new_size; ++this->size_) {
+      this->elements_.construct(this->size_, value);
+    }
+  }
+}
+
+template <class T, std::size_t N, class OverflowPolicy>
+void static_vector<T, N, OverflowPolicy>::resize_for_overwrite(
+    size_type new_size) {
+  OverflowPolicy::check(new_size <= N, "static_vector::resize_for_overwrite: "
+                                       "new size exceeds capacity");
+  if (new_size < this->size_) {
+    this->elements_.destroy(new_size, this->size_);
+  } else {
+    this->elements_.default_construct(this->size_, new_size);
+  }
+  this->size_ = new_size;
+}
+
+template <class T, std::size_t N, class OverflowPolicy>
+constexpr void
+static_vector<T, N, OverflowPolicy>::push_back(const value_type &value) {
+  emplace_back(value);
+}
+
+template <class T, std::size_t N, class OverflowPolicy>
+constexpr void
+static_vector<T, N, OverflowPolicy>::push_back(value_type &&value) {
+  emplace_back(std::move(value));
+}
+
+template <class T, std::size_t N, class OverflowPolicy>
+template <class... Args>
+constexpr typename static_vector<T, N, OverflowPolicy>::reference
+static_vector<T, N, OverflowPolicy>::emplace_back(Args &&...args) {
+  OverflowPolicy::check(this->size_ < N, "static_vector::emplace_back: "
+                                         "capacity exceeded");
+  reference element =
+      this->elements_.construct(this->size_, std::forward<Args>(args)...);
+  ++this->size_;
+  return element;
+}
+
+template <class T, std::size_t N, class OverflowPolicy>
+constexpr void static_vector<T, N, OverflowPolicy>::pop_back() {
+  truncate(this->size_ - 1);
+}
+
+template <class T, std::size_t N, class OverflowPolicy>
+constexpr typename static_vector<T, N, OverflowPolicy>::size_type
+static_vector<T, N, OverflowPolicy>::size() const {
+  return this->size_;
+}
+
+template <class T, std::size_t N, class OverflowPolicy>
+constexpr typename static_vector<T, N, OverflowPolicy>::size_type
+static_vector<T, N, OverflowPolicy>::max_size() const {
+  return N;
+}
+
+template <class T, std::size_t N, class OverflowPolicy>
+constexpr void
+static_vector<T, N, OverflowPolicy>::reserve(size_type new_capacity) const {
+  OverflowPolicy::check(new_capacity <= N, "static_vector::reserve: requested "
+                                           "capacity exceeds capacity");
+}
+
+template <class T, std::size_t N, class OverflowPolicy>
+constexpr typename static_vector<T, N, OverflowPolicy>::size_type
+static_vector<T, N, OverflowPolicy>::capacity() const {
+  return N;
+}
+
+template <class T, std::size_t N, class OverflowPolicy>
+constexpr typename static_vector<T, N, OverflowPolicy>::reference
+static_vector<T, N, OverflowPolicy>::operator[](size_type idx) {
+  return this->elements_.data[idx];
+}
+
+template <class T, std::size_t N, class OverflowPolicy>
+constexpr typename static_vector<T, N, OverflowPolicy>::const_reference
+static_vector<T, N, OverflowPolicy>::operator[](size_type idx) const {
+  return this->elements_.data[idx];
+}
+
+template <class T, std::size_t N, class OverflowPolicy>
+typename static_vector<T, N, OverflowPolicy>::iterator
+static_vector<T, N, OverflowPolicy>::begin() {
+  return iterator(data());
+}
+
+template <class T, std::size_t N, class OverflowPolicy>
+typename static_vector<T, N, OverflowPolicy>::const_iterator
+static_vector<T, N, OverflowPolicy>::begin() const {
+  // iterator and const_iterator are the same type, like for base_vector
+  return const_iterator(const_cast<pointer>(data()));
+}
+
+template <class T, std::size_t N, class OverflowPolicy>
+typename static_vector<T, N, OverflowPolicy>::const_iterator
+static_vector<T, N, OverflowPolicy>::cbegin() const {
+  return begin();
+}
+
+template <class T, std::size_t N, class OverflowPolicy>
+typename static_vector<T, N, OverflowPolicy>::iterator
+static_vector<T, N, OverflowPolicy>::end() {
+  return begin() + static_cast<difference_type>(this->size_);
+}
+
+template <class T, std::size_t N, class OverflowPolicy>
+typename static_vector<T, N, OverflowPolicy>::const_iterator
+static_vector<T, N, OverflowPolicy>::end() const {
+  return begin() + static_cast<difference_type>(this->size_);
+}
+
+template <class T, std::size_t N, class OverflowPolicy>
+typename static_vector<T, N, OverflowPolicy>::const_iterator
+static_vector<T, N, OverflowPolicy>::cend() const {
+  return end();
+}
+
+template <class T, std::size_t N, class OverflowPolicy>
+constexpr typename static_vector<T, N, OverflowPolicy>::pointer
+static_vector<T, N, OverflowPolicy>::data() {
+  return this->elements_.data;
+}
+
+template <class T, std::size_t N, class OverflowPolicy>
+constexpr typename static_vector<T, N, OverflowPolicy>::const_pointer
+static_vector<T, N, OverflowPolicy>::data() const {
+  return this->elements_.data;
+}
+
+template <class T, std::size_t N, class OverflowPolicy>
+constexpr bool static_vector<T, N, OverflowPolicy>::empty() const {
+  return this->size_ == 0;
+}
+
+template <class T, std::size_t N, class OverflowPolicy>
+constexpr void static_vector<T, N, OverflowPolicy>::clear() {
+  truncate(0);
+}
+
+template <class T, std::size_t N, class OverflowPolicy>
+void static_vector<T, N, OverflowPolicy>::swap(static_vector &v) {
+  static_vector &shorter = this->size_ < v.size_ ? *this : v;
+  static_vector &longer = this->size_ < v.size_ ? v : *this;
+  const size_type n = shorter.size_;
+
+  std::swap_ranges(shorter.data(), shorter.data() + n, longer.data());
+
+  // Move the remaining elements of the longer vector over
+  for (; shorter.size_ < longer.size_; ++shorter.size_) {
+    shorter.elements_.construct(shorter.size_,
+                                std::move(longer.elements_.data[shorter.size_]));
+  }
+  longer.truncate(n);
+}
+
+template <class T, std::size_t N, class OverflowPolicy>
+constexpr void
+static_vector<T, N, OverflowPolicy>::assign(size_type n,
+                                            const value_type &value) {
+  OverflowPolicy::check(n <= N, "static_vector::assign: size exceeds "
+                                "capacity");
+  const size_type common = std::min(this->size_, n);
+  for (size_type i = 0; i < common; ++i) {
+    this->elements_.data[i] = value;
+  }
+  resize(n, value);
+}
+
+template <class T, std::size_t N, class OverflowPolicy>
+template <class InputIter, typename>
+void static_vector<T, N, OverflowPolicy>::assign(InputIter first,
+                                                 InputIter last) {
+  using category = typename std::iterator_traits<InputIter>::iterator_category;
+  if constexpr (std::is_base_of_v<std::forward_iterator_tag, category>) {
+    OverflowPolicy::check(static_cast<size_type>(std::distance(first, last)) <=
+                              N,
+                          "static_vector::assign: range exceeds capacity");
+  }
+
+  size_type i = 0;
+
+  // Overwrite existing elements first
+  for (; first != last && i < this->size_; ++i, ++first) {
+    this->elements_.data[i] = *first;
+  }
+
+  if (first == last) {
+    truncate(i);
+  } else {
+    for (; first != last; ++first) {
+      emplace_back(*first);
+    }
+  }
+}
+
+template <class T, std::size_t N, class OverflowPolicy>
+typename static_vector<T, N, OverflowPolicy>::iterator
+static_vector<T, N, OverflowPolicy>::erase(iterator pos) {
+  return erase(pos, pos + 1);
+}
+
+template <class T, std::size_t N, class OverflowPolicy>
+typename static_vector<T, N, OverflowPolicy>::iterator
+static_vector<T, N, OverflowPolicy>::erase(iterator first, iterator last) {
+  const auto new_end = std::move(last, end(), first);
+  truncate(static_cast<size_type>(new_end - begin()));
+  return first;
+}
+
+template <class T, std::size_t N, class OverflowPolicy>
+template <class MaskRange, typename>
+typename static_vector<T, N, OverflowPolicy>::size_type
+static_vector<T, N, OverflowPolicy>::erase(const MaskRange &mask) {
+  auto erased = std::begin(mask);
+  pointer kept_end = compact(data(), data() + this->size_,
+                             [&erased](size_type) {
+                               return !static_cast<bool>(*erased++);
+                             });
+
+  const auto n = static_cast<size_type>(data() + this->size_ - kept_end);
+  truncate(this->size_ - n);
+  return n;
+}
+
+template <class T, std::size_t N, class OverflowPolicy>
+typename static_vector<T, N, OverflowPolicy>::iterator
+static_vector<T, N, OverflowPolicy>::insert(iterator pos,
+                                            const value_type &value) {
+  return emplace(pos, value);
+}
+
+template <class T, std::size_t N, class OverflowPolicy>
+typename static_vector<T, N, OverflowPolicy>::iterator
+static_vector<T, N, OverflowPolicy>::insert(iterator pos, value_type &&value) {
+  return emplace(pos, std::move(value));
+}
+
+template <class T, std::size_t N, class OverflowPolicy>
+typename static_vector<T, N, OverflowPolicy>::iterator
+static_vector<T, N, OverflowPolicy>::insert(iterator pos, size_type n,
+                                            const value_type &value) {
+  OverflowPolicy::check(n <= N - this->size_, "static_vector::insert: "
+                                              "capacity exceeded");
+  const size_type first = this->size_;
+  resize(this->size_ + n, value);
+  return rotate_into_place(pos, first);
+}
+
+template <class T, std::size_t N, class OverflowPolicy>
+template <class InputIter, typename>
+typename static_vector<T, N, OverflowPolicy>::iterator
+static_vector<T, N, OverflowPolicy>::insert(iterator pos, InputIter first,
+                                            InputIter last) {
+  using category = typename std::iterator_traits<InputIter>::iterator_category;
+  if constexpr (std::is_base_of_v<std::forward_iterator_tag, category>) {
+    OverflowPolicy::check(static_cast<size_type>(std::distance(first, last)) <=
+                              N - this->size_,
+                          "static_vector::insert: capacity exceeded");
+  }
+
+  const size_type appended = this->size_;
+  for (; first != last; ++first) {
+    emplace_back(*first);
+  }
+  return rotate_into_place(pos, appended);
+}
+
+template <class T, std::size_t N, class OverflowPolicy>
+template <class... Args>
+typename static_vector<T, N, OverflowPolicy>::iterator
+static_vector<T, N, OverflowPolicy>::emplace(iterator pos, Args &&...args) {
+  const size_type appended = this->size_;
+  emplace_back(std::forward<Args>(args)...);
+  return rotate_into_place(pos, appended);
+}
+
+template <class T, std::size_t N, class OverflowPolicy>
+constexpr void static_vector<T, N, OverflowPolicy>::truncate(size_type new_size) {
+  this->elements_.destroy(new_size, this->size_);
+  this->size_ = new_size;
+}
+
+template <class T, std::size_t N, class OverflowPolicy>
+typename static_vector<T, N, OverflowPolicy>::iterator
+static_vector<T, N, OverflowPolicy>::rotate_into_place(iterator pos,
+                                                       size_type first) {
+  std::rotate(pos.base(), data() + first, data() + this->size_);
+  return pos;
+}
+
+} // namespace mem
@@ -0,0 +1,422 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "contiguous_storage.hpp"
+
+/// Set to 0 to compile out the recording of statistics_allocator. The
+/// allocator then only forwards to the wrapped allocator, and all statistics
+/// stay zero
+#ifndef MEM_ALLOCATION_STATISTICS
+#define MEM_ALLOCATION_STATISTICS 1
+#endif
+
+namespace mem {
+
+/// Point in time copy of the counters of an allocation_statistics
+struct allocation_snapshot {
+  /// Number of histogram buckets, bucket i counts the allocations of
+  /// [2^i, 2^(i+1)) bytes, bucket 0 includes empty allocations
+  static constexpr std::size_t histogram_buckets = 64;
+
+  std::uint64_t allocations = 0;
+  std::uint64_t deallocations = 0;
+
+  /// Number of blocks grown in place (see try_expand)
+  std::uint64_t expansions = 0;
+
+  std::uint64_t bytes_allocated = 0;
+  std::uint64_t bytes_deallocated = 0;
+
+  std::uint64_t bytes_in_use = 0;
+  std::uint64_t peak_bytes_in_use = 0;
+
+  std::array<std::uint64_t, histogram_buckets> size_histogram{};
+};
+
+/**
+ * @brief Thread safe allocation counters, filled by statistics_allocator.
+ *
+ * The counters are lock free, and sharded by thread (each shard on its own
+ * cache line), so threads allocating concurrently don't contend. Only the
+ * bytes in use are a single shared counter, to track the exact peak.
+ *
+ * Use one instance per container (or group of containers) to attribute
+ * memory, or the global() instance. snapshot() can be called at any time from
+ * any thread, e.g. by a metrics scraper.
+ */
+class allocation_statistics {
+private:
+  static constexpr std::size_t shard_count = 16;
+
+  static constexpr std::size_t cache_line_size = 64;
+
+  struct alignas(cache_line_size) shard {
+    std::atomic<std::uint64_t> allocations{0};
+    std::atomic<std::uint64_t> deallocations{0};
+    std::atomic<std::uint64_t> expansions{0};
+    std::atomic<std::uint64_t> bytes_allocated{0};
+    std::atomic<std::uint64_t> bytes_deallocated{0};
+    std::array<std::atomic<std::uint64_t>,
+               allocation_snapshot::histogram_buckets>
+        size_histogram{};
+  };
+
+  std::array<shard, shard_count> shards_;
+
+  alignas(cache_line_size) std::atomic<std::uint64_t> bytes_in_use_{0};
+  std::atomic<std::uint64_t> peak_bytes_in_use_{0};
+
+public:
+  allocation_statistics() = default;
+
+  allocation_statistics(const allocation_statistics &) = delete;
+
+  allocation_statistics &operator=(const allocation_statistics &) = delete;
+
+  /// Statistics used by default constructed statistics_allocators
+  static allocation_statistics &global();
+
+  /// Record an allocation of bytes
+  void record_allocation(std::size_t bytes) noexcept;
+
+  /// Record a deallocation of bytes
+  void record_deallocation(std::size_t bytes) noexcept;
+
+  /// Record a block grown in place from old_bytes to new_bytes
+  void record_expansion(std::size_t old_bytes, std::size_t new_bytes) noexcept;
+
+  /// Sum of all shards. Taken while other threads allocate, the counters
+  /// aren't necessarily consistent with each other
+  allocation_snapshot snapshot() const noexcept;
+
+  /// Set all counters to zero, the bytes in use are kept
+  void reset() noexcept;
+
+private:
+  /// Shard of the calling thread
+  shard &local_shard() noexcept;
+
+  /// Add bytes to the bytes in use, and update the peak
+  void add_in_use(std::uint64_t bytes) noexcept;
+
+  static std::size_t histogram_bucket(std::size_t bytes) noexcept;
+};
+
+/**
+ * @brief Allocator adaptor, which records all allocations of the wrapped
+ * allocator in an allocation_statistics.
+ *
+ * It forwards everything to Alloc, including the try_expand/try_reallocate
+ * extensions used by contiguous_storage and the alignment of the blocks, so
+ * it can wrap any allocator:
+ *
+ * @code
+ * mem::allocation_statistics stats;
+ * mem::base_vector<int, mem::statistics_allocator<int>> v{
+ *     mem::statistics_allocator<int>(stats)};
+ * v.push_back(1);
+ * auto snapshot = stats.snapshot(); // snapshot.bytes_in_use == 4
+ * @endcode
+ *
+ * Allocators recording into different statistics compare unequal. If Alloc
+ * is always equal, the statistics propagate on move assignment and swap
+ * together with the buffer, otherwise the propagation traits of Alloc apply.
+ *
+ * If MEM_ALLOCATION_STATISTICS is 0, nothing is recorded.
+ *
+ * @tparam T type of the allocated elements
+ * @tparam Alloc wrapped allocator
+ */
+template <class T, class Alloc = std::allocator<T>>
+class statistics_allocator {
+private:
+  using alloc_traits = std::allocator_traits<Alloc>;
+
+public:
+  using value_type = T;
+
+  using pointer = typename alloc_traits::pointer;
+  using const_pointer = typename alloc_traits::const_pointer;
+
+  using size_type = typename alloc_traits::size_type;
+  using difference_type = typename alloc_traits::difference_type;
+
+  // A buffer has to be deallocated through the statistics it was allocated
+  // with, so the statistics move with the buffer, if Alloc allows it
+  using propagate_on_container_copy_assignment =
+      typename alloc_traits::propagate_on_container_copy_assignment;
+  using propagate_on_container_move_assignment = std::integral_constant<
+      bool, alloc_traits::is_always_equal::value ||
+                alloc_traits::propagate_on_container_move_assignment::value>;
+  using propagate_on_container_swap = std::integral_constant<
+      bool, alloc_traits::is_always_equal::value ||
+                alloc_traits::propagate_on_container_swap::value>;
+  using is_always_equal = std::false_type;
+
+  using inner_allocator_type = Alloc;
+
+  template <class U> struct rebind {
+    using other = statistics_allocator<
+        U, typename alloc_traits::template rebind_alloc<U>>;
+  };
+
+  /// Alignment of the blocks returned by Alloc (see
+  /// detail::allocator_alignment)
+  static constexpr std::size_t alignment =
+      detail::allocator_alignment<Alloc>::value;
+
+private:
+  allocation_statistics *statistics_;
+
+  Alloc alloc_;
+
+public:
+  /// Allocator recording into the global statistics
+  statistics_allocator() noexcept(noexcept(Alloc()));
+
+  explicit statistics_allocator(allocation_statistics &statistics,
+                                const Alloc &alloc = Alloc());
+
+  template <class U, class OtherAlloc>
+  statistics_allocator(const statistics_allocator<U, OtherAlloc> &other);
+
+  pointer allocate(size_type n);
+
+  void deallocate(pointer p, size_type n);
+
+  /// Forwards to the try_expand extension of Alloc, only available, if Alloc
+  /// provides it
+  template <class A = Alloc>
+  auto try_expand(pointer p, size_type old_n, size_type new_n)
+      -> decltype(bool(std::declval<A &>().try_expand(p, old_n, new_n)));
+
+  /// Forwards to the try_reallocate extension of Alloc, only available, if
+  /// Alloc provides it
+  template <class A = Alloc>
+  auto try_reallocate(pointer p, size_type old_n, size_type new_n)
+      -> decltype(pointer(std::declval<A &>().try_reallocate(p, old_n,
+                                                             new_n)));
+
+  statistics_allocator select_on_container_copy_construction() const;
+
+  allocation_statistics &statistics() const noexcept;
+
+  const Alloc &inner_allocator() const noexcept;
+};
+
+inline allocation_statistics &allocation_statistics::global() {
+  static allocation_statistics statistics;
+  return statistics;
+}
+
+inline void
+allocation_statistics::record_allocation(std::size_t bytes) noexcept {
+  shard &s = local_shard();
+  s.allocations.fetch_add(1, std::memory_order_relaxed);
+  s.bytes_allocated.fetch_add(bytes, std::memory_order_relaxed);
+  s.size_histogram[histogram_bucket(bytes)].fetch_add(
+      1, std::memory_order_relaxed);
+
+  add_in_use(bytes);
+}
+
+inline void
+allocation_statistics::record_deallocation(std::size_t bytes) noexcept {
+  shard &s = local_shard();
+  s.deallocations.fetch_add(1, std::memory_order_relaxed);
+  s.bytes_deallocated.fetch_add(bytes, std::memory_order_relaxed);
+
+  bytes_in_use_.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+inline void
+allocation_statistics::record_expansion(std::size_t old_bytes,
+                                        std::size_t new_bytes) noexcept {
+  // Counted as if the block was reallocated, but without an allocation
+  shard &s = local_shard();
+  s.expansions.fetch_add(1, std::memory_order_relaxed);
+  s.bytes_allocated.fetch_add(new_bytes, std::memory_order_relaxed);
+  s.bytes_deallocated.fetch_add(old_bytes, std::memory_order_relaxed);
+
+  add_in_use(new_bytes - old_bytes);
+}
+
+inline allocation_snapshot allocation_statistics::snapshot() const noexcept {
+  allocation_snapshot result;
+
+  for (const auto &s : shards_) {
+    result.allocations += s.allocations.load(std::memory_order_relaxed);
+    result.deallocations += s.deallocations.load(std::memory_order_relaxed);
+    result.expansions += s.expansions.load(std::memory_order_relaxed);
+    result.bytes_allocated +=
+        s.bytes_allocated.load(std::memory_order_relaxed);
+    result.bytes_deallocated +=
+        s.bytes_deallocated.load(std::memory_order_relaxed);
+
+    for (std::size_t i = 0; i < result.size_histogram.size(); ++i) {
+      result.size_histogram[i] +=
+          s.size_histogram[i].load(std::memory_order_relaxed);
+    }
+  }
+
+  result.bytes_in_use = bytes_in_use_.load(std::memory_order_relaxed);
+  result.peak_bytes_in_use =
+      peak_bytes_in_use_.load(std::memory_order_relaxed);
+
+  return result;
+}
+
+inline void allocation_statistics::reset() noexcept {
+  for (auto &s : shards_) {
+    s.allocations.store(0, std::memory_order_relaxed);
+    s.deallocations.store(0, std::memory_order_relaxed);
+    s.expansions.store(0, std::memory_order_relaxed);
+    s.bytes_allocated.store(0, std::memory_order_relaxed);
+    s.bytes_deallocated.store(0, std::memory_order_relaxed);
+    for (auto &bucket : s.size_histogram) {
+      bucket.store(0, std::memory_order_relaxed);
+    }
+  }
+
+  peak_bytes_in_use_.store(bytes_in_use_.load(std::memory_order_relaxed),
+                           std::memory_order_relaxed);
+}
+
+inline allocation_statistics::shard &
+allocation_statistics::local_shard() noexcept {
+  // Threads are assigned to the shards round robin
+  static std::atomic<std::size_t> next_index{0};
+  thread_local const std::size_t index =
+      next_index.fetch_add(1, std::memory_order_relaxed) % shard_count;
+
+  return shards_[index];
+}
+
+inline void allocation_statistics::add_in_use(std::uint64_t bytes) noexcept {
+  const std::uint64_t in_use =
+      bytes_in_use_.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+
+  std::uint64_t peak = peak_bytes_in_use_.load(std::memory_order_relaxed);
+  while (in_use > peak && !peak_bytes_in_use_.compare_exchange_weak(
+                              peak, in_use, std::memory_order_relaxed)) {
+  }
+}
+
+inline std::size_t
+allocation_statistics::histogram_bucket(std::size_t bytes) noexcept {
+  std::size_t bucket = 0;
+  while (bytes > 1) {
+    bytes >>= 1;
+    ++bucket;
+  }
+  return bucket;
+}
+
+template <class T, class Alloc>
+statistics_allocator<T, Alloc>::statistics_allocator() noexcept(
+    noexcept(Alloc()))
+    : statistics_(&allocation_statistics::global()), alloc_() {}
+
+template <class T, class Alloc>
+statistics_allocator<T, Alloc>::statistics_allocator(
+    allocation_statistics &statistics, const Alloc &alloc)
+    : statistics_(&statistics), alloc_(alloc) {}
+
+template <class T, class Alloc>
+template <class U, class OtherAlloc>
+statistics_allocator<T, Alloc>::statistics_allocator(
+    const statistics_allocator<U, OtherAlloc> &other)
+    : statistics_(&other.statistics()), alloc_(other.inner_allocator()) {}
+
+template <class T, class Alloc>
+typename statistics_allocator<T, Alloc>::pointer
+statistics_allocator<T, Alloc>::allocate(size_type n) {
+  pointer p = alloc_traits::allocate(alloc_, n);
+#if MEM_ALLOCATION_STATISTICS
+  statistics_->record_allocation(n * sizeof(T));
+#endif
+  return p;
+}
+
+template <class T, class Alloc>
+void statistics_allocator<T, Alloc>::deallocate(pointer p, size_type n) {
+#if MEM_ALLOCATION_STATISTICS
+  statistics_->record_deallocation(n * sizeof(T));
+#endif
+  alloc_traits::deallocate(alloc_, p, n);
+}
+
+template <class T, class Alloc>
+template <class A>
+auto statistics_allocator<T, Alloc>::try_expand(pointer p, size_type old_n,
+                                                size_type new_n)
+    -> decltype(bool(std::declval<A &>().try_expand(p, old_n, new_n))) {
+  if (!alloc_.try_expand(p, old_n, new_n)) {
+    return false;
+  }
+#if MEM_ALLOCATION_STATISTICS
+  statistics_->record_expansion(old_n * sizeof(T), new_n * sizeof(T));
+#endif
+  return true;
+}
+
+template <class T, class Alloc>
+template <class A>
+auto statistics_allocator<T, Alloc>::try_reallocate(pointer p,
+                                                    size_type old_n,
+                                                    size_type new_n)
+    -> decltype(pointer(std::declval<A &>().try_reallocate(p, old_n,
+                                                           new_n))) {
+  pointer result = alloc_.try_reallocate(p, old_n, new_n);
+#if MEM_ALLOCATION_STATISTICS
+  if (result) {
+    // The block may have moved, but no copy was made
+    statistics_->record_expansion(old_n * sizeof(T), new_n * sizeof(T));
+  }
+#endif
+  return result;
+}
+
+template <class T, class Alloc>
+statistics_allocator<T, Alloc>
+statistics_allocator<T, Alloc>::select_on_container_copy_construction() const {
+  return statistics_allocator(
+      *statistics_,
+      alloc_traits::select_on_container_copy_construction(alloc_));
+}
+
+template <class T, class Alloc>
+allocation_statistics &
+statistics_allocator<T, Alloc>::statistics() const noexcept {
+  return *statistics_;
+}
+
+template <class T, class Alloc>
+const Alloc &statistics_allocator<T, Alloc>::inner_allocator() const noexcept {
+  return alloc_;
+}
+
+/// Equal, if both record into the same statistics, and the wrapped allocators
+/// are equal
+template <class T, class U, class Alloc, class OtherAlloc>
+bool operator==(const statistics_allocator<T, Alloc> &lhs,
+                const statistics_allocator<U, OtherAlloc> &rhs) {
+  return &lhs.statistics() == &rhs.statistics() &&
+         lhs.inner_allocator() == rhs.inner_allocator();
+}
+
+template <class T, class U, class Alloc, class OtherAlloc>
+bool operator!=(const statistics_allocator<T, Alloc> &lhs,
+                const statistics_allocator<U, OtherAlloc> &rhs) {
+  return !(lhs == rhs);
+}
+
+} // namespace mem
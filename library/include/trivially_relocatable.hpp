@@ -0,0 +1,38 @@
+#pragma once
+
+#include <memory>
+#include <type_traits>
+
+namespace mem {
+
+/**
+ * @brief Trait signalling, that an object of type T can be relocated, i.e.
+ * moved to a new address and the old object destroyed, by copying its bytes.
+ * Relocating such objects is a single memcpy/memmove and no move constructors
+ * or destructors are called for the relocated elements.
+ *
+ * This holds for all trivially copyable types. Many other types (e.g. types
+ * only holding owning pointers or handles) are trivially relocatable as well,
+ * but it can't be detected. Specialize this trait for them to opt in:
+ *
+ * @code
+ * template <>
+ * struct mem::is_trivially_relocatable<my_handle> : std::true_type {};
+ * @endcode
+ *
+ * Don't opt in types which store pointers to themselves or register their
+ * address somewhere.
+ */
+template <class T>
+struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+
+/// std::unique_ptr with the default deleter is only a pointer
+template <class T>
+struct is_trivially_relocatable<std::unique_ptr<T, std::default_delete<T>>>
+    : std::true_type {};
+
+template <class T>
+inline constexpr bool is_trivially_relocatable_v =
+    is_trivially_relocatable<T>::value;
+
+} // namespace mem
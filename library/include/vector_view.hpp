@@ -0,0 +1,432 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#include "base_vector.hpp"
+#include "compact.hpp"
+#include "iterator_facade.hpp"
+#include "overlapped_copy.hpp"
+
+namespace mem {
+
+template <class T> class vector_view;
+
+template <class T> class strided_view;
+
+namespace iter {
+
+/// Random access iterator visiting every stride-th element starting at a
+/// pointer (e.g. the elements of a strided_view). Like zip_iterator, it keeps
+/// the first element and an index, and only computes the address of the
+/// element when dereferenced, as stepping a pointer by stride could move it
+/// beyond the end of the array
+template <class T>
+struct strided_iterator
+    : iterator_facade<strided_iterator<T>, T, std::random_access_iterator_tag> {
+private:
+  using super_t =
+      iterator_facade<strided_iterator<T>, T, std::random_access_iterator_tag>;
+
+public:
+  using reference = typename super_t::reference;
+  using difference_type = typename super_t::difference_type;
+
+private:
+  T *data_;
+  difference_type index_;
+  difference_type stride_;
+
+public:
+  strided_iterator() : data_(nullptr), index_(0), stride_(1) {}
+
+  /// Iterator to element index, i.e. to data[index * stride]
+  strided_iterator(T *data, difference_type index, difference_type stride)
+      : data_(data), index_(index), stride_(stride) {}
+
+  /// Iterator to const from iterator
+  template <class U, typename = std::enable_if_t<
+                         std::is_convertible_v<U *, T *>>>
+  strided_iterator(const strided_iterator<U> &other)
+      : data_(other.data()), index_(other.index()), stride_(other.stride()) {}
+
+  /// First element of the sequence
+  T *data() const { return data_; }
+
+  difference_type index() const { return index_; }
+
+  difference_type stride() const { return stride_; }
+
+  reference dereference() const { return data_[index_ * stride_]; }
+
+  void increment() { ++index_; }
+
+  void decrement() { --index_; }
+
+  void advance(difference_type n) { index_ += n; }
+
+  difference_type distance_to(const strided_iterator &other) const {
+    return other.index_ - index_;
+  }
+
+  bool equal_to(const strided_iterator &other) const {
+    return index_ == other.index_;
+  }
+};
+
+} // namespace iter
+
+/**
+ * @brief The n nearly equal parts of a view, e.g. to process them on n
+ * threads. Part i is [i * size / n, (i + 1) * size / n), the same split as
+ * parallel_policy uses. The parts are computed on access, nothing is
+ * allocated.
+ *
+ * @tparam View vector_view or strided_view
+ */
+template <class View> class chunk_range {
+public:
+  using value_type = View;
+  using size_type = std::size_t;
+
+  class iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = View;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = View;
+
+    iterator() : range_(nullptr), index_(0) {}
+
+    iterator(const chunk_range *range, size_type index)
+        : range_(range), index_(index) {}
+
+    View operator*() const { return (*range_)[index_]; }
+
+    iterator &operator++() {
+      ++index_;
+      return *this;
+    }
+
+    iterator operator++(int) {
+      auto copy = *this;
+      ++index_;
+      return copy;
+    }
+
+    friend bool operator==(const iterator &lhs, const iterator &rhs) {
+      return lhs.index_ == rhs.index_;
+    }
+
+    friend bool operator!=(const iterator &lhs, const iterator &rhs) {
+      return !(lhs == rhs);
+    }
+
+  private:
+    const chunk_range *range_;
+    size_type index_;
+  };
+
+private:
+  View view_;
+  size_type count_;
+
+public:
+  /// Split view into count parts, count has to be larger than 0
+  chunk_range(View view, size_type count) : view_(view), count_(count) {}
+
+  size_type size() const { return count_; }
+
+  View operator[](size_type i) const {
+    const size_type n = view_.size();
+    const size_type first = i * n / count_;
+    return view_.subview(first, (i + 1) * n / count_ - first);
+  }
+
+  iterator begin() const { return iterator(this, 0); }
+
+  iterator end() const { return iterator(this, count_); }
+};
+
+/**
+ * @brief Non-owning view of size() contiguous elements, e.g. a tile of a
+ * base_vector. Copying a view doesn't copy the elements, so tiles of a large
+ * vector can be passed around and processed without allocating.
+ *
+ * A base_vector (or a class derived from it, e.g. small_vector) converts
+ * implicitly to a view of all its elements, vector_view<T> to
+ * vector_view<const T>. The view is invalidated, if the vector reallocates.
+ *
+ * The iterators are plain pointers, so the standard algorithms take their
+ * memmove and vectorized paths on views.
+ *
+ * @tparam T type of the elements, const T for a read only view
+ */
+template <class T> class vector_view {
+public:
+  using element_type = T;
+  using value_type = std::remove_cv_t<T>;
+
+  using reference = T &;
+  using const_reference = const T &;
+
+  using pointer = T *;
+  using const_pointer = const T *;
+
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+
+  using iterator = T *;
+  using const_iterator = const T *;
+
+  /// Count of subview, which extends the view to the end
+  static constexpr size_type npos = static_cast<size_type>(-1);
+
+private:
+  pointer data_;
+  size_type size_;
+
+public:
+  /// create empty view
+  constexpr vector_view() : data_(nullptr), size_(0) {}
+
+  /// View of the n elements starting at data
+  constexpr vector_view(pointer data, size_type n) : data_(data), size_(n) {}
+
+  /// View of [first, last). Like for std::span, last must not convert to
+  /// size_type, so vector_view(data, 0) is the view of 0 elements
+  template <class End, typename = std::enable_if_t<
+                           std::is_convertible_v<End, pointer> &&
+                           !std::is_convertible_v<End, size_type>>>
+  constexpr vector_view(pointer first, End last)
+      : data_(first),
+        size_(static_cast<size_type>(static_cast<pointer>(last) - first)) {}
+
+  /// View of all elements of v
+  template <class Alloc, class GrowthPolicy>
+  vector_view(base_vector<value_type, Alloc, GrowthPolicy> &v)
+      : data_(v.data()), size_(v.size()) {}
+
+  /// Read only view of all elements of v
+  template <class Alloc, class GrowthPolicy, class U = T,
+            typename = std::enable_if_t<std::is_const_v<U>>>
+  vector_view(const base_vector<value_type, Alloc, GrowthPolicy> &v)
+      : data_(v.data()), size_(v.size()) {}
+
+  /// Read only view from view
+  template <class U, typename = std::enable_if_t<
+                         !std::is_same_v<U, T> &&
+                         std::is_convertible_v<U *, T *>>>
+  constexpr vector_view(const vector_view<U> &other)
+      : data_(other.data()), size_(other.size()) {}
+
+  constexpr pointer data() const { return data_; }
+
+  constexpr size_type size() const { return size_; }
+
+  constexpr bool empty() const { return size_ == 0; }
+
+  constexpr reference operator[](size_type idx) const { return data_[idx]; }
+
+  constexpr reference front() const { return data_[0]; }
+
+  constexpr reference back() const { return data_[size_ - 1]; }
+
+  constexpr iterator begin() const { return data_; }
+
+  constexpr const_iterator cbegin() const { return data_; }
+
+  constexpr iterator end() const { return data_ + size_; }
+
+  constexpr const_iterator cend() const { return data_ + size_; }
+
+  /// View of count elements starting at offset, or the ones up to the end,
+  /// if fewer are left. offset must not be larger than size()
+  constexpr vector_view subview(size_type offset,
+                                size_type count = npos) const {
+    return vector_view(data_ + offset, std::min(count, size_ - offset));
+  }
+
+  /// View of the first n elements, n must not be larger than size()
+  constexpr vector_view first(size_type n) const {
+    return vector_view(data_, n);
+  }
+
+  /// View of the last n elements, n must not be larger than size()
+  constexpr vector_view last(size_type n) const {
+    return vector_view(data_ + (size_ - n), n);
+  }
+
+  /// The elements before and from index on, index must not be larger than
+  /// size()
+  constexpr std::pair<vector_view, vector_view> split_at(size_type index) const {
+    return {first(index), subview(index)};
+  }
+
+  /// n nearly equal parts of the view, n has to be larger than 0
+  chunk_range<vector_view> chunks(size_type n) const {
+    return chunk_range<vector_view>(*this, n);
+  }
+
+  /// View of every step-th element, starting with the first one. step has to
+  /// be larger than 0
+  strided_view<T> stride(size_type step) const;
+};
+
+template <class T, class Alloc, class GrowthPolicy>
+vector_view(base_vector<T, Alloc, GrowthPolicy> &) -> vector_view<T>;
+
+template <class T, class Alloc, class GrowthPolicy>
+vector_view(const base_vector<T, Alloc, GrowthPolicy> &)
+    -> vector_view<const T>;
+
+/**
+ * @brief Non-owning view of size() elements, which are stride() elements
+ * apart, e.g. a column of a row major matrix stored in a base_vector.
+ *
+ * @tparam T type of the elements, const T for a read only view
+ */
+template <class T> class strided_view {
+public:
+  using element_type = T;
+  using value_type = std::remove_cv_t<T>;
+
+  using reference = T &;
+  using const_reference = const T &;
+
+  using pointer = T *;
+  using const_pointer = const T *;
+
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+
+  using iterator = iter::strided_iterator<T>;
+  using const_iterator = iter::strided_iterator<const T>;
+
+  /// Count of subview, which extends the view to the end
+  static constexpr size_type npos = static_cast<size_type>(-1);
+
+private:
+  pointer data_;
+  size_type size_;
+  size_type stride_;
+
+public:
+  /// create empty view
+  constexpr strided_view() : data_(nullptr), size_(0), stride_(1) {}
+
+  /// View of the n elements data[0], data[stride], ..., data[(n - 1) *
+  /// stride], stride has to be larger than 0
+  constexpr strided_view(pointer data, size_type n, size_type stride)
+      : data_(data), size_(n), stride_(stride) {}
+
+  /// All elements of a contiguous view
+  constexpr strided_view(vector_view<T> v)
+      : data_(v.data()), size_(v.size()), stride_(1) {}
+
+  /// Read only view from view
+  template <class U, typename = std::enable_if_t<
+                         !std::is_same_v<U, T> &&
+                         std::is_convertible_v<U *, T *>>>
+  constexpr strided_view(const strided_view<U> &other)
+      : data_(other.data()), size_(other.size()), stride_(other.stride()) {}
+
+  /// First element
+  constexpr pointer data() const { return data_; }
+
+  constexpr size_type size() const { return size_; }
+
+  /// Distance between two elements, in elements
+  constexpr size_type stride() const { return stride_; }
+
+  constexpr bool empty() const { return size_ == 0; }
+
+  constexpr reference operator[](size_type idx) const {
+    return data_[idx * stride_];
+  }
+
+  constexpr reference front() const { return data_[0]; }
+
+  constexpr reference back() const { return (*this)[size_ - 1]; }
+
+  iterator begin() const {
+    return iterator(data_, 0, static_cast<difference_type>(stride_));
+  }
+
+  const_iterator cbegin() const { return begin(); }
+
+  iterator end() const {
+    return iterator(data_, static_cast<difference_type>(size_),
+                    static_cast<difference_type>(stride_));
+  }
+
+  const_iterator cend() const { return end(); }
+
+  /// View of count elements starting at element offset, or the ones up to the
+  /// end, if fewer are left. offset must not be larger than size(), the empty
+  /// view at offset size() starts at data(), as element offset may lie beyond
+  /// the end of the array
+  constexpr strided_view subview(size_type offset,
+                                 size_type count = npos) const {
+    return strided_view(offset < size_ ? data_ + offset * stride_ : data_,
+                        std::min(count, size_ - offset), stride_);
+  }
+
+  /// View of the first n elements, n must not be larger than size()
+  constexpr strided_view first(size_type n) const {
+    return strided_view(data_, n, stride_);
+  }
+
+  /// View of the last n elements, n must not be larger than size()
+  constexpr strided_view last(size_type n) const {
+    return subview(size_ - n);
+  }
+
+  /// The elements before and from index on, index must not be larger than
+  /// size()
+  constexpr std::pair<strided_view, strided_view>
+  split_at(size_type index) const {
+    return {first(index), subview(index)};
+  }
+
+  /// n nearly equal parts of the view, n has to be larger than 0
+  chunk_range<strided_view> chunks(size_type n) const {
+    return chunk_range<strided_view>(*this, n);
+  }
+
+  /// View of every step-th element of this view, step has to be larger than 0
+  constexpr strided_view stride(size_type step) const {
+    return strided_view(data_, (size_ + step - 1) / step, stride_ * step);
+  }
+};
+
+template <class T>
+strided_view<T> vector_view<T>::stride(size_type step) const {
+  return strided_view<T>(data_, (size_ + step - 1) / step, step);
+}
+
+/**
+ * @brief Copy the elements of source to the start of target, the views may
+ * overlap (see overlapped_copy). target has to hold at least source.size()
+ * elements. Returns the view of the copied elements in target.
+ */
+template <class T, class U>
+vector_view<U> overlapped_copy(vector_view<T> source, vector_view<U> target) {
+  overlapped_copy(source.begin(), source.end(), target.begin());
+  return target.first(source.size());
+}
+
+/**
+ * @brief Move the elements of view, for which keep(i) is true, to its front
+ * (see compact). Returns the view of the kept elements.
+ */
+template <class T, typename Keep>
+vector_view<T> compact(vector_view<T> view, Keep keep) {
+  return vector_view<T>(view.begin(), compact(view.begin(), view.end(), keep));
+}
+
+} // namespace mem
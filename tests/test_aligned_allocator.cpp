@@ -0,0 +1,83 @@
+#include <doctest/doctest.h>
+
+#include "aligned_allocator.hpp"
+#include "base_vector.hpp"
+#include "small_vector.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace {
+bool is_aligned(const void *p, std::size_t alignment) {
+  return reinterpret_cast<std::uintptr_t>(p) % alignment == 0;
+}
+
+using aligned_vector = mem::base_vector<float, mem::aligned_allocator<float>>;
+} // namespace
+
+TEST_CASE_TEMPLATE("aligned_allocator: blocks are aligned", Alloc,
+                   mem::aligned_allocator<char, 32>,
+                   mem::aligned_allocator<float, 64>,
+                   mem::aligned_allocator<double, 128>) {
+  Alloc alloc;
+
+  for (std::size_t n = 1; n < 100; n += 7) {
+    auto *p = alloc.allocate(n);
+    CHECK(is_aligned(p, Alloc::alignment));
+    alloc.deallocate(p, n);
+  }
+}
+
+TEST_CASE("aligned_allocator: base_vector detects the alignment") {
+  CHECK_EQ(aligned_vector::alignment, 64);
+  CHECK_EQ(mem::base_vector<double>::alignment, alignof(double));
+}
+
+TEST_CASE("aligned_allocator: every base_vector constructor is aligned") {
+  const std::vector<float> values(37, 1.0f);
+
+  aligned_vector sized(37);
+  aligned_vector filled(37, 1.0f);
+  aligned_vector range(values.begin(), values.end());
+  aligned_vector from_std(values);
+  aligned_vector copy(filled);
+  aligned_vector moved(std::move(copy));
+
+  for (const auto *v : {&sized, &filled, &range, &from_std, &moved}) {
+    CHECK(is_aligned(v->data(), 64));
+    CHECK_EQ(v->aligned_data(), v->data());
+    CHECK_EQ(v->size(), 37);
+  }
+}
+
+TEST_CASE("aligned_allocator: alignment survives growth, move and swap") {
+  aligned_vector v;
+  for (int i = 0; i < 1000; ++i) {
+    v.push_back(static_cast<float>(i));
+    REQUIRE(is_aligned(v.data(), 64));
+  }
+
+  aligned_vector w(3, 2.0f);
+  v.swap(w);
+  CHECK(is_aligned(v.data(), 64));
+  CHECK(is_aligned(w.data(), 64));
+
+  aligned_vector x;
+  x = std::move(w);
+  CHECK(is_aligned(x.data(), 64));
+  CHECK_EQ(x[999], 999.0f);
+
+  x.reserve(5000);
+  CHECK(is_aligned(x.data(), 64));
+}
+
+TEST_CASE("aligned_allocator: small_vector aligns its inline buffer") {
+  mem::small_vector<float, 5, mem::aligned_allocator<float>> v(5, 1.0f);
+
+  CHECK(v.is_inline());
+  CHECK(is_aligned(v.data(), 64));
+
+  v.push_back(2.0f);
+  CHECK_FALSE(v.is_inline());
+  CHECK(is_aligned(v.aligned_data(), 64));
+}
@@ -0,0 +1,225 @@
+#include <doctest/doctest.h>
+
+#include "base_vector.hpp"
+#include "segmented_vector.hpp"
+
+#include <map>
+#include <string>
+#include <type_traits>
+
+namespace {
+/// Owners of the buffers of all tracking_allocators. It's shared by the rebound
+/// allocators, since e.g. segmented_vector allocates its index with one
+struct tracking_state {
+  static inline std::map<void *, int> owners;
+  static inline int wrong_deallocations = 0;
+};
+
+/// Stateful allocator, remembering which allocator (by id) allocated which
+/// buffer, to detect buffers deallocated by the wrong allocator
+template <class T, bool POCCA, bool POCMA, bool POCS>
+struct tracking_allocator {
+  using value_type = T;
+
+  using propagate_on_container_copy_assignment =
+      std::integral_constant<bool, POCCA>;
+  using propagate_on_container_move_assignment =
+      std::integral_constant<bool, POCMA>;
+  using propagate_on_container_swap = std::integral_constant<bool, POCS>;
+  using is_always_equal = std::false_type;
+
+  template <class U> struct rebind {
+    using other = tracking_allocator<U, POCCA, POCMA, POCS>;
+  };
+
+  int id;
+
+  explicit tracking_allocator(int id) : id(id) {}
+
+  template <class U>
+  tracking_allocator(const tracking_allocator<U, POCCA, POCMA, POCS> &other)
+      : id(other.id) {}
+
+  T *allocate(std::size_t n) {
+    T *p = std::allocator<T>().allocate(n);
+    tracking_state::owners[p] = id;
+    return p;
+  }
+
+  void deallocate(T *p, std::size_t n) {
+    if (tracking_state::owners[p] != id) {
+      ++tracking_state::wrong_deallocations;
+    }
+    tracking_state::owners.erase(p);
+    std::allocator<T>().deallocate(p, n);
+  }
+
+  friend bool operator==(const tracking_allocator &lhs,
+                         const tracking_allocator &rhs) {
+    return lhs.id == rhs.id;
+  }
+
+  friend bool operator!=(const tracking_allocator &lhs,
+                         const tracking_allocator &rhs) {
+    return lhs.id != rhs.id;
+  }
+};
+
+template <bool POCCA, bool POCMA, bool POCS>
+using tracking_vector =
+    mem::base_vector<std::string,
+                     tracking_allocator<std::string, POCCA, POCMA, POCS>>;
+
+template <bool POCCA, bool POCMA, bool POCS>
+using tracking_segmented_vector = mem::segmented_vector<
+    std::string, tracking_allocator<std::string, POCCA, POCMA, POCS>, 4>;
+
+template <class Vector> Vector make_vector(int id, std::size_t n, char c) {
+  using allocator = typename Vector::allocator_type;
+  Vector v{allocator(id)};
+  v.resize(n, std::string(32, c));
+  return v;
+}
+
+template <class Vector> bool all_equal(const Vector &v, std::size_t n, char c) {
+  if (v.size() != n) {
+    return false;
+  }
+  for (const auto &s : v) {
+    if (s != std::string(32, c)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+int wrong_deallocations() { return tracking_state::wrong_deallocations; }
+
+/// Number of buffers, which are currently allocated by allocator id
+int allocations_of(int id) {
+  int n = 0;
+  for (const auto &owner : tracking_state::owners) {
+    n += owner.second == id;
+  }
+  return n;
+}
+} // namespace
+
+TEST_CASE_TEMPLATE("allocator propagation: copy assignment", Vector,
+                   tracking_vector<true, false, false>,
+                   tracking_vector<false, false, false>,
+                   tracking_segmented_vector<true, false, false>,
+                   tracking_segmented_vector<false, false, false>) {
+  constexpr bool propagate =
+      Vector::allocator_type::propagate_on_container_copy_assignment::value;
+
+  {
+    auto target = make_vector<Vector>(1, 3, 'a');
+    const auto source = make_vector<Vector>(2, 5, 'b');
+
+    target = source;
+
+    CHECK(all_equal(target, 5, 'b'));
+    CHECK(all_equal(source, 5, 'b'));
+    CHECK_EQ(target.get_allocator().id, propagate ? 2 : 1);
+
+    THEN("Growing afterwards uses the new allocator") {
+      target.resize(100, std::string(32, 'b'));
+      CHECK(all_equal(target, 100, 'b'));
+
+      if (propagate) {
+        // Neither the elements nor an index are left with the old allocator
+        CHECK_EQ(allocations_of(1), 0);
+      }
+    }
+  }
+
+  CHECK_EQ(wrong_deallocations(), 0);
+}
+
+TEST_CASE_TEMPLATE("allocator propagation: move assignment", Vector,
+                   tracking_vector<false, true, false>,
+                   tracking_vector<false, false, false>) {
+  constexpr bool propagate =
+      Vector::allocator_type::propagate_on_container_move_assignment::value;
+
+  WHEN("The allocators compare equal, the buffer is taken over") {
+    auto target = make_vector<Vector>(1, 3, 'a');
+    auto source = make_vector<Vector>(1, 5, 'b');
+    auto *data = source.data();
+
+    target = std::move(source);
+
+    CHECK_EQ(target.data(), data);
+    CHECK(all_equal(target, 5, 'b'));
+  }
+
+  WHEN("The allocators differ") {
+    auto target = make_vector<Vector>(1, 3, 'a');
+    auto source = make_vector<Vector>(2, 5, 'b');
+    auto *data = source.data();
+
+    target = std::move(source);
+
+    CHECK(all_equal(target, 5, 'b'));
+    CHECK(source.empty());
+
+    if (propagate) {
+      THEN("The allocator propagates together with the buffer") {
+        CHECK_EQ(target.data(), data);
+        CHECK_EQ(target.get_allocator().id, 2);
+      }
+    } else {
+      THEN("The elements are moved into a buffer of the own allocator") {
+        CHECK_NE(target.data(), data);
+        CHECK_EQ(target.get_allocator().id, 1);
+      }
+    }
+  }
+
+  CHECK_EQ(wrong_deallocations(), 0);
+}
+
+TEST_CASE_TEMPLATE("allocator propagation: swap", Vector,
+                   tracking_vector<false, false, true>,
+                   tracking_vector<false, false, false>) {
+  constexpr bool propagate =
+      Vector::allocator_type::propagate_on_container_swap::value;
+
+  WHEN("The allocators compare equal, the buffers are swapped") {
+    auto x = make_vector<Vector>(1, 3, 'a');
+    auto y = make_vector<Vector>(1, 5, 'b');
+
+    x.swap(y);
+
+    CHECK(all_equal(x, 5, 'b'));
+    CHECK(all_equal(y, 3, 'a'));
+  }
+
+  WHEN("The allocators differ") {
+    auto x = make_vector<Vector>(1, 3, 'a');
+    auto y = make_vector<Vector>(2, 5, 'b');
+
+    if (propagate) {
+      THEN("The allocators are swapped together with the buffers") {
+        x.swap(y);
+
+        CHECK(all_equal(x, 5, 'b'));
+        CHECK(all_equal(y, 3, 'a'));
+        CHECK_EQ(x.get_allocator().id, 2);
+        CHECK_EQ(y.get_allocator().id, 1);
+      }
+    } else {
+      THEN("swap throws and leaves both vectors unchanged") {
+        CHECK_THROWS_AS(x.swap(y), mem::detail::allocator_mismatch_on_swap);
+
+        CHECK(all_equal(x, 3, 'a'));
+        CHECK(all_equal(y, 5, 'b'));
+        CHECK_EQ(x.get_allocator().id, 1);
+        CHECK_EQ(y.get_allocator().id, 2);
+      }
+    }
+  }
+
+  CHECK_EQ(wrong_deallocations(), 0);
+}
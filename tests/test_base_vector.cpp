@@ -2,5 +2,611 @@
 
 #include "base_vector.hpp"
 
-TEST_CASE("base_vector") {
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+TEST_CASE_TEMPLATE("base_vector: default construction", T, int, float) {
+  mem::base_vector<T> v;
+
+  CHECK(v.empty());
+  CHECK_EQ(v.size(), 0);
+  CHECK_EQ(v.capacity(), 0);
+  CHECK_EQ(v.begin(), v.end());
+}
+
+TEST_CASE_TEMPLATE("base_vector: construct with size", T, int, float) {
+  mem::base_vector<T> v(5);
+
+  CHECK_EQ(v.size(), 5);
+  CHECK_EQ(v.end() - v.begin(), 5);
+  for (std::size_t i = 0; i < v.size(); ++i) {
+    CHECK_EQ(v[i], T{});
+  }
+}
+
+TEST_CASE_TEMPLATE("base_vector: construct with size and value", T, int,
+                   float) {
+  mem::base_vector<T> v(5, T(3));
+
+  CHECK_EQ(v.size(), 5);
+  for (std::size_t i = 0; i < v.size(); ++i) {
+    CHECK_EQ(v[i], T(3));
+  }
+}
+
+TEST_CASE("base_vector: copy and assign") {
+  mem::base_vector<int> v(4, 7);
+
+  mem::base_vector<int> copy(v);
+  CHECK_EQ(copy.size(), 4);
+  CHECK_NE(copy.data(), v.data());
+  CHECK_EQ(copy[3], 7);
+
+  WHEN("Assigning a longer range") {
+    std::vector<int> other = {1, 2, 3, 4, 5, 6};
+    copy.assign(other.begin(), other.end());
+
+    CHECK_EQ(copy.size(), 6);
+    for (int i = 0; i < 6; ++i) {
+      CHECK_EQ(copy[i], i + 1);
+    }
+  }
+
+  WHEN("Assigning a shorter range") {
+    std::vector<int> other = {1, 2};
+    copy.assign(other.begin(), other.end());
+
+    CHECK_EQ(copy.size(), 2);
+    CHECK_EQ(copy[0], 1);
+    CHECK_EQ(copy[1], 2);
+  }
+
+  WHEN("Assigning copies of a value") {
+    copy.assign(10, 1);
+
+    CHECK_EQ(copy.size(), 10);
+    CHECK_EQ(copy[9], 1);
+  }
+}
+
+TEST_CASE("base_vector: move construction") {
+  mem::base_vector<int> v(4, 7);
+  auto *data = v.data();
+
+  mem::base_vector<int> moved(std::move(v));
+
+  CHECK_EQ(moved.size(), 4);
+  CHECK_EQ(moved.data(), data);
+  CHECK(v.empty());
+}
+
+TEST_CASE("base_vector: erase") {
+  std::vector<int> init = {1, 2, 3, 4, 5};
+  mem::base_vector<int> v(init);
+
+  auto it = v.erase(v.begin() + 1, v.begin() + 3);
+
+  CHECK_EQ(it, v.begin() + 1);
+  CHECK_EQ(v.size(), 3);
+  CHECK_EQ(v[0], 1);
+  CHECK_EQ(v[1], 4);
+  CHECK_EQ(v[2], 5);
+}
+
+TEST_CASE_TEMPLATE("base_vector: push_back grows the vector", Policy,
+                   mem::growth::factor_2, mem::growth::factor_1_5,
+                   mem::growth::fixed_step<3>,
+                   mem::growth::next_power_of_two) {
+  mem::base_vector<int, std::allocator<int>, Policy> v;
+
+  std::size_t reallocations = 0;
+  for (int i = 0; i < 100; ++i) {
+    const auto capacity = v.capacity();
+    v.push_back(i);
+
+    if (capacity != v.capacity()) {
+      ++reallocations;
+    }
+    CHECK_GE(v.capacity(), v.size());
+  }
+
+  CHECK_EQ(v.size(), 100);
+  for (int i = 0; i < 100; ++i) {
+    CHECK_EQ(v[i], i);
+  }
+  CHECK_LT(reallocations, 100);
+}
+
+TEST_CASE("base_vector: growth is geometric") {
+  mem::base_vector<int, std::allocator<int>, mem::growth::factor_2> v;
+
+  std::size_t reallocations = 0;
+  for (int i = 0; i < 1024; ++i) {
+    const auto capacity = v.capacity();
+    v.push_back(i);
+    reallocations += capacity != v.capacity();
+  }
+
+  // 1, 2, 4, ..., 1024
+  CHECK_EQ(reallocations, 11);
+  CHECK_EQ(v.capacity(), 1024);
+}
+
+TEST_CASE("base_vector: push_back of an element of the vector itself") {
+  mem::base_vector<std::string> v;
+  v.push_back("first element, which is not small string optimized");
+
+  for (int i = 0; i < 10; ++i) {
+    v.push_back(v[0]);
+  }
+
+  CHECK_EQ(v.size(), 11);
+  for (std::size_t i = 0; i < v.size(); ++i) {
+    CHECK_EQ(v[i], v[0]);
+  }
+}
+
+TEST_CASE("base_vector: emplace_back and pop_back") {
+  mem::base_vector<std::unique_ptr<int>> v;
+
+  for (int i = 0; i < 10; ++i) {
+    auto &ref = v.emplace_back(std::make_unique<int>(i));
+    CHECK_EQ(*ref, i);
+  }
+
+  CHECK_EQ(v.size(), 10);
+  for (int i = 0; i < 10; ++i) {
+    CHECK_EQ(*v[i], i);
+  }
+
+  v.pop_back();
+  v.pop_back();
+
+  CHECK_EQ(v.size(), 8);
+  CHECK_EQ(*v[7], 7);
+}
+
+TEST_CASE("base_vector: reserve") {
+  mem::base_vector<int> v(3, 1);
+
+  v.reserve(100);
+  CHECK_EQ(v.capacity(), 100);
+  CHECK_EQ(v.size(), 3);
+  CHECK_EQ(v[2], 1);
+
+  THEN("Reserving less has no effect") {
+    auto *data = v.data();
+    v.reserve(10);
+    CHECK_EQ(v.capacity(), 100);
+    CHECK_EQ(v.data(), data);
+  }
+
+  THEN("Appending doesn't reallocate") {
+    auto *data = v.data();
+    for (int i = 0; i < 97; ++i) {
+      v.push_back(i);
+    }
+    CHECK_EQ(v.data(), data);
+  }
+
+  THEN("Reserving more than max_size() throws") {
+    CHECK_THROWS_AS(v.reserve(v.max_size() + 1), std::length_error);
+  }
+}
+
+TEST_CASE("base_vector: resize") {
+  mem::base_vector<int> v(3, 1);
+
+  WHEN("Growing") {
+    v.resize(6);
+
+    CHECK_EQ(v.size(), 6);
+    CHECK_EQ(v[2], 1);
+    CHECK_EQ(v[5], 0);
+  }
+
+  WHEN("Growing with value") {
+    v.resize(6, 4);
+
+    CHECK_EQ(v.size(), 6);
+    CHECK_EQ(v[2], 1);
+    CHECK_EQ(v[3], 4);
+    CHECK_EQ(v[5], 4);
+  }
+
+  WHEN("Shrinking") {
+    v.resize(1);
+
+    CHECK_EQ(v.size(), 1);
+    CHECK_EQ(v.capacity(), 3);
+    CHECK_EQ(v[0], 1);
+  }
+}
+
+TEST_CASE("base_vector: resize_for_overwrite") {
+  WHEN("Elements are trivial") {
+    mem::base_vector<unsigned char> v(8, 7);
+    v.resize(2);
+    v.resize_for_overwrite(8);
+
+    // The old bytes are not zeroed
+    CHECK_EQ(v.size(), 8);
+    CHECK_EQ(v.capacity(), 8);
+    CHECK_EQ(v[7], 7);
+
+    v.resize_for_overwrite(100);
+    std::fill(v.begin() + 8, v.end(), 3);
+
+    CHECK_EQ(v.size(), 100);
+    CHECK_EQ(v[7], 7);
+    CHECK_EQ(v[99], 3);
+
+    v.resize_for_overwrite(1);
+    CHECK_EQ(v.size(), 1);
+  }
+
+  WHEN("Elements are not trivial") {
+    mem::base_vector<std::string> v(2, "a");
+    v.resize_for_overwrite(4);
+
+    CHECK_EQ(v.size(), 4);
+    CHECK_EQ(v[1], "a");
+    CHECK(v[3].empty());
+  }
+}
+
+TEST_CASE("base_vector: construct with default_init") {
+  mem::base_vector<int> v(mem::default_init, 1000);
+  std::fill(v.begin(), v.end(), 5);
+
+  CHECK_EQ(v.size(), 1000);
+  CHECK_EQ(v.capacity(), 1000);
+  CHECK_EQ(v[999], 5);
+
+  mem::base_vector<std::string> s(mem::default_init, 3);
+  CHECK_EQ(s.size(), 3);
+  CHECK(s[2].empty());
+}
+
+namespace {
+struct throwing_move {
+  static inline int copies = 0;
+
+  int value;
+
+  explicit throwing_move(int v) : value(v) {}
+  throwing_move(const throwing_move &other) : value(other.value) { ++copies; }
+  throwing_move(throwing_move &&other) noexcept(false) : value(other.value) {}
+};
+} // namespace
+
+TEST_CASE("base_vector: relocation copies, if move might throw") {
+  mem::base_vector<throwing_move> v;
+  v.reserve(1);
+  v.emplace_back(1);
+
+  throwing_move::copies = 0;
+  v.emplace_back(2);
+
+  CHECK_EQ(throwing_move::copies, 1);
+  CHECK_EQ(v[0].value, 1);
+  CHECK_EQ(v[1].value, 2);
+}
+
+TEST_CASE("base_vector: erase trivially relocatable elements") {
+  mem::base_vector<std::unique_ptr<int>> v;
+  for (int i = 0; i < 6; ++i) {
+    v.push_back(std::make_unique<int>(i));
+  }
+
+  auto it = v.erase(v.begin() + 1, v.begin() + 3);
+
+  CHECK_EQ(it, v.begin() + 1);
+  CHECK_EQ(v.size(), 4);
+  CHECK_EQ(*v[0], 0);
+  CHECK_EQ(*v[1], 3);
+  CHECK_EQ(*v[2], 4);
+  CHECK_EQ(*v[3], 5);
+}
+
+TEST_CASE("base_vector: erase non trivially relocatable elements") {
+  mem::base_vector<std::string> v;
+  for (int i = 0; i < 6; ++i) {
+    v.push_back(std::string(32, static_cast<char>('a' + i)));
+  }
+
+  v.erase(v.begin());
+
+  CHECK_EQ(v.size(), 5);
+  CHECK_EQ(v[0], std::string(32, 'b'));
+  CHECK_EQ(v[4], std::string(32, 'f'));
+}
+
+namespace {
+template <class T> struct in_place_allocator {
+  using value_type = T;
+
+  static inline std::size_t allocations = 0;
+
+  in_place_allocator() = default;
+
+  template <class U> in_place_allocator(const in_place_allocator<U> &) {}
+
+  T *allocate(std::size_t n) {
+    ++allocations;
+    return std::allocator<T>().allocate(std::max<std::size_t>(n, 1024));
+  }
+
+  void deallocate(T *p, std::size_t n) {
+    std::allocator<T>().deallocate(p, std::max<std::size_t>(n, 1024));
+  }
+
+  bool try_expand(T *, std::size_t, std::size_t new_n) {
+    return new_n <= 1024;
+  }
+
+  friend bool operator==(const in_place_allocator &,
+                         const in_place_allocator &) {
+    return true;
+  }
+
+  friend bool operator!=(const in_place_allocator &,
+                         const in_place_allocator &) {
+    return false;
+  }
+};
+} // namespace
+
+TEST_CASE("base_vector: growth expands the buffer in place if possible") {
+  mem::base_vector<std::string, in_place_allocator<std::string>> v;
+  in_place_allocator<std::string>::allocations = 0;
+
+  v.push_back("first element, which is not small string optimized");
+  auto *data = v.data();
+
+  for (int i = 0; i < 1000; ++i) {
+    v.push_back(v[0]);
+  }
+
+  CHECK_EQ(in_place_allocator<std::string>::allocations, 1);
+  CHECK_EQ(v.data(), data);
+  CHECK_EQ(v[1000], v[0]);
+
+  THEN("If the allocator can't expand anymore, a new buffer is allocated") {
+    for (int i = 0; i < 100; ++i) {
+      v.push_back(v[0]);
+    }
+    CHECK_EQ(in_place_allocator<std::string>::allocations, 2);
+    CHECK_EQ(v.size(), 1101);
+  }
+}
+
+namespace {
+template <class T> T make(int i) {
+  if constexpr (std::is_same_v<T, std::string>) {
+    // Long enough to not be small string optimized
+    return std::string(32, static_cast<char>('a' + i));
+  } else {
+    return static_cast<T>(i);
+  }
+}
+
+template <class Vector> std::vector<int> indices_of(const Vector &v) {
+  using value_type = typename Vector::value_type;
+
+  std::vector<int> result;
+  for (std::size_t i = 0; i < v.size(); ++i) {
+    for (int j = 0; j < 26; ++j) {
+      if (v[i] == make<value_type>(j)) {
+        result.push_back(j);
+      }
+    }
+  }
+  return result;
+}
+} // namespace
+
+TEST_CASE_TEMPLATE("base_vector: insert and emplace", T, int, std::string) {
+  // Full, so growing reallocates
+  mem::base_vector<T> v;
+  v.reserve(5);
+  for (int i = 0; i < 5; ++i) {
+    v.push_back(make<T>(i));
+  }
+
+  WHEN("Inserting a single element") {
+    v.reserve(10);
+    auto it = v.insert(v.begin() + 2, make<T>(9));
+
+    CHECK_EQ(it - v.begin(), 2);
+    CHECK_EQ(indices_of(v), std::vector<int>{0, 1, 9, 2, 3, 4});
+  }
+
+  WHEN("Emplacing at the front and the end") {
+    v.emplace(v.begin(), make<T>(7));
+    auto it = v.emplace(v.end(), make<T>(8));
+
+    CHECK_EQ(it - v.begin(), 6);
+    CHECK_EQ(indices_of(v), std::vector<int>{7, 0, 1, 2, 3, 4, 8});
+  }
+
+  WHEN("Inserting an element of the vector itself") {
+    v.reserve(10);
+    v.insert(v.begin(), v[3]);
+    v.insert(v.begin() + 1, 2, v[4]);
+
+    CHECK_EQ(indices_of(v), std::vector<int>{3, 3, 3, 0, 1, 2, 3, 4});
+  }
+
+  WHEN("Inserting an element of the vector itself, which reallocates") {
+    v.insert(v.begin() + 1, 3, v[4]);
+
+    CHECK_EQ(indices_of(v), std::vector<int>{0, 4, 4, 4, 1, 2, 3, 4});
+  }
+
+  WHEN("Inserting copies of a value") {
+    auto it = v.insert(v.begin() + 5, 3, make<T>(6));
+
+    CHECK_EQ(it - v.begin(), 5);
+    CHECK_EQ(indices_of(v), std::vector<int>{0, 1, 2, 3, 4, 6, 6, 6});
+
+    it = v.insert(v.begin(), 0, make<T>(9));
+    CHECK_EQ(it, v.begin());
+    CHECK_EQ(v.size(), 8);
+  }
+
+  WHEN("Inserting a forward range") {
+    const std::vector<T> range{make<T>(10), make<T>(11), make<T>(12)};
+    auto it = v.insert(v.begin() + 1, range.begin(), range.end());
+
+    CHECK_EQ(it - v.begin(), 1);
+    CHECK_EQ(indices_of(v), std::vector<int>{0, 10, 11, 12, 1, 2, 3, 4});
+  }
+
+  WHEN("Inserting a range reallocates at most once") {
+    const std::vector<T> range(100, make<T>(20));
+    v.insert(v.begin() + 3, range.begin(), range.end());
+
+    CHECK_EQ(v.size(), 105);
+    CHECK_EQ(v.capacity(), 105);
+    CHECK_EQ(v[2], make<T>(2));
+    CHECK_EQ(v[3], make<T>(20));
+    CHECK_EQ(v[102], make<T>(20));
+    CHECK_EQ(v[104], make<T>(4));
+  }
+}
+
+TEST_CASE("base_vector: insert an input range") {
+  mem::base_vector<int> v{std::vector<int>{1, 2, 3}};
+  std::istringstream input("7 8 9 10");
+
+  auto it = v.insert(v.begin() + 1, std::istream_iterator<int>(input),
+                     std::istream_iterator<int>());
+
+  CHECK_EQ(it - v.begin(), 1);
+  CHECK_EQ(std::vector<int>(v.begin(), v.end()),
+           std::vector<int>{1, 7, 8, 9, 10, 2, 3});
+}
+
+TEST_CASE("base_vector: insert with integral arguments fills") {
+  mem::base_vector<int> v(2, 1);
+  v.insert(v.begin() + 1, 3, 5);
+
+  CHECK_EQ(std::vector<int>(v.begin(), v.end()),
+           std::vector<int>{1, 5, 5, 5, 1});
+}
+
+TEST_CASE("base_vector: insert expands the buffer in place if possible") {
+  mem::base_vector<int, in_place_allocator<int>> v(4, 0);
+  in_place_allocator<int>::allocations = 0;
+  v[3] = 3;
+  auto *data = v.data();
+
+  // The buffer is expanded in place, and the tail shifted before the new
+  // element is constructed
+  v.insert(v.begin(), v[3]);
+
+  CHECK_EQ(in_place_allocator<int>::allocations, 0);
+  CHECK_EQ(v.data(), data);
+  CHECK_EQ(std::vector<int>(v.begin(), v.end()),
+           std::vector<int>{3, 0, 0, 0, 3});
+}
+
+namespace {
+struct throwing_copy {
+  static inline int throw_after = -1;
+
+  int value;
+
+  explicit throwing_copy(int v) : value(v) {}
+  throwing_copy(const throwing_copy &other) : value(other.value) {
+    if (throw_after == 0) {
+      throw std::runtime_error("copy");
+    }
+    --throw_after;
+  }
+  throwing_copy(throwing_copy &&other) noexcept : value(other.value) {}
+  throwing_copy &operator=(const throwing_copy &) = default;
+  throwing_copy &operator=(throwing_copy &&) noexcept = default;
+};
+} // namespace
+
+TEST_CASE("base_vector: insert leaves the vector unchanged, if a copy throws") {
+  mem::base_vector<throwing_copy> v;
+  v.reserve(4);
+  for (int i = 0; i < 4; ++i) {
+    v.emplace_back(i);
+  }
+
+  const std::vector<throwing_copy> range(3, throwing_copy(9));
+
+  WHEN("Inserting in place") {
+    v.reserve(10);
+    throwing_copy::throw_after = 2;
+    CHECK_THROWS_AS(v.insert(v.begin() + 1, range.begin(), range.end()),
+                    std::runtime_error);
+  }
+
+  WHEN("Reallocating") {
+    throwing_copy::throw_after = 2;
+    CHECK_THROWS_AS(v.insert(v.begin() + 1, range.begin(), range.end()),
+                    std::runtime_error);
+  }
+
+  throwing_copy::throw_after = -1;
+  REQUIRE_EQ(v.size(), 4);
+  for (int i = 0; i < 4; ++i) {
+    CHECK_EQ(v[i].value, i);
+  }
+}
+
+TEST_CASE_TEMPLATE("base_vector: erase_if", T, int, std::string) {
+  mem::base_vector<T> v;
+  for (int i = 0; i < 10; ++i) {
+    v.push_back(make<T>(i));
+  }
+  const auto capacity = v.capacity();
+
+  const auto erased = mem::erase_if(v, [](const T &value) {
+    return value == make<T>(1) || value == make<T>(4) || value == make<T>(9);
+  });
+
+  CHECK_EQ(erased, 3);
+  CHECK_EQ(v.capacity(), capacity);
+  CHECK_EQ(indices_of(v), std::vector<int>{0, 2, 3, 5, 6, 7, 8});
+}
+
+TEST_CASE_TEMPLATE("base_vector: remove_indices", T, int, std::string) {
+  mem::base_vector<T> v;
+  for (int i = 0; i < 10; ++i) {
+    v.push_back(make<T>(i));
+  }
+
+  const auto erased = mem::remove_indices(v, std::vector<int>{0, 5, 6, 9});
+
+  CHECK_EQ(erased, 4);
+  CHECK_EQ(indices_of(v), std::vector<int>{1, 2, 3, 4, 7, 8});
+}
+
+TEST_CASE_TEMPLATE("base_vector: erase with mask", T, int, std::string) {
+  mem::base_vector<T> v;
+  for (int i = 0; i < 6; ++i) {
+    v.push_back(make<T>(i));
+  }
+
+  const auto erased =
+      v.erase(std::vector<bool>{true, false, true, true, false, false});
+
+  CHECK_EQ(erased, 3);
+  CHECK_EQ(indices_of(v), std::vector<int>{1, 4, 5});
+
+  THEN("Iterator erase still works") {
+    v.erase(v.begin());
+    CHECK_EQ(indices_of(v), std::vector<int>{4, 5});
+  }
 }
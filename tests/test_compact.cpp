@@ -0,0 +1,101 @@
+#include <doctest/doctest.h>
+
+#include "compact.hpp"
+
+#include <array>
+#include <list>
+#include <string>
+#include <vector>
+
+// Needs to be after #include <doctest/doctest>
+#include "stringmaker.h"
+
+TEST_CASE_TEMPLATE("compact: keeps the selected elements in order", T, int,
+                   double, std::string) {
+  std::vector<T> v(10);
+  for (int i = 0; i < 10; ++i) {
+    if constexpr (std::is_same_v<T, std::string>) {
+      v[i] = std::to_string(i);
+    } else {
+      v[i] = static_cast<T>(i);
+    }
+  }
+
+  auto end = mem::compact(v.begin(), v.end(),
+                          [](std::size_t i) { return i % 3 == 0; });
+
+  REQUIRE_EQ(end - v.begin(), 4);
+  for (int i = 0; i < 4; ++i) {
+    if constexpr (std::is_same_v<T, std::string>) {
+      CHECK_EQ(v[i], std::to_string(3 * i));
+    } else {
+      CHECK_EQ(v[i], static_cast<T>(3 * i));
+    }
+  }
+}
+
+TEST_CASE("compact: keep is called once per element in order") {
+  std::array a{1, 2, 3, 4, 5, 6};
+  const std::vector<bool> mask{true, false, false, true, true, false};
+
+  auto m = mask.begin();
+  std::size_t calls = 0;
+  auto end = mem::compact(a.begin(), a.end(), [&](std::size_t i) {
+    CHECK_EQ(i, calls++);
+    return *m++;
+  });
+
+  CHECK_EQ(calls, 6);
+  REQUIRE_EQ(end - a.begin(), 3);
+  CHECK_EQ(a[0], 1);
+  CHECK_EQ(a[1], 4);
+  CHECK_EQ(a[2], 5);
+}
+
+TEST_CASE("compact: non random access ranges") {
+  std::list<int> l{1, 2, 3, 4};
+
+  auto end = mem::compact(l.begin(), l.end(),
+                          [](std::size_t i) { return i >= 2; });
+
+  CHECK_EQ(std::distance(l.begin(), end), 2);
+  CHECK_EQ(l.front(), 3);
+}
+
+TEST_CASE("compact: empty range") {
+  std::vector<int> v;
+
+  CHECK_EQ(mem::compact(v.begin(), v.end(), [](std::size_t) { return true; }),
+           v.end());
+}
+
+TEST_CASE("remove_indices: removes the elements at the indices") {
+  std::array a{0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+
+  WHEN("Indices are scattered") {
+    const std::vector<std::size_t> indices{0, 3, 4, 9};
+    auto end =
+        mem::remove_indices(a.begin(), a.end(), indices.begin(), indices.end());
+
+    REQUIRE_EQ(end - a.begin(), 6);
+    CHECK_EQ(std::vector<int>(a.begin(), end),
+             std::vector<int>{1, 2, 5, 6, 7, 8});
+  }
+
+  WHEN("Indices contain duplicates") {
+    const std::vector<int> indices{2, 2, 5, 5, 5};
+    auto end =
+        mem::remove_indices(a.begin(), a.end(), indices.begin(), indices.end());
+
+    CHECK_EQ(std::vector<int>(a.begin(), end),
+             std::vector<int>{0, 1, 3, 4, 6, 7, 8, 9});
+  }
+
+  WHEN("There are no indices") {
+    const std::vector<int> indices;
+    auto end =
+        mem::remove_indices(a.begin(), a.end(), indices.begin(), indices.end());
+
+    CHECK_EQ(end, a.end());
+  }
+}
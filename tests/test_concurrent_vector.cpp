@@ -0,0 +1,190 @@
+#include <doctest/doctest.h>
+
+#include "concurrent_vector.hpp"
+#include "pool_resource.hpp"
+#include "test_helpers.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory_resource>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST_CASE("concurrent_vector: segments") {
+  using vector = mem::concurrent_vector<int>;
+
+  CHECK_EQ(vector::segment_of(0), 0);
+  CHECK_EQ(vector::segment_of(31), 0);
+  CHECK_EQ(vector::segment_of(32), 1);
+  CHECK_EQ(vector::segment_of(95), 1);
+  CHECK_EQ(vector::segment_of(96), 2);
+
+  CHECK_EQ(vector::segment_begin(2), 96);
+  CHECK_EQ(vector::segment_size(2), 128);
+}
+
+TEST_CASE("concurrent_vector: single threaded use") {
+  mem::concurrent_vector<std::string> v;
+  CHECK(v.empty());
+
+  for (int i = 0; i < 1000; ++i) {
+    v.push_back(std::to_string(i));
+  }
+  const std::string *first = &v[0];
+
+  CHECK_EQ(v.size(), 1000);
+  CHECK_EQ(v[999], "999");
+
+  WHEN("Growing by several elements") {
+    const auto idx = v.grow_by(100, "x");
+
+    CHECK_EQ(idx, 1000);
+    CHECK_EQ(v.size(), 1100);
+    CHECK_EQ(v[1099], "x");
+
+    // Elements never move
+    CHECK_EQ(&v[0], first);
+  }
+
+  WHEN("Iterating") {
+    int i = 0;
+    for (const auto &s : v) {
+      CHECK_EQ(s, std::to_string(i++));
+    }
+    CHECK_EQ(i, 1000);
+    CHECK_EQ(std::distance(v.cbegin(), v.cend()), 1000);
+  }
+
+  WHEN("Clearing") {
+    const auto capacity = v.capacity();
+    v.clear();
+
+    CHECK(v.empty());
+    CHECK_EQ(v.capacity(), capacity);
+
+    v.emplace_back(3, 'a');
+    CHECK_EQ(v[0], "aaa");
+  }
+}
+
+TEST_CASE("concurrent_vector: reserve") {
+  mem::concurrent_vector<int> v;
+  v.reserve(1000);
+
+  CHECK_GE(v.capacity(), 1000);
+  CHECK_THROWS_AS(v.reserve(v.max_size() + 1), std::length_error);
+
+  WHEN("Growing beyond max_size()") {
+    v.push_back(1);
+    CHECK_THROWS_AS(v.grow_by(v.max_size()), std::length_error);
+
+    // No slots were reserved, so later appends are published
+    v.push_back(2);
+    REQUIRE_EQ(v.size(), 2);
+    CHECK_EQ(v[1], 2);
+  }
+}
+
+TEST_CASE("concurrent_vector: stateful allocators") {
+  WHEN("The allocator has no default constructor") {
+    mem::pool_resource pool;
+    mem::concurrent_vector<int, mem::pool_allocator<int>> v(pool);
+    for (int i = 0; i < 100; ++i) {
+      v.push_back(i);
+    }
+
+    CHECK_EQ(v.size(), 100);
+    CHECK_EQ(v[99], 99);
+    CHECK_EQ(v.get_allocator().resource(), &pool);
+  }
+
+  WHEN("The allocator doesn't propagate on swap") {
+    std::pmr::monotonic_buffer_resource arena;
+    mem::concurrent_vector<std::pmr::string,
+                           std::pmr::polymorphic_allocator<std::pmr::string>>
+        v(&arena);
+    v.push_back("first");
+    v.grow_by(100, "x");
+
+    CHECK_EQ(v.size(), 101);
+    CHECK_EQ(v[0], "first");
+    CHECK_EQ(v[100], "x");
+  }
+}
+
+namespace {
+/// Value initializing the slot of a failed construction can't throw
+using throwing = test::basic_throwing<true>;
+} // namespace
+
+TEST_CASE("concurrent_vector: failed constructions keep the prefix") {
+  mem::concurrent_vector<throwing> v;
+  v.emplace_back(1);
+
+  throwing::countdown = 0;
+  CHECK_THROWS_AS(v.emplace_back(5), std::runtime_error);
+  v.emplace_back(2);
+
+  REQUIRE_EQ(v.size(), 3);
+  CHECK_EQ(v[0].value, 1);
+  CHECK_EQ(v[1].value, 0);
+  CHECK_EQ(v[2].value, 2);
+}
+
+TEST_CASE("concurrent_vector: concurrent appends and reads") {
+  constexpr int writers = 4;
+  constexpr int per_writer = 20000;
+
+  mem::concurrent_vector<int> v;
+  std::atomic<bool> done{false};
+  std::atomic<int> read_errors{0};
+
+  // Reads the published prefix while it grows, every element in it has to be
+  // constructed, i.e. not 0
+  std::thread reader([&] {
+    while (!done.load()) {
+      const auto n = v.size();
+      for (std::size_t i = 0; i < n; ++i) {
+        if (v[i] == 0) {
+          ++read_errors;
+        }
+      }
+    }
+  });
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < writers; ++t) {
+    threads.emplace_back([&v, &read_errors, t] {
+      for (int i = 0; i < per_writer; ++i) {
+        const int value = t * per_writer + i + 1;
+        if (i % 100 == 0) {
+          const auto idx = v.grow_by(3, value);
+          if (v[idx + 2] != value) {
+            ++read_errors;
+          }
+        } else {
+          v.push_back(value);
+        }
+      }
+    });
+  }
+
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  done.store(true);
+  reader.join();
+
+  CHECK_EQ(read_errors.load(), 0);
+  REQUIRE_EQ(v.size(), writers * (per_writer + per_writer / 100 * 2));
+
+  // Every value was appended, grow_by values three times
+  std::vector<int> values(v.begin(), v.end());
+  std::sort(values.begin(), values.end());
+  values.erase(std::unique(values.begin(), values.end()), values.end());
+  CHECK_EQ(values.size(), writers * per_writer);
+  CHECK_EQ(values.front(), 1);
+  CHECK_EQ(values.back(), writers * per_writer);
+}
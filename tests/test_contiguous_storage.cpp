@@ -2,6 +2,8 @@
 
 #include "contiguous_storage.hpp"
 
+#include <memory>
+
 TEST_CASE_TEMPLATE("contiguous_storage: default construction", T, int, float) {
   using namespace mem::detail;
 
@@ -9,3 +11,154 @@ TEST_CASE_TEMPLATE("contiguous_storage: default construction", T, int, float) {
 
   CHECK_EQ(storage.size(), 0);
 }
+
+namespace {
+struct counting {
+  static inline int alive = 0;
+
+  int value;
+
+  explicit counting(int v) : value(v) { ++alive; }
+  counting(const counting &other) : value(other.value) { ++alive; }
+  counting(counting &&other) noexcept : value(other.value) { ++alive; }
+  ~counting() { --alive; }
+};
+} // namespace
+
+TEST_CASE_TEMPLATE("contiguous_storage: relocate to another storage", T, int,
+                   std::unique_ptr<int>) {
+  using namespace mem::detail;
+
+  contiguous_storage<T, std::allocator<T>> source(4);
+  contiguous_storage<T, std::allocator<T>> target(8);
+
+  for (int i = 0; i < 4; ++i) {
+    if constexpr (std::is_same_v<T, int>) {
+      source.construct(source.begin() + i, i);
+    } else {
+      source.construct(source.begin() + i, std::make_unique<int>(i));
+    }
+  }
+
+  auto end = source.relocate(source.begin(), source.end(), target.begin());
+
+  CHECK_EQ(end, target.begin() + 4);
+  for (int i = 0; i < 4; ++i) {
+    if constexpr (std::is_same_v<T, int>) {
+      CHECK_EQ(target[i], i);
+    } else {
+      CHECK_EQ(*target[i], i);
+    }
+  }
+
+  target.destroy(target.begin(), end);
+}
+
+TEST_CASE("contiguous_storage: relocate overlapping trivially relocatable "
+          "range") {
+  using namespace mem::detail;
+
+  contiguous_storage<int, std::allocator<int>> storage(8);
+  for (int i = 0; i < 8; ++i) {
+    storage.construct(storage.begin() + i, i);
+  }
+
+  storage.relocate(storage.begin() + 2, storage.end(), storage.begin());
+
+  for (int i = 0; i < 6; ++i) {
+    CHECK_EQ(storage[i], i + 2);
+  }
+}
+
+TEST_CASE("contiguous_storage: relocate destroys the source of non trivially "
+          "relocatable types") {
+  using namespace mem::detail;
+
+  CHECK_FALSE(mem::is_trivially_relocatable_v<counting>);
+
+  {
+    contiguous_storage<counting, std::allocator<counting>> source(3);
+    contiguous_storage<counting, std::allocator<counting>> target(3);
+
+    for (int i = 0; i < 3; ++i) {
+      source.construct(source.begin() + i, i);
+    }
+    CHECK_EQ(counting::alive, 3);
+
+    source.relocate(source.begin(), source.end(), target.begin());
+    CHECK_EQ(counting::alive, 3);
+    CHECK_EQ(target[2].value, 2);
+
+    target.destroy(target.begin(), target.end());
+  }
+
+  CHECK_EQ(counting::alive, 0);
+}
+
+namespace {
+/// Allocator, which pretends to grow every block in place, by handing out
+/// blocks with a fixed amount of spare capacity
+template <class T> struct expanding_allocator {
+  using value_type = T;
+
+  static constexpr std::size_t reserved = 64;
+
+  static inline int expansions = 0;
+
+  expanding_allocator() = default;
+
+  template <class U> expanding_allocator(const expanding_allocator<U> &) {}
+
+  T *allocate(std::size_t) { return std::allocator<T>().allocate(reserved); }
+
+  void deallocate(T *p, std::size_t) {
+    std::allocator<T>().deallocate(p, reserved);
+  }
+
+  bool try_expand(T *, std::size_t, std::size_t new_n) {
+    ++expansions;
+    return new_n <= reserved;
+  }
+
+  friend bool operator==(const expanding_allocator &,
+                         const expanding_allocator &) {
+    return true;
+  }
+
+  friend bool operator!=(const expanding_allocator &,
+                         const expanding_allocator &) {
+    return false;
+  }
+};
+} // namespace
+
+TEST_CASE("contiguous_storage: allocator extensions are detected") {
+  using namespace mem::detail;
+
+  CHECK(has_try_expand<expanding_allocator<int>>::value);
+  CHECK_FALSE(has_try_reallocate<expanding_allocator<int>>::value);
+
+  CHECK_FALSE(has_try_expand<std::allocator<int>>::value);
+  CHECK_FALSE(has_try_reallocate<std::allocator<int>>::value);
+}
+
+TEST_CASE("contiguous_storage: try_expand grows the buffer in place") {
+  using namespace mem::detail;
+
+  contiguous_storage<int, expanding_allocator<int>> storage(8);
+  auto *data = storage.data();
+
+  CHECK(storage.try_expand(32));
+  CHECK_EQ(storage.size(), 32);
+  CHECK_EQ(storage.data(), data);
+
+  CHECK_FALSE(storage.try_expand(128));
+  CHECK_EQ(storage.size(), 32);
+
+  THEN("Without the extension nothing happens") {
+    contiguous_storage<int, std::allocator<int>> other(8);
+    CHECK_FALSE(other.try_expand(32));
+    CHECK_FALSE(other.try_reallocate(32));
+    CHECK_EQ(other.size(), 8);
+  }
+}
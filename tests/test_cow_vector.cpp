@@ -0,0 +1,168 @@
+#include <doctest/doctest.h>
+
+#include "cow_vector.hpp"
+#include "test_helpers.h"
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+using ints = mem::cow_vector<int>;
+
+using test::to_std;
+} // namespace
+
+TEST_CASE("cow_vector: copies share the elements") {
+  ints v = {1, 2, 3};
+  CHECK_EQ(v.use_count(), 1);
+  CHECK_FALSE(v.is_shared());
+
+  ints copy(v);
+  CHECK_EQ(v.use_count(), 2);
+  CHECK(copy.is_shared());
+
+  // Read only access doesn't clone
+  const ints &c = copy;
+  CHECK_EQ(c[1], 2);
+  CHECK_EQ(c.front(), 1);
+  CHECK_EQ(c.back(), 3);
+  CHECK_EQ(c.data(), v.get().data());
+  CHECK_EQ(v.use_count(), 2);
+
+  WHEN("Writing to a copy") {
+    copy[0] = 10;
+    CHECK_FALSE(copy.is_shared());
+    CHECK_FALSE(v.is_shared());
+    CHECK_EQ(to_std(copy), std::vector<int>{10, 2, 3});
+    CHECK_EQ(to_std(v), std::vector<int>{1, 2, 3});
+  }
+
+  WHEN("Appending to a copy") {
+    copy.push_back(copy.get()[2]);
+    v.emplace_back(v.get()[0]);
+    CHECK_EQ(to_std(copy), std::vector<int>{1, 2, 3, 3});
+    CHECK_EQ(to_std(v), std::vector<int>{1, 2, 3, 1});
+  }
+
+  WHEN("Erasing from a copy") {
+    copy.erase(copy.begin());
+    CHECK_EQ(to_std(copy), std::vector<int>{2, 3});
+    CHECK_EQ(to_std(v), std::vector<int>{1, 2, 3});
+  }
+
+  WHEN("Inserting into a copy") {
+    copy.insert(copy.begin() + 1, 2, 7);
+    CHECK_EQ(to_std(copy), std::vector<int>{1, 7, 7, 2, 3});
+    CHECK_EQ(to_std(v), std::vector<int>{1, 2, 3});
+  }
+
+  WHEN("make_unique clones up front") {
+    const int *shared = v.cbegin().base();
+    mem::base_vector<int> &elements = copy.make_unique();
+    CHECK_NE(elements.data(), shared);
+    CHECK_EQ(v.use_count(), 1);
+
+    // Already unique, nothing is cloned
+    CHECK_EQ(&copy.make_unique(), &elements);
+    CHECK_EQ(copy.data(), elements.data());
+  }
+
+  WHEN("Assigning to a copy") {
+    const int *shared = v.cbegin().base();
+    copy.assign(2, 5);
+    CHECK_EQ(to_std(copy), std::vector<int>{5, 5});
+    CHECK_EQ(to_std(v), std::vector<int>{1, 2, 3});
+    CHECK_EQ(v.cbegin().base(), shared);
+  }
+
+  WHEN("Clearing a copy") {
+    copy.clear();
+    CHECK(copy.empty());
+    CHECK_EQ(copy.capacity(), 0);
+    CHECK_EQ(v.use_count(), 1);
+    CHECK_EQ(to_std(v), std::vector<int>{1, 2, 3});
+  }
+
+  WHEN("Destroying the original") {
+    v = ints();
+    CHECK_EQ(copy.use_count(), 1);
+    CHECK_EQ(to_std(copy), std::vector<int>{1, 2, 3});
+  }
+}
+
+TEST_CASE("cow_vector: assignment and moves") {
+  ints a = {1, 2};
+  ints b = {3, 4, 5};
+
+  a = b;
+  CHECK_EQ(a.use_count(), 2);
+  CHECK_EQ(to_std(a), std::vector<int>{3, 4, 5});
+
+  a = a;
+  CHECK_EQ(a.use_count(), 2);
+
+  ints moved(std::move(a));
+  CHECK_EQ(moved.use_count(), 2);
+  CHECK(a.empty());
+  CHECK_EQ(a.use_count(), 0);
+
+  b = std::move(moved);
+  CHECK_EQ(b.use_count(), 1);
+  CHECK_EQ(to_std(b), std::vector<int>{3, 4, 5});
+
+  a.swap(b);
+  CHECK(b.empty());
+  CHECK_EQ(to_std(a), std::vector<int>{3, 4, 5});
+
+  mem::base_vector<int> elements(4, 9);
+  const int *buffer = elements.data();
+  ints taken(std::move(elements));
+  CHECK_EQ(taken.cbegin().base(), buffer);
+  CHECK_EQ(to_std(taken), std::vector<int>(4, 9));
+}
+
+TEST_CASE("cow_vector: empty vectors don't allocate") {
+  ints v;
+  CHECK(v.empty());
+  CHECK_EQ(v.use_count(), 0);
+  CHECK_EQ(v.cbegin(), v.cend());
+  CHECK(v.get().empty());
+
+  ints copy(v);
+  CHECK_EQ(copy.use_count(), 0);
+
+  copy.push_back(1);
+  CHECK_EQ(copy.use_count(), 1);
+  CHECK(v.empty());
+}
+
+TEST_CASE("cow_vector: copies are released from several threads") {
+  mem::cow_vector<std::string> v(100, std::string(40, 'x'));
+
+  std::atomic<int> errors{0};
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([copy = v, &errors]() mutable {
+      for (int i = 0; i < 100; ++i) {
+        mem::cow_vector<std::string> local(copy);
+        if (local.get()[i].size() != 40) {
+          ++errors;
+        }
+      }
+      copy[0] = "mine";
+      if (copy.get()[0] != "mine") {
+        ++errors;
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  CHECK_EQ(errors.load(), 0);
+  CHECK_EQ(v.use_count(), 1);
+  CHECK_EQ(v.get()[0], std::string(40, 'x'));
+}
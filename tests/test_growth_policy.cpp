@@ -0,0 +1,55 @@
+#include <doctest/doctest.h>
+
+#include "growth_policy.hpp"
+
+TEST_CASE("growth_policy: factor_2 doubles the capacity") {
+  using policy = mem::growth::factor_2;
+
+  CHECK_EQ(policy::next_capacity(0, 1), 1);
+  CHECK_EQ(policy::next_capacity(1, 2), 2);
+  CHECK_EQ(policy::next_capacity(4, 5), 8);
+
+  THEN("The required capacity wins, if it's larger") {
+    CHECK_EQ(policy::next_capacity(4, 100), 100);
+  }
+}
+
+TEST_CASE("growth_policy: factor_1_5 grows by half the capacity") {
+  using policy = mem::growth::factor_1_5;
+
+  CHECK_EQ(policy::next_capacity(0, 1), 1);
+  CHECK_EQ(policy::next_capacity(1, 2), 2);
+  CHECK_EQ(policy::next_capacity(2, 3), 3);
+  CHECK_EQ(policy::next_capacity(4, 5), 6);
+  CHECK_EQ(policy::next_capacity(10, 11), 15);
+}
+
+TEST_CASE("growth_policy: fixed_step adds a constant number of elements") {
+  using policy = mem::growth::fixed_step<16>;
+
+  CHECK_EQ(policy::next_capacity(0, 1), 16);
+  CHECK_EQ(policy::next_capacity(16, 17), 32);
+
+  THEN("Larger requests are rounded up to a multiple of the step") {
+    CHECK_EQ(policy::next_capacity(16, 40), 48);
+  }
+}
+
+TEST_CASE("growth_policy: next_power_of_two rounds up to a power of two") {
+  using policy = mem::growth::next_power_of_two;
+
+  CHECK_EQ(policy::next_capacity(0, 1), 1);
+  CHECK_EQ(policy::next_capacity(1, 2), 2);
+  CHECK_EQ(policy::next_capacity(4, 5), 8);
+  CHECK_EQ(policy::next_capacity(8, 9), 16);
+  CHECK_EQ(policy::next_capacity(8, 100), 128);
+}
+
+TEST_CASE("growth_policy: growth doesn't overflow") {
+  constexpr auto max = static_cast<std::size_t>(-1);
+
+  CHECK_EQ(mem::growth::factor_2::next_capacity(max - 1, max), max);
+  CHECK_EQ(mem::growth::factor_1_5::next_capacity(max - 1, max), max);
+  CHECK_EQ(mem::growth::fixed_step<16>::next_capacity(max - 1, max), max);
+  CHECK_EQ(mem::growth::next_power_of_two::next_capacity(max - 1, max), max);
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+namespace test {
+
+/// Elements of a container or view as a std::vector, to compare them with
+/// CHECK_EQ
+template <class Range> auto to_std(const Range &r) {
+  return std::vector<typename Range::value_type>(r.begin(), r.end());
+}
+
+/**
+ * @brief Element, whose constructions throw std::runtime_error once countdown
+ * reaches 0, i.e. after countdown constructions succeeded. A negative
+ * countdown never throws. alive counts the elements, which are constructed
+ * and not yet destroyed.
+ *
+ * @tparam NothrowDefault default construction neither counts nor throws (e.g.
+ * for concurrent_vector, which value initializes the slots of failed
+ * constructions)
+ */
+template <bool NothrowDefault = false> struct basic_throwing {
+  static inline std::atomic<int> countdown{-1};
+  static inline std::atomic<int> alive{0};
+
+  int value = 0;
+
+  basic_throwing() noexcept(NothrowDefault) {
+    if constexpr (!NothrowDefault) {
+      count_down();
+    }
+    ++alive;
+  }
+
+  explicit basic_throwing(int v) : value(v) {
+    count_down();
+    ++alive;
+  }
+
+  basic_throwing(const basic_throwing &other) : value(other.value) {
+    count_down();
+    ++alive;
+  }
+
+  basic_throwing &operator=(const basic_throwing &) = default;
+
+  ~basic_throwing() { --alive; }
+
+private:
+  static void count_down() {
+    if (countdown.fetch_sub(1) == 0) {
+      throw std::runtime_error("construction failed");
+    }
+  }
+};
+
+using throwing = basic_throwing<>;
+
+} // namespace test
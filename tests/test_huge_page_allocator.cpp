@@ -0,0 +1,62 @@
+#include <doctest/doctest.h>
+
+#include "base_vector.hpp"
+#include "huge_page_allocator.hpp"
+
+#include <cstdint>
+
+TEST_CASE("huge_page_allocator: small blocks come from the heap") {
+  mem::huge_page_allocator<float> alloc;
+
+  auto *p = alloc.allocate(16);
+  p[15] = 1.0f;
+
+  CHECK_EQ(p[15], 1.0f);
+  CHECK_FALSE(alloc.try_expand(p, 16, 32));
+
+  alloc.deallocate(p, 16);
+}
+
+TEST_CASE_TEMPLATE("huge_page_allocator: large blocks are huge page aligned",
+                   Alloc, mem::huge_page_allocator<float>,
+                   mem::huge_page_allocator<float, 2 * 1024 * 1024, true>) {
+  Alloc alloc;
+  const std::size_t n = Alloc::map_threshold / sizeof(float) + 1;
+
+  auto *p = alloc.allocate(n);
+
+  CHECK_EQ(reinterpret_cast<std::uintptr_t>(p) % mem::detail::huge_page_size(),
+           0);
+  p[0] = 1.0f;
+  p[n - 1] = 2.0f;
+  CHECK_EQ(p[0], 1.0f);
+  CHECK_EQ(p[n - 1], 2.0f);
+
+  // The block can grow up to the end of the last huge page
+  const std::size_t capacity =
+      mem::detail::round_to_huge_pages(n * sizeof(float)) / sizeof(float);
+
+  CHECK(alloc.try_expand(p, n, capacity));
+  p[capacity - 1] = 3.0f;
+  CHECK_EQ(p[n - 1], 2.0f);
+
+  alloc.deallocate(p, capacity);
+}
+
+TEST_CASE("huge_page_allocator: base_vector with huge pages") {
+  using vector = mem::base_vector<float, mem::huge_page_allocator<float>>;
+  const std::size_t n = 4 << 20;
+
+  vector v(n, 1.0f);
+  CHECK_EQ(reinterpret_cast<std::uintptr_t>(v.data()) %
+               mem::detail::huge_page_size(),
+           0);
+
+  for (std::size_t i = 0; i < 1000; ++i) {
+    v.push_back(2.0f);
+  }
+
+  CHECK_EQ(v.size(), n + 1000);
+  CHECK_EQ(v[n - 1], 1.0f);
+  CHECK_EQ(v[n + 999], 2.0f);
+}
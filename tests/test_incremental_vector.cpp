@@ -0,0 +1,232 @@
+#include <doctest/doctest.h>
+
+#include "incremental_vector.hpp"
+#include "test_helpers.h"
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+using ints = mem::incremental_vector<int>;
+
+using strings = mem::incremental_vector<std::string>;
+
+using test::to_std;
+
+std::vector<std::string> numbers(int n) {
+  std::vector<std::string> result;
+  for (int i = 0; i < n; ++i) {
+    result.push_back(std::to_string(i));
+  }
+  return result;
+}
+} // namespace
+
+TEST_CASE("incremental_vector: push_back migrates incrementally") {
+  strings v;
+  for (int i = 0; i < 8; ++i) {
+    v.push_back(std::to_string(i));
+  }
+  CHECK_EQ(v.capacity(), 8);
+  CHECK_FALSE(v.migrating());
+
+  v.push_back("8");
+  CHECK_EQ(v.capacity(), 16);
+  CHECK(v.migrating());
+  CHECK_EQ(to_std(v), numbers(9));
+
+  THEN("The migration is finished, before the buffer is full") {
+    for (int i = 9; i < 16; ++i) {
+      CHECK(v.migrating());
+      v.push_back(std::to_string(i));
+    }
+    CHECK_FALSE(v.migrating());
+    CHECK_EQ(v.capacity(), 16);
+    CHECK_EQ(to_std(v), numbers(16));
+  }
+
+  THEN("An element of the vector can be appended, while migrating") {
+    v.push_back(v[7]);
+    v.emplace_back(v[8]);
+    CHECK_EQ(v[9], "7");
+    CHECK_EQ(v.back(), "8");
+  }
+
+  THEN("data() finishes the migration") {
+    const std::string *p = v.data();
+    CHECK_FALSE(v.migrating());
+    CHECK_EQ(std::vector<std::string>(p, p + v.size()), numbers(9));
+  }
+}
+
+TEST_CASE("incremental_vector: shrinking while migrating") {
+  strings v;
+  for (int i = 0; i < 17; ++i) {
+    v.push_back(std::to_string(i));
+  }
+  CHECK(v.migrating());
+
+  WHEN("Popping the elements, which were appended after the growth") {
+    v.pop_back();
+    CHECK_EQ(to_std(v), numbers(16));
+  }
+
+  WHEN("Shrinking into the elements, which aren't migrated yet") {
+    v.resize(12);
+    CHECK_EQ(to_std(v), numbers(12));
+    CHECK(v.migrating());
+
+    v.resize(1);
+    CHECK_EQ(to_std(v), numbers(1));
+    CHECK_FALSE(v.migrating());
+  }
+
+  WHEN("Clearing") {
+    v.clear();
+    CHECK(v.empty());
+    CHECK_FALSE(v.migrating());
+    CHECK_EQ(v.capacity(), 32);
+  }
+}
+
+TEST_CASE("incremental_vector: growth policy decides the migration step") {
+  mem::incremental_vector<int, std::allocator<int>, mem::growth::factor_1_5>
+      v;
+
+  auto capacity = v.capacity();
+  for (int i = 0; i < 1000; ++i) {
+    if (v.size() == v.capacity()) {
+      CHECK_FALSE(v.migrating());
+    }
+    v.push_back(i);
+    CHECK_EQ(v.back(), i);
+    CHECK_GE(v.capacity(), capacity);
+    capacity = v.capacity();
+  }
+
+  std::vector<int> expected(1000);
+  std::iota(expected.begin(), expected.end(), 0);
+  CHECK_EQ(to_std(v), expected);
+}
+
+TEST_CASE("incremental_vector: constructors") {
+  ints sized(6);
+  CHECK_EQ(to_std(sized), std::vector<int>(6, 0));
+
+  ints filled(5, 7);
+  CHECK_EQ(to_std(filled), std::vector<int>(5, 7));
+
+  ints listed = {1, 2, 3, 4, 5};
+  CHECK_EQ(to_std(listed), std::vector<int>{1, 2, 3, 4, 5});
+
+  strings migrating;
+  for (int i = 0; i < 9; ++i) {
+    migrating.push_back(std::to_string(i));
+  }
+
+  WHEN("Copying") {
+    strings copy(migrating);
+    CHECK_FALSE(copy.migrating());
+    CHECK_EQ(to_std(copy), numbers(9));
+
+    copy = strings{"a", "b"};
+    CHECK_EQ(to_std(copy), std::vector<std::string>{"a", "b"});
+
+    copy = migrating;
+    CHECK_EQ(to_std(copy), numbers(9));
+  }
+
+  WHEN("Moving") {
+    strings moved(std::move(migrating));
+    CHECK(moved.migrating());
+    CHECK_EQ(to_std(moved), numbers(9));
+
+    strings other;
+    other = std::move(moved);
+    CHECK_EQ(to_std(other), numbers(9));
+
+    other.push_back("9");
+    CHECK_EQ(to_std(other), numbers(10));
+  }
+
+  WHEN("Swapping") {
+    listed.swap(filled);
+    CHECK_EQ(to_std(listed), std::vector<int>(5, 7));
+    CHECK_EQ(to_std(filled), std::vector<int>{1, 2, 3, 4, 5});
+  }
+}
+
+TEST_CASE("incremental_vector: reserve and resize") {
+  ints v = {1, 2, 3};
+  v.reserve(100);
+  CHECK_EQ(v.capacity(), 100);
+  CHECK(v.migrating());
+  CHECK_EQ(to_std(v), std::vector<int>{1, 2, 3});
+
+  v.resize(50, 4);
+  CHECK_EQ(v.size(), 50);
+  CHECK_EQ(v[2], 3);
+  CHECK_EQ(v[49], 4);
+
+  v.resize(200);
+  CHECK_EQ(v.size(), 200);
+  CHECK_EQ(v[0], 1);
+  CHECK_EQ(v[49], 4);
+  CHECK_EQ(v[199], 0);
+
+  CHECK_THROWS_AS(v.reserve(v.max_size() + 1), std::length_error);
+}
+
+TEST_CASE("incremental_vector: growing while migrating") {
+  strings v;
+  for (int i = 0; i < 8; ++i) {
+    v.push_back(std::to_string(i));
+  }
+  v.reserve(9);
+  REQUIRE(v.migrating());
+
+  WHEN("Appending an element, which isn't migrated yet") {
+    // Fills the buffer, half of the elements are still in the old one
+    v.push_back(v[0]);
+    REQUIRE(v.migrating());
+    REQUIRE_EQ(v.size(), v.capacity());
+
+    v.push_back(v[7]);
+    CHECK_EQ(v.size(), 10);
+    CHECK_EQ(v[8], "0");
+    CHECK_EQ(v[9], "7");
+  }
+
+  WHEN("Resizing with an element, which isn't migrated yet") {
+    v.resize(200, v[7]);
+    CHECK_EQ(v.size(), 200);
+    CHECK_EQ(v[7], "7");
+    CHECK_EQ(v[8], "7");
+    CHECK_EQ(v[199], "7");
+  }
+
+  WHEN("Appending many elements at once") {
+    v.reserve(100);
+    v.resize(20);
+    CHECK_FALSE(v.migrating());
+  }
+}
+
+TEST_CASE("incremental_vector: iterators") {
+  ints v;
+  for (int i = 0; i < 20; ++i) {
+    v.push_back(19 - i);
+  }
+  REQUIRE(v.migrating());
+
+  std::sort(v.begin(), v.end());
+  CHECK(std::is_sorted(v.cbegin(), v.cend()));
+  CHECK_EQ(v.end() - v.begin(), 20);
+  CHECK_EQ(*(v.begin() + 5), 5);
+
+  ints::const_iterator it = v.begin();
+  CHECK_EQ(*it, 0);
+}
@@ -0,0 +1,156 @@
+#include <doctest/doctest.h>
+
+#include "mapped_vector.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <system_error>
+
+#include <unistd.h>
+
+namespace {
+/// Path of a file in the temporary directory, which is removed afterwards
+struct temporary_file {
+  std::string path;
+
+  explicit temporary_file(const std::string &name)
+      : path((std::filesystem::temp_directory_path() /
+              (name + "_" + std::to_string(::getpid())))
+                 .string()) {}
+
+  ~temporary_file() { std::filesystem::remove(path); }
+
+  std::uintmax_t size() const { return std::filesystem::file_size(path); }
+};
+
+struct point {
+  double x;
+  double y;
+};
+} // namespace
+
+TEST_CASE("mapped_vector: elements are persisted") {
+  temporary_file file("mapped_vector_persist");
+
+  {
+    mem::mapped_vector<std::uint64_t> v(file.path, mem::map_mode::create);
+    CHECK(v.empty());
+    CHECK(v.writable());
+
+    for (std::uint64_t i = 0; i < 100000; ++i) {
+      v.push_back(i * i);
+    }
+  }
+
+  // The unused capacity is dropped
+  CHECK_EQ(file.size(), 64 + 100000 * sizeof(std::uint64_t));
+
+  WHEN("Reopened for reading") {
+    const mem::mapped_vector<std::uint64_t> v(file.path,
+                                              mem::map_mode::read_only);
+
+    CHECK_FALSE(v.writable());
+    REQUIRE_EQ(v.size(), 100000);
+    CHECK_EQ(v[0], 0);
+    CHECK_EQ(v[99999], 99999ull * 99999ull);
+  }
+
+  WHEN("Reopened for writing") {
+    {
+      mem::mapped_vector<std::uint64_t> v(file.path,
+                                          mem::map_mode::read_write);
+      REQUIRE_EQ(v.size(), 100000);
+      const auto *data = v.data();
+
+      v[0] = 42;
+      v.resize(200000, 7);
+      v.erase(v.begin() + 1, v.begin() + 100000);
+
+      // The file grows in place
+      CHECK_EQ(v.data(), data);
+      v.flush();
+    }
+
+    const mem::mapped_vector<std::uint64_t> v(file.path,
+                                              mem::map_mode::read_only);
+    REQUIRE_EQ(v.size(), 100001);
+    CHECK_EQ(v[0], 42);
+    CHECK_EQ(v[1], 7);
+    CHECK_EQ(v[100000], 7);
+  }
+}
+
+TEST_CASE("mapped_vector: read only vectors don't change the file") {
+  temporary_file file("mapped_vector_read_only");
+
+  {
+    mem::mapped_vector<int> v(file.path, mem::map_mode::create);
+    v.resize(10, 1);
+  }
+
+  {
+    mem::mapped_vector<int> v(file.path, mem::map_mode::read_only);
+    v[0] = 2;
+    CHECK_EQ(v[0], 2);
+
+    // There is no space to grow into
+    CHECK_THROWS(v.resize(10000));
+  }
+
+  const mem::mapped_vector<int> v(file.path, mem::map_mode::read_only);
+  CHECK_EQ(v[0], 1);
+}
+
+TEST_CASE("mapped_vector: mismatching files fail to open") {
+  temporary_file file("mapped_vector_mismatch");
+
+  {
+    mem::mapped_vector<point> v(file.path, mem::map_mode::create);
+    v.push_back(point{1.0, 2.0});
+  }
+
+  CHECK_THROWS_AS(mem::mapped_vector<int>(file.path, mem::map_mode::read_only),
+                  mem::mapped_file_error);
+
+  WHEN("The file isn't a mapped_vector") {
+    std::ofstream(file.path) << std::string(100, 'x');
+
+    CHECK_THROWS_AS(
+        mem::mapped_vector<point>(file.path, mem::map_mode::read_write),
+        mem::mapped_file_error);
+  }
+
+  WHEN("The file doesn't exist") {
+    CHECK_THROWS_AS(mem::mapped_vector<point>(file.path + "_missing",
+                                              mem::map_mode::read_only),
+                    std::system_error);
+  }
+}
+
+TEST_CASE("mapped_vector: growth is limited by the reserved bytes") {
+  temporary_file file("mapped_vector_limit");
+
+  mem::mapped_vector<int> v(file.path, mem::map_mode::create, 1 << 20);
+  CHECK_EQ(v.max_size(), ((1 << 20) + 64 + 4095) / 4096 * 4096 / 4 - 16);
+
+  v.resize(v.max_size());
+  CHECK_THROWS_AS(v.push_back(1), std::length_error);
+}
+
+TEST_CASE("mapped_vector: moving keeps the file") {
+  temporary_file file("mapped_vector_move");
+
+  {
+    mem::mapped_vector<int> v(file.path, mem::map_mode::create);
+    v.push_back(1);
+
+    mem::mapped_vector<int> w(std::move(v));
+    w.push_back(2);
+  }
+
+  const mem::mapped_vector<int> v(file.path, mem::map_mode::read_only);
+  REQUIRE_EQ(v.size(), 2);
+  CHECK_EQ(v[1], 2);
+}
@@ -0,0 +1,95 @@
+#include <doctest/doctest.h>
+
+#include "base_vector.hpp"
+#include "mmap_allocator.hpp"
+
+#include <cstdint>
+
+TEST_CASE("mmap_allocator: small blocks come from the heap") {
+  mem::mmap_allocator<int> alloc;
+
+  auto *p = alloc.allocate(16);
+  p[15] = 42;
+
+  CHECK_EQ(p[15], 42);
+  CHECK_FALSE(alloc.try_expand(p, 16, 32));
+  CHECK_EQ(alloc.try_reallocate(p, 16, 32), nullptr);
+
+  alloc.deallocate(p, 16);
+}
+
+TEST_CASE("mmap_allocator: large blocks are page aligned") {
+  mem::mmap_allocator<int> alloc;
+  const std::size_t n = mem::mmap_allocator<int>::map_threshold / sizeof(int);
+
+  auto *p = alloc.allocate(n);
+
+  CHECK_EQ(reinterpret_cast<std::uintptr_t>(p) % mem::detail::page_size(), 0);
+  p[0] = 1;
+  p[n - 1] = 2;
+
+  alloc.deallocate(p, n);
+}
+
+TEST_CASE("mmap_allocator: expand within the last page") {
+  mem::mmap_allocator<char> alloc;
+  const std::size_t n = mem::mmap_allocator<char>::map_threshold + 1;
+
+  auto *p = alloc.allocate(n);
+  p[n - 1] = 'x';
+
+  // The mapping is rounded up to full pages, so this always succeeds
+  CHECK(alloc.try_expand(p, n, n + 16));
+  p[n + 15] = 'y';
+  CHECK_EQ(p[n - 1], 'x');
+
+  alloc.deallocate(p, n + 16);
+}
+
+TEST_CASE("mmap_allocator: reallocate keeps the content") {
+  mem::mmap_allocator<int> alloc;
+  const std::size_t n = mem::mmap_allocator<int>::map_threshold / sizeof(int);
+
+  auto *p = alloc.allocate(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    p[i] = static_cast<int>(i);
+  }
+
+  auto *q = alloc.try_reallocate(p, n, 8 * n);
+  REQUIRE_NE(q, nullptr);
+
+  bool equal = true;
+  for (std::size_t i = 0; i < n; ++i) {
+    equal = equal && q[i] == static_cast<int>(i);
+  }
+  CHECK(equal);
+  q[8 * n - 1] = 1;
+
+  alloc.deallocate(q, 8 * n);
+}
+
+TEST_CASE("mmap_allocator: base_vector grows a mapped buffer") {
+  using vector = mem::base_vector<int, mem::mmap_allocator<int>>;
+  const std::size_t n = 1 << 20;
+
+  vector v;
+  for (std::size_t i = 0; i < n; ++i) {
+    v.push_back(static_cast<int>(i));
+  }
+
+  WHEN("Reserving, the allocator may move the buffer") {
+    v.reserve(4 * n);
+    CHECK_EQ(v.capacity(), 4 * n);
+  }
+
+  WHEN("Resizing, the allocator may move the buffer") {
+    v.resize(4 * n);
+    CHECK_EQ(v[4 * n - 1], 0);
+  }
+
+  bool equal = true;
+  for (std::size_t i = 0; i < n; ++i) {
+    equal = equal && v[i] == static_cast<int>(i);
+  }
+  CHECK(equal);
+}
@@ -0,0 +1,173 @@
+#include <doctest/doctest.h>
+
+#include "base_vector.hpp"
+#include "monotonic_arena.hpp"
+
+#include <cstdint>
+#include <memory_resource>
+#include <string>
+
+namespace {
+/// Upstream resource counting the allocations, which are still alive
+class counting_resource : public std::pmr::memory_resource {
+public:
+  int allocations = 0;
+  int alive = 0;
+
+private:
+  void *do_allocate(std::size_t bytes, std::size_t alignment) override {
+    ++allocations;
+    ++alive;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+  }
+
+  void do_deallocate(void *p, std::size_t bytes,
+                     std::size_t alignment) override {
+    --alive;
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+  }
+
+  bool do_is_equal(const std::pmr::memory_resource &other) const
+      noexcept override {
+    return this == &other;
+  }
+};
+
+bool is_aligned(const void *p, std::size_t alignment) {
+  return reinterpret_cast<std::uintptr_t>(p) % alignment == 0;
+}
+} // namespace
+
+TEST_CASE("monotonic_arena: bump allocation") {
+  counting_resource upstream;
+  mem::monotonic_arena arena(1024, &upstream);
+
+  void *a = arena.allocate(10, 1);
+  void *b = arena.allocate(8, 8);
+  void *c = arena.allocate(64, 64);
+
+  CHECK_EQ(upstream.allocations, 1);
+  CHECK(is_aligned(b, 8));
+  CHECK(is_aligned(c, 64));
+  CHECK_GE(static_cast<char *>(b), static_cast<char *>(a) + 10);
+  CHECK_GE(static_cast<char *>(c), static_cast<char *>(b) + 8);
+  CHECK_EQ(arena.bytes_allocated(), 82);
+
+  WHEN("A block is exhausted, a larger one is allocated") {
+    CHECK_NE(arena.allocate(1000, 1), nullptr);
+    CHECK_NE(arena.allocate(1500, 1), nullptr);
+
+    CHECK_EQ(upstream.allocations, 3);
+  }
+
+  WHEN("The arena is released, all memory is returned upstream") {
+    CHECK_NE(arena.allocate(4000, 1), nullptr);
+    arena.release();
+
+    CHECK_EQ(upstream.alive, 0);
+    CHECK_EQ(arena.bytes_allocated(), 0);
+  }
+
+  WHEN("The arena is destroyed, all memory is returned upstream") {
+    {
+      mem::monotonic_arena scoped(64, &upstream);
+      CHECK_NE(scoped.allocate(1000, 1), nullptr);
+    }
+    CHECK_EQ(upstream.alive, 1);
+  }
+}
+
+TEST_CASE("monotonic_arena: initial buffer") {
+  counting_resource upstream;
+  alignas(std::max_align_t) char buffer[256];
+  mem::monotonic_arena arena(buffer, sizeof(buffer), &upstream);
+
+  void *p = arena.allocate(200, 8);
+
+  CHECK_EQ(p, static_cast<void *>(buffer));
+  CHECK_EQ(upstream.allocations, 0);
+
+  THEN("Only once it's exhausted, upstream is used") {
+    CHECK_NE(arena.allocate(100, 8), nullptr);
+    CHECK_EQ(upstream.allocations, 1);
+
+    arena.release();
+    CHECK_EQ(arena.allocate(8, 8), static_cast<void *>(buffer));
+  }
+}
+
+TEST_CASE("monotonic_arena: try_expand") {
+  mem::monotonic_arena arena(1024);
+
+  void *a = arena.allocate(16, 8);
+  CHECK(arena.try_expand(a, 16, 64));
+
+  void *b = arena.allocate(16, 8);
+  CHECK_EQ(b, static_cast<void *>(static_cast<char *>(a) + 64));
+
+  THEN("Only the most recent allocation can be expanded") {
+    CHECK_FALSE(arena.try_expand(a, 64, 128));
+    CHECK(arena.try_expand(b, 16, 32));
+  }
+
+  THEN("It can't be expanded beyond the block") {
+    CHECK_FALSE(arena.try_expand(b, 16, 4096));
+  }
+}
+
+TEST_CASE("monotonic_arena: huge allocations") {
+  counting_resource upstream;
+  mem::monotonic_arena arena(1024, &upstream);
+
+  CHECK_THROWS_AS(arena.allocate(SIZE_MAX / 2 + 1, 1), std::bad_alloc);
+  CHECK_THROWS_AS(arena.allocate(SIZE_MAX - 8, 16), std::bad_alloc);
+  CHECK_EQ(upstream.allocations, 0);
+
+  THEN("The arena is still usable") {
+    CHECK_NE(arena.allocate(16, 8), nullptr);
+    CHECK_EQ(upstream.allocations, 1);
+  }
+}
+
+TEST_CASE("monotonic_arena: base_vector with arena_allocator") {
+  counting_resource upstream;
+  mem::monotonic_arena arena(1 << 16, &upstream);
+
+  mem::base_vector<int, mem::arena_allocator<int>> v{
+      mem::arena_allocator<int>(arena)};
+
+  v.push_back(0);
+  auto *data = v.data();
+
+  for (int i = 1; i < 1000; ++i) {
+    v.push_back(i);
+  }
+
+  // The vector is the only user of the arena, so it grows in place
+  CHECK_EQ(v.data(), data);
+  CHECK_EQ(upstream.allocations, 1);
+  for (int i = 0; i < 1000; ++i) {
+    CHECK_EQ(v[i], i);
+  }
+
+  THEN("Copies use the same arena") {
+    auto copy = v;
+    CHECK_EQ(copy.get_allocator(), v.get_allocator());
+    CHECK_EQ(copy[999], 999);
+  }
+}
+
+TEST_CASE("monotonic_arena: base_vector with polymorphic_allocator") {
+  mem::monotonic_arena arena(1024);
+  using string_allocator = std::pmr::polymorphic_allocator<std::string>;
+  using pmr_vector = mem::base_vector<std::string, string_allocator>;
+
+  pmr_vector v{string_allocator(&arena)};
+  v.assign(10, std::string(32, 'a'));
+  v.push_back(std::string(32, 'b'));
+
+  CHECK_EQ(v.size(), 11);
+  CHECK_EQ(v[10], std::string(32, 'b'));
+  CHECK_EQ(v.get_allocator().resource(), &arena);
+  CHECK_GE(arena.bytes_allocated(), 11 * sizeof(std::string));
+}
@@ -13,7 +13,7 @@ TEST_CASE("normal iterator forward") {
   auto begin = mem::iter::normal_iterator<int>(a.data());
   auto end = mem::iter::normal_iterator<int>(a.data() + a.size());
 
-  CHECK_EQ(begin - end, 5);
+  CHECK_EQ(end - begin, 5);
 
   CHECK_LT(a.begin(), a.end());
   CHECK_GT(a.end(), a.begin());
@@ -32,7 +32,7 @@ TEST_CASE("normal iterator backward") {
   auto begin = mem::iter::normal_iterator<int>(a.data());
   auto end = mem::iter::normal_iterator<int>(a.data() + a.size() - 1);
 
-  CHECK_EQ(begin - end, 4);
+  CHECK_EQ(end - begin, 4);
 
   auto counter = 5;
   for (; begin != end; --end) {
@@ -40,3 +40,32 @@ TEST_CASE("normal iterator backward") {
   }
   CHECK_EQ(begin, end);
 }
+
+#if defined(__cpp_lib_concepts)
+static_assert(std::contiguous_iterator<mem::iter::normal_iterator<int>>);
+#endif
+
+TEST_CASE("normal iterator unwraps to a pointer") {
+  std::array a = {1, 2, 3, 4, 5};
+  auto begin = mem::iter::normal_iterator<int>(a.data());
+  auto end = mem::iter::normal_iterator<int>(a.data() + a.size());
+
+  CHECK_EQ(std::pointer_traits<decltype(end)>::to_address(end),
+           a.data() + a.size());
+  CHECK_EQ(begin.operator->(), a.data());
+
+  int *first = mem::detail::unwrap_iterator(begin);
+  int *last = mem::detail::unwrap_iterator(end);
+  CHECK_EQ(first, a.data());
+  CHECK_EQ(last - first, 5);
+
+  // Other iterators are left as they are
+  auto reverse = std::make_reverse_iterator(end);
+  CHECK_EQ(mem::detail::unwrap_iterator(reverse), reverse);
+
+  int *found = std::find(first, last, 4);
+  CHECK_EQ(mem::detail::rewrap_iterator(begin, found), begin + 3);
+
+  mem::iter::normal_iterator<int> empty;
+  CHECK_EQ(mem::detail::unwrap_iterator(empty), nullptr);
+}
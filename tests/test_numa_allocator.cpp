@@ -0,0 +1,99 @@
+#include <doctest/doctest.h>
+
+#include "base_vector.hpp"
+#include "numa_allocator.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace {
+
+bool is_online(int node) {
+  const auto &nodes = mem::numa::online_nodes();
+  return std::find(nodes.begin(), nodes.end(), node) != nodes.end();
+}
+
+} // namespace
+
+TEST_CASE("numa: at least one node is online") {
+  CHECK_GE(mem::numa::node_count(), 1);
+  CHECK(std::is_sorted(mem::numa::online_nodes().begin(),
+                       mem::numa::online_nodes().end()));
+}
+
+TEST_CASE("numa_allocator: small blocks come from the heap") {
+  mem::numa_allocator<int> alloc;
+
+  auto *p = alloc.allocate(16);
+  p[15] = 1;
+  CHECK_EQ(p[15], 1);
+
+  alloc.deallocate(p, 16);
+}
+
+TEST_CASE_TEMPLATE(
+    "numa_allocator: large blocks are page aligned and usable", Alloc,
+    mem::numa_allocator<int, mem::numa_placement::first_touch>,
+    mem::numa_allocator<int, mem::numa_placement::interleaved>,
+    mem::numa_allocator<int, mem::numa_placement::partitioned>) {
+  Alloc alloc;
+  const std::size_t n = Alloc::map_threshold / sizeof(int) * 2;
+
+  auto *p = alloc.allocate(n);
+  CHECK_EQ(reinterpret_cast<std::uintptr_t>(p) % mem::detail::page_size(), 0);
+
+  WHEN("no page has been touched") {
+    // Not backed by memory yet, or the kernel doesn't tell
+    const auto nodes = mem::numa::page_nodes(p, n * sizeof(int));
+
+    CHECK_EQ(nodes.size(),
+             mem::detail::round_to_pages(n * sizeof(int)) /
+                 mem::detail::page_size());
+    CHECK(std::all_of(nodes.begin(), nodes.end(),
+                      [](int node) { return node == -1; }));
+  }
+
+  WHEN("all pages are touched") {
+    std::fill(p, p + n, 7);
+
+    const auto nodes = mem::numa::page_nodes(p, n * sizeof(int));
+
+    // Either on an online node, or unknown, if move_pages isn't permitted
+    CHECK(std::all_of(nodes.begin(), nodes.end(),
+                      [](int node) { return node == -1 || is_online(node); }));
+    CHECK_EQ(p[n - 1], 7);
+  }
+
+  alloc.deallocate(p, n);
+}
+
+TEST_CASE("numa_allocator: base_vector constructed in parallel") {
+  using vector =
+      mem::base_vector<double, mem::numa_allocator<
+                                   double, mem::numa_placement::first_touch>>;
+  const std::size_t n = 1 << 20;
+
+  vector v(mem::parallel_policy(4, 1024), n, 1.5);
+
+  CHECK_EQ(v.size(), n);
+  CHECK_EQ(v[0], 1.5);
+  CHECK_EQ(v[n - 1], 1.5);
+
+  WHEN("querying the nodes of an index range") {
+    const auto nodes = mem::numa::page_nodes(v, n / 2, n);
+
+    CHECK_EQ(nodes.size(), n / 2 * sizeof(double) / mem::detail::page_size());
+    CHECK(std::all_of(nodes.begin(), nodes.end(),
+                      [](int node) { return node == -1 || is_online(node); }));
+  }
+
+  WHEN("the vector grows") {
+    for (std::size_t i = 0; i < 1000; ++i) {
+      v.push_back(2.5);
+    }
+
+    CHECK_EQ(v.size(), n + 1000);
+    CHECK_EQ(v[n - 1], 1.5);
+    CHECK_EQ(v[n], 2.5);
+  }
+}
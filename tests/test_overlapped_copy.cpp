@@ -4,6 +4,9 @@
 #include "overlapped_copy.hpp"
 
 #include <array>
+#include <string>
+#include <type_traits>
+#include <utility>
 
 // Needs to be after #include <doctest/doctest>
 #include "stringmaker.h"
@@ -47,3 +50,51 @@ TEST_CASE("overlapped_copy: Copy whole range") {
     CHECK_EQ(a, std::array{1, 2, 3, 4, 5, 6, 7, 8, 9, 10});
   }
 }
+
+TEST_CASE_TEMPLATE("overlapped_copy: normal_iterator ranges", T, int,
+                   std::string) {
+  std::array<T, 10> a;
+  mem::iter::normal_iterator<T> begin(a.data());
+
+  for (int i = 0; i < 10; ++i) {
+    if constexpr (std::is_same_v<T, int>) {
+      a[i] = i;
+    } else {
+      a[i] = std::string(20, static_cast<char>('a' + i));
+    }
+  }
+  const auto original = a;
+
+  WHEN("Copying to the front") {
+    auto end = mem::overlapped_copy(begin + 2, begin + 10, begin);
+
+    CHECK_EQ(end, begin + 8);
+    for (int i = 0; i < 8; ++i) {
+      CHECK_EQ(a[i], original[i + 2]);
+    }
+  }
+
+  WHEN("Copying to the back") {
+    auto end = mem::overlapped_copy(begin, begin + 8, begin + 2);
+
+    CHECK_EQ(end, begin + 10);
+    for (int i = 0; i < 8; ++i) {
+      CHECK_EQ(a[i + 2], original[i]);
+    }
+  }
+}
+
+TEST_CASE("overlapped_copy: uses memmove for trivially copyable types") {
+  using int_iterator = mem::iter::normal_iterator<int>;
+  using string_iterator = mem::iter::normal_iterator<std::string>;
+
+  CHECK(mem::detail::is_memmove_copyable<
+        decltype(mem::detail::unwrap_iterator(std::declval<int_iterator>())),
+        int *>::value);
+  CHECK(mem::detail::is_memmove_copyable<const int *, int *>::value);
+  CHECK_FALSE(mem::detail::is_memmove_copyable<
+              decltype(mem::detail::unwrap_iterator(
+                  std::declval<string_iterator>())),
+              std::string *>::value);
+  CHECK_FALSE(mem::detail::is_memmove_copyable<int *, long *>::value);
+}
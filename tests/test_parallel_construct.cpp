@@ -0,0 +1,96 @@
+#include <doctest/doctest.h>
+
+#include "base_vector.hpp"
+#include "test_helpers.h"
+
+#include <algorithm>
+#include <list>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+/// Small threshold, such that the tests run with several threads
+const mem::parallel_policy policy(4, 100);
+
+using test::throwing;
+} // namespace
+
+TEST_CASE("parallel construction: value initialized") {
+  mem::base_vector<int> v(policy, 10000);
+
+  CHECK_EQ(v.size(), 10000);
+  CHECK_EQ(std::count(v.begin(), v.end(), 0), 10000);
+}
+
+TEST_CASE("parallel construction: filled") {
+  const std::string value(40, 'x');
+  mem::base_vector<std::string> v(policy, 1001, value);
+
+  CHECK_EQ(v.size(), 1001);
+  CHECK_EQ(std::count(v.begin(), v.end(), value), 1001);
+
+  THEN("Integral arguments are sizes and values, not iterators") {
+    mem::base_vector<int> ints(policy, 1000, 7);
+    CHECK_EQ(ints.size(), 1000);
+    CHECK_EQ(ints[999], 7);
+  }
+}
+
+TEST_CASE("parallel construction: copies") {
+  std::vector<int> values(5000);
+  for (int i = 0; i < 5000; ++i) {
+    values[i] = i;
+  }
+
+  mem::base_vector<int> range(policy, values.begin(), values.end());
+  CHECK(std::equal(range.begin(), range.end(), values.begin(), values.end()));
+
+  mem::base_vector<int> copy(policy, range);
+  CHECK(std::equal(copy.begin(), copy.end(), values.begin(), values.end()));
+
+  THEN("Input ranges, which can't be split, are copied as well") {
+    std::list<int> list(values.begin(), values.end());
+    mem::base_vector<int> from_list(policy, list.begin(), list.end());
+    CHECK(std::equal(from_list.begin(), from_list.end(), values.begin(),
+                     values.end()));
+  }
+}
+
+TEST_CASE("parallel construction: below the threshold") {
+  mem::base_vector<int> v(mem::parallel_policy(4, 1000), 10, 3);
+
+  CHECK_EQ(v.size(), 10);
+  CHECK_EQ(v[9], 3);
+}
+
+TEST_CASE("parallel construction: rollback if a constructor throws") {
+  throwing::alive = 0;
+
+  WHEN("Value initializing") {
+    throwing::countdown = 700;
+    CHECK_THROWS_AS(mem::base_vector<throwing>(policy, 1000),
+                    std::runtime_error);
+    CHECK_EQ(throwing::alive, 0);
+  }
+
+  WHEN("Filling") {
+    throwing::countdown = 1;
+    const throwing value(1);
+    throwing::countdown = 999;
+
+    CHECK_THROWS_AS(mem::base_vector<throwing>(policy, 1000, value),
+                    std::runtime_error);
+    CHECK_EQ(throwing::alive, 1);
+  }
+
+  WHEN("Copying") {
+    throwing::countdown = 1000;
+    mem::base_vector<throwing> source(1000);
+    throwing::countdown = 500;
+
+    CHECK_THROWS_AS(mem::base_vector<throwing>(policy, source),
+                    std::runtime_error);
+    CHECK_EQ(throwing::alive, 1000);
+  }
+}
@@ -0,0 +1,202 @@
+#include <doctest/doctest.h>
+
+#include "base_vector.hpp"
+#include "pool_resource.hpp"
+
+#include <cstdint>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+namespace {
+/// Upstream resource counting the allocations, which are still alive
+class counting_resource : public std::pmr::memory_resource {
+public:
+  int allocations = 0;
+  int alive = 0;
+
+private:
+  void *do_allocate(std::size_t bytes, std::size_t alignment) override {
+    ++allocations;
+    ++alive;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+  }
+
+  void do_deallocate(void *p, std::size_t bytes,
+                     std::size_t alignment) override {
+    --alive;
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+  }
+
+  bool do_is_equal(const std::pmr::memory_resource &other) const
+      noexcept override {
+    return this == &other;
+  }
+};
+
+bool is_aligned(const void *p, std::size_t alignment) {
+  return reinterpret_cast<std::uintptr_t>(p) % alignment == 0;
+}
+} // namespace
+
+TEST_CASE("pool_resource: blocks are reused") {
+  counting_resource upstream;
+  mem::pool_resource pool(4096, &upstream);
+
+  void *a = pool.allocate(24, 8);
+  void *b = pool.allocate(32, 8);
+  CHECK_EQ(upstream.allocations, 1);
+  CHECK_NE(a, b);
+
+  pool.deallocate(a, 24, 8);
+
+  THEN("A freed block is handed out again for the same size class") {
+    CHECK_EQ(pool.allocate(20, 4), a);
+    CHECK_EQ(upstream.allocations, 1);
+  }
+
+  THEN("Other size classes use their own blocks") {
+    void *c = pool.allocate(100, 8);
+    CHECK_NE(c, a);
+    CHECK_EQ(upstream.allocations, 2);
+  }
+}
+
+TEST_CASE("pool_resource: alignment") {
+  mem::pool_resource pool;
+
+  for (std::size_t alignment = 1; alignment <= alignof(std::max_align_t);
+       alignment *= 2) {
+    std::vector<void *> blocks;
+    for (int i = 0; i < 40; ++i) {
+      blocks.push_back(pool.allocate(alignment, alignment));
+      CHECK(is_aligned(blocks.back(), alignment));
+    }
+    for (void *p : blocks) {
+      pool.deallocate(p, alignment, alignment);
+    }
+  }
+
+  THEN("Over aligned requests are passed to upstream") {
+    void *p = pool.allocate(64, 256);
+    CHECK(is_aligned(p, 256));
+    pool.deallocate(p, 64, 256);
+  }
+}
+
+TEST_CASE("pool_resource: large requests are passed to upstream") {
+  counting_resource upstream;
+  mem::pool_resource pool(256, &upstream);
+
+  CHECK_EQ(pool.largest_pooled_size(), 256);
+
+  void *p = pool.allocate(1000, 8);
+  CHECK_EQ(upstream.alive, 1);
+
+  pool.deallocate(p, 1000, 8);
+  CHECK_EQ(upstream.alive, 0);
+}
+
+TEST_CASE("pool_resource: release returns all chunks") {
+  counting_resource upstream;
+
+  {
+    mem::pool_resource pool(4096, &upstream);
+    for (std::size_t size = 8; size <= 4096; size *= 2) {
+      CHECK_NE(pool.allocate(size, 8), nullptr);
+    }
+    CHECK_EQ(upstream.alive, 10);
+
+    pool.release();
+    CHECK_EQ(upstream.alive, 0);
+
+    CHECK_NE(pool.allocate(8, 8), nullptr);
+  }
+
+  CHECK_EQ(upstream.alive, 0);
+}
+
+TEST_CASE("pool_resource: try_expand within the size class") {
+  mem::pool_resource pool;
+
+  void *p = pool.allocate(40, 8);
+  CHECK(pool.try_expand(p, 40, 64));
+  CHECK_FALSE(pool.try_expand(p, 64, 65));
+
+  pool.deallocate(p, 64, 8);
+
+  WHEN("The allocation is over-aligned, so it was passed to upstream") {
+    void *q = pool.allocate(40, 64);
+    CHECK_FALSE(pool.try_expand(q, 40, 64, 64));
+    pool.deallocate(q, 40, 64);
+  }
+}
+
+TEST_CASE("pool_resource: base_vector of an over-aligned type") {
+  struct alignas(64) big {
+    int value;
+  };
+
+  mem::pool_resource pool;
+  mem::base_vector<big, mem::pool_allocator<big>> v{
+      mem::pool_allocator<big>(pool)};
+
+  // 192 and 256 bytes fall into the same size class, but aren't pooled
+  v.reserve(3);
+  v.reserve(4);
+  for (int i = 0; i < 4; ++i) {
+    v.push_back(big{i});
+  }
+
+  CHECK_EQ(v.size(), 4);
+  CHECK_EQ(v[3].value, 3);
+  CHECK_EQ(reinterpret_cast<std::uintptr_t>(v.data()) % 64, 0);
+}
+
+TEST_CASE("pool_resource: base_vectors sharing a pool") {
+  counting_resource upstream;
+  mem::pool_resource pool(4096, &upstream);
+  using pool_vector = mem::base_vector<int, mem::pool_allocator<int>>;
+
+  std::vector<pool_vector> vectors;
+  for (int i = 0; i < 8; ++i) {
+    vectors.emplace_back(mem::pool_allocator<int>(pool));
+    for (int j = 0; j < 100; ++j) {
+      vectors.back().push_back(i * 100 + j);
+    }
+  }
+
+  for (int i = 0; i < 8; ++i) {
+    CHECK_EQ(vectors[i].size(), 100);
+    CHECK_EQ(vectors[i][99], i * 100 + 99);
+  }
+
+  THEN("Memory freed by one vector is reused by others") {
+    int allocations = upstream.allocations;
+
+    vectors.clear();
+    pool_vector v{mem::pool_allocator<int>(pool)};
+    v.assign(100, 1);
+
+    CHECK_EQ(upstream.allocations, allocations);
+  }
+}
+
+TEST_CASE("pool_resource: base_vector with polymorphic_allocator") {
+  mem::pool_resource pool;
+  using string_allocator = std::pmr::polymorphic_allocator<std::string>;
+  using pmr_vector = mem::base_vector<std::string, string_allocator>;
+
+  pmr_vector v{string_allocator(&pool)};
+  for (int i = 0; i < 50; ++i) {
+    v.push_back(std::to_string(i));
+  }
+
+  pmr_vector copy(v);
+  CHECK_EQ(copy.size(), 50);
+  CHECK_EQ(copy[49], "49");
+
+  THEN("Copies use the default resource, like std::pmr containers") {
+    CHECK_EQ(copy.get_allocator().resource(), std::pmr::get_default_resource());
+  }
+}
@@ -0,0 +1,185 @@
+#include <doctest/doctest.h>
+
+#include "segmented_vector.hpp"
+#include "test_helpers.h"
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+/// Small blocks, so a few elements span several of them
+using ints = mem::segmented_vector<int, std::allocator<int>, 4>;
+
+using strings = mem::segmented_vector<std::string, std::allocator<std::string>,
+                                      4>;
+
+using test::throwing;
+using test::to_std;
+} // namespace
+
+TEST_CASE("segmented_vector: default block size") {
+  CHECK_EQ(mem::segmented_vector<char>::block_size, 64 * 1024);
+  CHECK_EQ(mem::segmented_vector<double>::block_size, 8 * 1024);
+  CHECK_EQ(mem::segmented_vector<char[3]>::block_size, 16 * 1024);
+}
+
+TEST_CASE("segmented_vector: push_back never moves elements") {
+  strings v;
+  CHECK(v.empty());
+  CHECK_EQ(v.capacity(), 0);
+
+  v.push_back("0");
+  const std::string *first = &v[0];
+
+  for (int i = 1; i < 10; ++i) {
+    v.push_back(std::to_string(i));
+  }
+
+  CHECK_EQ(v.size(), 10);
+  CHECK_EQ(v.capacity(), 12);
+  CHECK_EQ(&v[0], first);
+  CHECK_EQ(v.front(), "0");
+  CHECK_EQ(v.back(), "9");
+  for (int i = 0; i < 10; ++i) {
+    CHECK_EQ(v[i], std::to_string(i));
+  }
+
+  THEN("An element of the vector can be appended") {
+    v.push_back(v[0]);
+    v.emplace_back(v[1]);
+    CHECK_EQ(v.size(), 12);
+    CHECK_EQ(v[10], "0");
+
+    v.push_back(v[11]);
+    CHECK_EQ(v.back(), "1");
+  }
+
+  THEN("pop_back destroys the last element, the blocks are kept") {
+    v.pop_back();
+    v.pop_back();
+    CHECK_EQ(v.size(), 8);
+    CHECK_EQ(v.back(), "7");
+    CHECK_EQ(v.capacity(), 12);
+
+    v.shrink_to_fit();
+    CHECK_EQ(v.capacity(), 8);
+    CHECK_EQ(&v[0], first);
+  }
+}
+
+TEST_CASE("segmented_vector: constructors") {
+  ints sized(6);
+  CHECK_EQ(to_std(sized), std::vector<int>(6, 0));
+
+  ints filled(5, 7);
+  CHECK_EQ(to_std(filled), std::vector<int>(5, 7));
+
+  ints listed = {1, 2, 3, 4, 5};
+  CHECK_EQ(to_std(listed), std::vector<int>{1, 2, 3, 4, 5});
+
+  WHEN("Copying") {
+    ints copy(listed);
+    CHECK_EQ(to_std(copy), to_std(listed));
+    CHECK_NE(&copy[0], &listed[0]);
+
+    copy = filled;
+    CHECK_EQ(to_std(copy), std::vector<int>(5, 7));
+  }
+
+  WHEN("Moving") {
+    const int *first = &listed[0];
+    ints moved(std::move(listed));
+    CHECK_EQ(to_std(moved), std::vector<int>{1, 2, 3, 4, 5});
+    CHECK_EQ(&moved[0], first);
+
+    moved = std::move(sized);
+    CHECK_EQ(to_std(moved), std::vector<int>(6, 0));
+  }
+
+  WHEN("Swapping") {
+    listed.swap(filled);
+    CHECK_EQ(to_std(listed), std::vector<int>(5, 7));
+    CHECK_EQ(to_std(filled), std::vector<int>{1, 2, 3, 4, 5});
+  }
+}
+
+TEST_CASE("segmented_vector: resize and reserve") {
+  ints v;
+  v.reserve(9);
+  CHECK_EQ(v.capacity(), 12);
+  CHECK(v.empty());
+
+  v.resize(10, 3);
+  CHECK_EQ(to_std(v), std::vector<int>(10, 3));
+
+  v.resize(2);
+  CHECK_EQ(to_std(v), std::vector<int>(2, 3));
+
+  v.resize(5);
+  CHECK_EQ(to_std(v), std::vector<int>{3, 3, 0, 0, 0});
+
+  v.clear();
+  CHECK(v.empty());
+  CHECK_EQ(v.capacity(), 12);
+
+  CHECK_THROWS_AS(v.reserve(v.max_size() + 1), std::length_error);
+}
+
+TEST_CASE("segmented_vector: failed resize leaves the size unchanged") {
+  mem::segmented_vector<throwing, std::allocator<throwing>, 4> v;
+  v.resize(3, throwing(1));
+
+  const throwing value(2);
+  throwing::countdown = 5;
+  CHECK_THROWS_AS(v.resize(12, value), std::runtime_error);
+  throwing::countdown = -1;
+
+  CHECK_EQ(v.size(), 3);
+  CHECK_EQ(v.back().value, 1);
+}
+
+TEST_CASE("segmented_vector: iterators") {
+  ints v(10);
+  std::iota(v.begin(), v.end(), 0);
+
+  CHECK_EQ(v.end() - v.begin(), 10);
+  CHECK_EQ(*(v.begin() + 5), 5);
+  CHECK_EQ(v.begin()[9], 9);
+
+  std::reverse(v.begin(), v.end());
+  CHECK_EQ(v[0], 9);
+  CHECK_EQ(v[9], 0);
+
+  std::sort(v.begin(), v.end());
+  CHECK(std::is_sorted(v.cbegin(), v.cend()));
+
+  ints::const_iterator it = v.begin();
+  CHECK_EQ(*it, 0);
+}
+
+TEST_CASE("segmented_vector: segments") {
+  ints v(10);
+  std::iota(v.begin(), v.end(), 0);
+
+  CHECK_EQ(v.segment_count(), 3);
+  CHECK_EQ(v.segment_size(0), 4);
+  CHECK_EQ(v.segment_size(2), 2);
+  CHECK_EQ(v.segment_data(1), &v[4]);
+
+  std::vector<int> seen;
+  v.for_each_segment([&seen](int *first, int *last) {
+    CHECK_LE(last - first, 4);
+    seen.insert(seen.end(), first, last);
+  });
+  CHECK_EQ(seen, to_std(v));
+
+  const ints &c = v;
+  int sum = 0;
+  c.for_each_segment([&sum](const int *first, const int *last) {
+    sum = std::accumulate(first, last, sum);
+  });
+  CHECK_EQ(sum, 45);
+}
@@ -0,0 +1,214 @@
+#include <doctest/doctest.h>
+
+#include "serialization.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+namespace {
+/// Both ends of a pipe, closed on destruction
+struct pipe_fds {
+  int read_end = -1;
+  int write_end = -1;
+
+  pipe_fds() {
+    int fds[2];
+    REQUIRE_EQ(::pipe(fds), 0);
+    read_end = fds[0];
+    write_end = fds[1];
+  }
+
+  ~pipe_fds() {
+    close_write();
+    ::close(read_end);
+  }
+
+  void close_write() {
+    if (write_end >= 0) {
+      ::close(write_end);
+      write_end = -1;
+    }
+  }
+};
+
+struct point {
+  float x;
+  float y;
+};
+
+mem::base_vector<std::uint32_t> iota(std::size_t n) {
+  mem::base_vector<std::uint32_t> v;
+  for (std::size_t i = 0; i < n; ++i) {
+    v.push_back(static_cast<std::uint32_t>(i));
+  }
+  return v;
+}
+} // namespace
+
+TEST_CASE("serialization: save and load through a pipe") {
+  pipe_fds fds;
+  const auto v = iota(1 << 20);
+
+  WHEN("Saving in one write") {
+    std::thread writer([&] {
+      mem::save(fds.write_end, v);
+      fds.close_write();
+    });
+
+    mem::base_vector<std::uint32_t> w{std::vector<std::uint32_t>{7, 8}};
+    mem::load(fds.read_end, w);
+    writer.join();
+
+    REQUIRE_EQ(w.size(), v.size());
+    CHECK(std::equal(v.begin(), v.end(), w.begin()));
+  }
+
+  WHEN("Saving in chunks") {
+    std::thread writer([&] {
+      mem::save(fds.write_end, v, 1000);
+      fds.close_write();
+    });
+
+    mem::base_vector<std::uint32_t> w;
+    mem::load(fds.read_end, w);
+    writer.join();
+
+    REQUIRE_EQ(w.size(), v.size());
+    CHECK(std::equal(v.begin(), v.end(), w.begin()));
+  }
+}
+
+TEST_CASE("serialization: save rejects empty chunks") {
+  pipe_fds fds;
+  CHECK_THROWS_AS(mem::save(fds.write_end, iota(10), 0), std::invalid_argument);
+}
+
+TEST_CASE("serialization: empty vectors") {
+  pipe_fds fds;
+  mem::save(fds.write_end, mem::base_vector<point>());
+
+  mem::base_vector<point> w(3, point{1, 2});
+  mem::load(fds.read_end, w);
+
+  CHECK(w.empty());
+}
+
+TEST_CASE("serialization: stream_reader reads chunk by chunk") {
+  pipe_fds fds;
+  const auto v = iota(100000);
+
+  std::thread writer([&] {
+    mem::save(fds.write_end, v);
+    fds.close_write();
+  });
+
+  mem::stream_reader<std::uint32_t> reader(fds.read_end);
+  CHECK_EQ(reader.size(), v.size());
+
+  mem::base_vector<std::uint32_t> chunk;
+  std::uint64_t sum = 0;
+  std::size_t chunks = 0;
+
+  while (reader.read(chunk, 4096) > 0) {
+    CHECK_LE(chunk.size(), 4096);
+    for (auto x : chunk) {
+      sum += x;
+    }
+    chunk.clear();
+    ++chunks;
+  }
+  writer.join();
+
+  CHECK_EQ(reader.remaining(), 0);
+  CHECK_EQ(chunks, (100000 + 4095) / 4096);
+  CHECK_EQ(sum, 99999ull * 100000ull / 2);
+}
+
+TEST_CASE("serialization: mismatching streams are rejected") {
+  pipe_fds fds;
+
+  WHEN("The element type differs") {
+    mem::save(fds.write_end, iota(10));
+
+    mem::base_vector<point> w;
+    CHECK_THROWS_AS(mem::load(fds.read_end, w), mem::serialization_error);
+  }
+
+  WHEN("Reading more than the stream holds") {
+    mem::save(fds.write_end, iota(10));
+    fds.close_write();
+
+    mem::stream_reader<std::uint32_t> reader(fds.read_end);
+    mem::base_vector<std::uint32_t> v;
+    CHECK_EQ(reader.read(v, 5), 5);
+    CHECK_EQ(reader.read(v, 5), 5);
+    CHECK_EQ(reader.read(v, 5), 0);
+  }
+
+  WHEN("The stream is truncated") {
+    mem::save(fds.write_end, iota(10));
+
+    // Drop the end of the stream
+    char buffer[32 + 10 * 4];
+    REQUIRE_EQ(::read(fds.read_end, buffer, sizeof(buffer)),
+               static_cast<ssize_t>(sizeof(buffer)));
+    REQUIRE_EQ(::write(fds.write_end, buffer, sizeof(buffer) - 4),
+               static_cast<ssize_t>(sizeof(buffer) - 4));
+    fds.close_write();
+
+    mem::base_vector<std::uint32_t> w;
+    CHECK_THROWS_AS(mem::load(fds.read_end, w), mem::serialization_error);
+    CHECK(w.empty());
+  }
+
+  WHEN("The count of the header is corrupt") {
+    // Far more elements than could be allocated, the stream ends first
+    const auto header =
+        mem::detail::make_binary_header<std::uint32_t>(std::size_t(1) << 50);
+    REQUIRE_EQ(::write(fds.write_end, &header, sizeof(header)),
+               static_cast<ssize_t>(sizeof(header)));
+    fds.close_write();
+
+    mem::base_vector<std::uint32_t> w;
+    CHECK_THROWS_AS(mem::load(fds.read_end, w), mem::serialization_error);
+    CHECK(w.empty());
+  }
+
+  WHEN("The stream holds no vector") {
+    const char text[64] = "definitely not a vector";
+    REQUIRE_EQ(::write(fds.write_end, text, sizeof(text)),
+               static_cast<ssize_t>(sizeof(text)));
+
+    mem::base_vector<std::uint32_t> w;
+    CHECK_THROWS_AS(mem::load(fds.read_end, w), mem::serialization_error);
+  }
+}
+
+TEST_CASE("serialization: the other byte order is converted for numbers") {
+  pipe_fds fds;
+
+  auto header = mem::detail::make_binary_header<std::uint32_t>(2);
+  header.byte_order = mem::detail::byteswap(header.byte_order);
+  header.version = mem::detail::byteswap(header.version);
+  header.element_size = mem::detail::byteswap(header.element_size);
+  header.element_alignment = mem::detail::byteswap(header.element_alignment);
+  header.count = mem::detail::byteswap(header.count);
+
+  const std::uint32_t elements[2] = {0x01000000, 0x04030201};
+  REQUIRE_EQ(::write(fds.write_end, &header, sizeof(header)),
+             static_cast<ssize_t>(sizeof(header)));
+  REQUIRE_EQ(::write(fds.write_end, elements, sizeof(elements)),
+             static_cast<ssize_t>(sizeof(elements)));
+
+  mem::base_vector<std::uint32_t> w;
+  mem::load(fds.read_end, w);
+
+  REQUIRE_EQ(w.size(), 2);
+  CHECK_EQ(w[0], 1);
+  CHECK_EQ(w[1], 0x01020304);
+}
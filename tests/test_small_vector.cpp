@@ -0,0 +1,250 @@
+#include <doctest/doctest.h>
+
+#include "small_vector.hpp"
+
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+namespace {
+/// std::allocator, which counts the number of allocations
+template <class T> struct counting_allocator {
+  using value_type = T;
+
+  static inline int allocations = 0;
+
+  counting_allocator() = default;
+
+  template <class U> counting_allocator(const counting_allocator<U> &) {}
+
+  T *allocate(std::size_t n) {
+    ++allocations;
+    return std::allocator<T>().allocate(n);
+  }
+
+  void deallocate(T *p, std::size_t n) { std::allocator<T>().deallocate(p, n); }
+
+  friend bool operator==(const counting_allocator &,
+                         const counting_allocator &) {
+    return true;
+  }
+
+  friend bool operator!=(const counting_allocator &,
+                         const counting_allocator &) {
+    return false;
+  }
+};
+
+using small_ints = mem::small_vector<int, 4, counting_allocator<int>>;
+
+using small_strings =
+    mem::small_vector<std::string, 4, counting_allocator<std::string>>;
+
+std::string long_string(char c) { return std::string(32, c); }
+
+template <class Vector> std::vector<std::string> to_std(const Vector &v) {
+  return std::vector<std::string>(v.begin(), v.end());
+}
+} // namespace
+
+TEST_CASE("small_vector: no allocation up to the inline capacity") {
+  counting_allocator<int>::allocations = 0;
+
+  small_ints v;
+  CHECK_EQ(v.capacity(), 4);
+  CHECK(v.is_inline());
+
+  for (int i = 0; i < 4; ++i) {
+    v.push_back(i);
+  }
+
+  CHECK_EQ(counting_allocator<int>::allocations, 0);
+  CHECK(v.is_inline());
+  CHECK_EQ(v.size(), 4);
+
+  THEN("Growing beyond moves the elements to the heap") {
+    v.push_back(4);
+
+    CHECK_EQ(counting_allocator<int>::allocations, 1);
+    CHECK_FALSE(v.is_inline());
+    CHECK_GT(v.capacity(), 4);
+    for (int i = 0; i < 5; ++i) {
+      CHECK_EQ(v[i], i);
+    }
+  }
+}
+
+TEST_CASE("small_vector: constructors") {
+  small_ints sized(3);
+  CHECK_EQ(sized.size(), 3);
+  CHECK_EQ(sized[2], 0);
+  CHECK(sized.is_inline());
+
+  small_ints filled(6, 7);
+  CHECK_EQ(filled.size(), 6);
+  CHECK_EQ(filled[5], 7);
+  CHECK_FALSE(filled.is_inline());
+
+  std::vector<int> values = {1, 2, 3};
+  small_ints range(values.begin(), values.end());
+  CHECK_EQ(range.size(), 3);
+  CHECK_EQ(range[2], 3);
+
+  small_ints copy(range);
+  CHECK_EQ(copy.size(), 3);
+  CHECK_NE(copy.data(), range.data());
+  CHECK_EQ(copy[0], 1);
+}
+
+TEST_CASE("small_vector: copies select their allocator") {
+  using pmr_ints =
+      mem::small_vector<int, 2, std::pmr::polymorphic_allocator<int>>;
+
+  std::pmr::monotonic_buffer_resource resource;
+  pmr_ints v(5, 1, &resource);
+
+  // polymorphic_allocator copies use the default resource
+  pmr_ints copy(v);
+  CHECK_EQ(copy.get_allocator().resource(), std::pmr::get_default_resource());
+  CHECK_EQ(copy.size(), 5);
+  CHECK_EQ(copy[4], 1);
+
+  const mem::base_vector<int, std::pmr::polymorphic_allocator<int>> &base = v;
+  pmr_ints base_copy(base);
+  CHECK_EQ(base_copy.get_allocator().resource(),
+           std::pmr::get_default_resource());
+}
+
+TEST_CASE("small_vector: base_vector interface") {
+  small_strings v;
+  v.assign(3, long_string('a'));
+  v.push_back(long_string('b'));
+
+  mem::base_vector<std::string, counting_allocator<std::string>> &base = v;
+  base.erase(base.begin());
+
+  CHECK_EQ(v.size(), 3);
+  CHECK_EQ(v[2], long_string('b'));
+
+  std::size_t count = 0;
+  for (auto it = v.begin(); it != v.end(); ++it) {
+    ++count;
+  }
+  CHECK_EQ(count, 3);
+}
+
+TEST_CASE("small_vector: move") {
+  small_strings inline_v(2, long_string('a'));
+  small_strings heap_v(6, long_string('b'));
+
+  WHEN("Moving an inline vector") {
+    small_strings moved(std::move(inline_v));
+
+    CHECK(moved.is_inline());
+    CHECK_EQ(to_std(moved), std::vector<std::string>(2, long_string('a')));
+    CHECK(inline_v.empty());
+    CHECK(inline_v.is_inline());
+  }
+
+  WHEN("Moving a heap vector takes over its buffer") {
+    auto *data = heap_v.data();
+    counting_allocator<std::string>::allocations = 0;
+
+    small_strings moved(std::move(heap_v));
+
+    CHECK_EQ(counting_allocator<std::string>::allocations, 0);
+    CHECK_EQ(moved.data(), data);
+    CHECK_EQ(moved.size(), 6);
+    CHECK(heap_v.empty());
+    CHECK(heap_v.is_inline());
+
+    THEN("The moved from vector can be used again") {
+      heap_v.push_back(long_string('c'));
+      CHECK_EQ(heap_v[0], long_string('c'));
+    }
+  }
+
+  WHEN("Move assigning a heap vector to an inline vector") {
+    inline_v = std::move(heap_v);
+
+    CHECK_FALSE(inline_v.is_inline());
+    CHECK_EQ(to_std(inline_v), std::vector<std::string>(6, long_string('b')));
+    CHECK(heap_v.is_inline());
+  }
+
+  WHEN("Move assigning an inline vector to a heap vector") {
+    heap_v = std::move(inline_v);
+
+    CHECK_EQ(to_std(heap_v), std::vector<std::string>(2, long_string('a')));
+    CHECK(inline_v.empty());
+  }
+}
+
+TEST_CASE("small_vector: swap") {
+  const auto a = std::vector<std::string>(2, long_string('a'));
+  const auto b = std::vector<std::string>(3, long_string('b'));
+  const auto c = std::vector<std::string>(6, long_string('c'));
+  const auto d = std::vector<std::string>(8, long_string('d'));
+
+  WHEN("Both are inline") {
+    small_strings x(a.begin(), a.end());
+    small_strings y(b.begin(), b.end());
+
+    x.swap(y);
+
+    CHECK_EQ(to_std(x), b);
+    CHECK_EQ(to_std(y), a);
+    CHECK(x.is_inline());
+    CHECK(y.is_inline());
+  }
+
+  WHEN("One is inline, the other on the heap") {
+    small_strings x(a.begin(), a.end());
+    small_strings y(c.begin(), c.end());
+    auto *data = y.data();
+
+    counting_allocator<std::string>::allocations = 0;
+    x.swap(y);
+
+    CHECK_EQ(counting_allocator<std::string>::allocations, 0);
+    CHECK_EQ(to_std(x), c);
+    CHECK_EQ(to_std(y), a);
+    CHECK_EQ(x.data(), data);
+    CHECK(y.is_inline());
+
+    y.swap(x);
+
+    CHECK_EQ(to_std(x), a);
+    CHECK_EQ(to_std(y), c);
+    CHECK(x.is_inline());
+  }
+
+  WHEN("Both are on the heap, the buffers are swapped") {
+    small_strings x(c.begin(), c.end());
+    small_strings y(d.begin(), d.end());
+    auto *x_data = x.data();
+    auto *y_data = y.data();
+
+    x.swap(y);
+
+    CHECK_EQ(to_std(x), d);
+    CHECK_EQ(to_std(y), c);
+    CHECK_EQ(x.data(), y_data);
+    CHECK_EQ(y.data(), x_data);
+  }
+}
+
+TEST_CASE("small_vector: swap through base_vector references") {
+  const auto a = std::vector<std::string>(2, long_string('a'));
+  const auto c = std::vector<std::string>(6, long_string('c'));
+
+  small_strings x(a.begin(), a.end());
+  mem::base_vector<std::string, counting_allocator<std::string>> y(c.begin(),
+                                                                   c.end());
+
+  mem::base_vector<std::string, counting_allocator<std::string>> &base = x;
+  base.swap(y);
+
+  CHECK_EQ(to_std(x), c);
+  CHECK_EQ(to_std(y), a);
+}
@@ -0,0 +1,177 @@
+#include <doctest/doctest.h>
+
+#include "soa_vector.hpp"
+#include "test_helpers.h"
+
+#include <algorithm>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+using particles = mem::soa_vector<float, int, std::string>;
+
+using test::throwing;
+using test::to_std;
+} // namespace
+
+TEST_CASE("soa_vector: rows are stored column by column") {
+  particles v;
+  CHECK(v.empty());
+  CHECK_EQ(v.capacity(), 0);
+
+  v.push_back({1.5f, 1, "one"});
+  v.emplace_back(2.5f, 2, "two");
+  std::tuple<float, int, std::string> row(3.5f, 3, "three");
+  v.push_back(std::move(row));
+
+  REQUIRE_EQ(v.size(), 3);
+  CHECK_EQ(std::get<0>(v[1]), 2.5f);
+  CHECK_EQ(std::get<2>(v[2]), "three");
+
+  CHECK_EQ(to_std(v.column<1>()), std::vector<int>{1, 2, 3});
+  CHECK_EQ(to_std(v.column<2>()),
+           std::vector<std::string>{"one", "two", "three"});
+
+  // The proxies write through to the columns
+  std::get<1>(v[0]) = 10;
+  CHECK_EQ(v.column<1>()[0], 10);
+
+  auto [x, id, name] = v[2];
+  x = 0.f;
+  name += "!";
+  CHECK_EQ(v.column<0>()[2], 0.f);
+  CHECK_EQ(v.column<2>().back(), "three!");
+  CHECK_EQ(id, 3);
+
+  const particles &c = v;
+  mem::vector_view<const int> ids = c.column<1>();
+  CHECK_EQ(ids.size(), 3);
+  CHECK_EQ(std::get<1>(c[1]), 2);
+
+  v.pop_back();
+  CHECK_EQ(v.size(), 2);
+  CHECK_EQ(v.column<2>().back(), "two");
+
+  v.clear();
+  CHECK(v.empty());
+  CHECK_GE(v.capacity(), 3);
+}
+
+TEST_CASE("soa_vector: growth keeps all columns in step") {
+  mem::soa_vector<int, double> v;
+  for (int i = 0; i < 100; ++i) {
+    v.emplace_back(i, i * 0.5);
+  }
+  CHECK_EQ(v.size(), 100);
+
+  auto ints = v.column<0>();
+  CHECK_EQ(std::accumulate(ints.begin(), ints.end(), 0), 4950);
+  CHECK_EQ(v.column<1>()[99], 49.5);
+
+  WHEN("Appending a row of the vector itself") {
+    v.reserve(v.size());
+    v.push_back(v[0]);
+    CHECK_EQ(std::get<0>(v[100]), 0);
+    CHECK_EQ(std::get<1>(v[100]), 0.0);
+  }
+
+  WHEN("Reserving") {
+    v.reserve(1000);
+    CHECK_EQ(v.capacity(), 1000);
+    CHECK_EQ(v.column<1>()[99], 49.5);
+    CHECK_THROWS_AS(v.reserve(v.max_size() + 1), std::length_error);
+  }
+
+  WHEN("Resizing") {
+    v.resize(150);
+    CHECK_EQ(std::get<0>(v[149]), 0);
+    v.resize(10);
+    CHECK_EQ(v.size(), 10);
+    CHECK_EQ(std::get<0>(v[9]), 9);
+  }
+
+  mem::soa_vector<std::unique_ptr<int>, int> owners(2);
+  owners.emplace_back(std::make_unique<int>(7), 7);
+  owners.emplace_back(std::make_unique<int>(8), 8);
+  CHECK_EQ(*std::get<0>(owners[3]), 8);
+  CHECK_FALSE(std::get<0>(owners[0]));
+}
+
+TEST_CASE("soa_vector: zip iterators visit the rows") {
+  mem::soa_vector<int, char> v;
+  for (int i = 0; i < 5; ++i) {
+    v.emplace_back(i, static_cast<char>('a' + i));
+  }
+
+  std::string chars;
+  for (auto [i, c] : v) {
+    chars += c;
+    c = static_cast<char>(c - 'a' + 'A');
+  }
+  CHECK_EQ(chars, "abcde");
+  CHECK_EQ(to_std(v.column<1>()), std::vector<char>{'A', 'B', 'C', 'D', 'E'});
+
+  CHECK_EQ(v.end() - v.begin(), 5);
+  mem::soa_vector<int, char>::const_iterator first = v.begin();
+  CHECK_EQ(std::get<0>(first[3]), 3);
+
+  auto found = std::find_if(v.cbegin(), v.cend(),
+                            [](auto row) { return std::get<0>(row) == 2; });
+  CHECK_EQ(found - v.cbegin(), 2);
+
+  std::for_each(v.begin(), v.end(), [](auto row) { std::get<0>(row) *= 10; });
+  CHECK_EQ(to_std(v.column<0>()), std::vector<int>{0, 10, 20, 30, 40});
+}
+
+TEST_CASE("soa_vector: copies, moves and swaps") {
+  particles v;
+  v.emplace_back(1.f, 1, "one");
+  v.emplace_back(2.f, 2, "two");
+
+  particles copy(v);
+  CHECK_EQ(to_std(copy.column<2>()), std::vector<std::string>{"one", "two"});
+  CHECK_NE(copy.column<0>().data(), v.column<0>().data());
+
+  const float *buffer = v.column<0>().data();
+  particles moved(std::move(v));
+  CHECK(v.empty());
+  CHECK_EQ(moved.column<0>().data(), buffer);
+
+  v = moved;
+  CHECK_EQ(to_std(v.column<1>()), std::vector<int>{1, 2});
+
+  copy.emplace_back(3.f, 3, "three");
+  moved = std::move(copy);
+  CHECK(copy.empty());
+  CHECK_EQ(moved.size(), 3);
+
+  moved.swap(v);
+  CHECK_EQ(v.size(), 3);
+  CHECK_EQ(moved.size(), 2);
+}
+
+TEST_CASE("soa_vector: a throwing copy leaves the vector unchanged") {
+  {
+    mem::soa_vector<std::string, throwing> v;
+    v.emplace_back("a", 1);
+    v.emplace_back("b", 2);
+    const std::size_t capacity = v.capacity();
+    REQUIRE_EQ(v.size(), capacity);
+
+    const std::tuple<std::string, throwing> row("c", 3);
+    throwing::countdown = 2;
+    // Copying the row and the first old row succeeds, the second one throws
+    CHECK_THROWS_AS(v.push_back(row), std::runtime_error);
+    throwing::countdown = -1;
+
+    CHECK_EQ(v.size(), 2);
+    CHECK_EQ(v.capacity(), capacity);
+    CHECK_EQ(to_std(v.column<0>()), std::vector<std::string>{"a", "b"});
+    CHECK_EQ(v.column<1>()[1].value, 2);
+    CHECK_EQ(throwing::alive, 3);
+  }
+  CHECK_EQ(throwing::alive, 0);
+}
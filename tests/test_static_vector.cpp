@@ -0,0 +1,195 @@
+#include <doctest/doctest.h>
+
+#include "static_vector.hpp"
+#include "test_helpers.h"
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace {
+using ints = mem::static_vector<int, 8>;
+using strings = mem::static_vector<std::string, 4>;
+
+using test::to_std;
+
+std::string long_string(char c) { return std::string(32, c); }
+
+/// Packet header, trivially copyable, but not trivially default constructible
+struct header {
+  std::uint16_t length = 0;
+  std::uint16_t type = 0;
+};
+
+constexpr ints squares(int n) {
+  ints v(0);
+  for (int i = 0; i < n; ++i) {
+    v.push_back(i * i);
+  }
+  v.pop_back();
+  return v;
+}
+} // namespace
+
+static_assert(std::is_trivially_copyable_v<ints>);
+static_assert(std::is_trivially_copyable_v<mem::static_vector<header, 16>>);
+static_assert(!std::is_trivially_copyable_v<strings>);
+static_assert(sizeof(mem::static_vector<std::uint64_t, 4>) ==
+              4 * sizeof(std::uint64_t) + sizeof(std::size_t));
+
+static_assert(squares(4).size() == 3);
+static_assert(squares(4)[2] == 4);
+static_assert(squares(4).capacity() == 8);
+
+constexpr ints table{1, 2, 3};
+static_assert(table.size() == 3 && table[2] == 3);
+
+TEST_CASE("static_vector: elements are stored inline") {
+  ints v;
+  CHECK(v.empty());
+  CHECK_EQ(v.capacity(), 8);
+  CHECK_EQ(v.max_size(), 8);
+
+  for (int i = 0; i < 8; ++i) {
+    v.push_back(i);
+  }
+  CHECK_EQ(v.size(), 8);
+  CHECK_EQ(static_cast<const void *>(v.data()),
+           static_cast<const void *>(&v));
+  CHECK_EQ(v.end() - v.begin(), 8);
+
+  CHECK_THROWS_AS(v.push_back(8), std::length_error);
+  CHECK_THROWS_AS(v.resize(9), std::length_error);
+  CHECK_THROWS_AS(v.reserve(9), std::length_error);
+  CHECK_EQ(v.size(), 8);
+
+  v.reserve(8);
+  v.resize(2);
+  CHECK_EQ(to_std(v), std::vector<int>{0, 1});
+  v.resize(4, 7);
+  CHECK_EQ(to_std(v), std::vector<int>{0, 1, 7, 7});
+
+  ints copy;
+  std::memcpy(static_cast<void *>(&copy), &v, sizeof(v));
+  CHECK_EQ(to_std(copy), std::vector<int>{0, 1, 7, 7});
+
+  mem::static_vector<std::uint8_t, 16> buffer(mem::default_init, 16);
+  CHECK_EQ(buffer.size(), 16);
+}
+
+TEST_CASE("static_vector: constructors and assignment") {
+  CHECK_EQ(to_std(ints(3)), std::vector<int>{0, 0, 0});
+  CHECK_EQ(to_std(ints(2, 5)), std::vector<int>{5, 5});
+  CHECK_EQ(to_std(ints{1, 2, 3}), std::vector<int>{1, 2, 3});
+  CHECK_THROWS_AS(ints(9), std::length_error);
+
+  std::vector<int> source{4, 5, 6};
+  CHECK_EQ(to_std(ints(source.begin(), source.end())), source);
+
+  std::istringstream stream("1 2 3 4 5 6 7 8 9");
+  ints from_stream;
+  CHECK_THROWS_AS(from_stream.assign(std::istream_iterator<int>(stream),
+                                     std::istream_iterator<int>()),
+                  std::length_error);
+  CHECK_EQ(from_stream.size(), 8);
+
+  strings v{long_string('a'), long_string('b'), long_string('c')};
+
+  WHEN("Copying") {
+    strings copy(v);
+    CHECK_EQ(to_std(copy), to_std(v));
+
+    strings shorter{long_string('x')};
+    shorter = v;
+    CHECK_EQ(to_std(shorter), to_std(v));
+
+    strings longer(4, long_string('y'));
+    longer = v;
+    CHECK_EQ(to_std(longer), to_std(v));
+  }
+
+  WHEN("Moving") {
+    strings moved(std::move(v));
+    CHECK_EQ(moved.size(), 3);
+    CHECK_EQ(moved[2], long_string('c'));
+
+    strings target{long_string('x')};
+    target = std::move(moved);
+    CHECK_EQ(target.size(), 3);
+    CHECK_EQ(target[0], long_string('a'));
+  }
+
+  WHEN("Assigning") {
+    v.assign(2, v[1]);
+    CHECK_EQ(to_std(v), std::vector<std::string>(2, long_string('b')));
+    v.assign(source.size(), long_string('z'));
+    CHECK_EQ(v.size(), 3);
+  }
+
+  WHEN("Swapping") {
+    strings other{long_string('x')};
+    v.swap(other);
+    CHECK_EQ(to_std(v), std::vector<std::string>{long_string('x')});
+    CHECK_EQ(to_std(other),
+             (std::vector<std::string>{long_string('a'), long_string('b'),
+                                       long_string('c')}));
+  }
+}
+
+TEST_CASE("static_vector: insert and erase") {
+  strings v{long_string('a'), long_string('b')};
+
+  v.insert(v.begin(), long_string('x'));
+  v.emplace(v.end(), 32, 'y');
+  CHECK_EQ(to_std(v),
+           (std::vector<std::string>{long_string('x'), long_string('a'),
+                                     long_string('b'), long_string('y')}));
+  CHECK_THROWS_AS(v.insert(v.begin(), long_string('z')), std::length_error);
+
+  v.erase(v.begin() + 1, v.begin() + 3);
+  CHECK_EQ(to_std(v), (std::vector<std::string>{long_string('x'),
+                                                long_string('y')}));
+
+  // value refers to an element of the vector
+  auto it = v.insert(v.begin() + 1, 2, v[0]);
+  CHECK_EQ(it - v.begin(), 1);
+  CHECK_EQ(to_std(v),
+           (std::vector<std::string>{long_string('x'), long_string('x'),
+                                     long_string('x'), long_string('y')}));
+
+  CHECK_EQ(v.erase(std::vector<bool>{true, false, true, false}), 2);
+  CHECK_EQ(to_std(v), (std::vector<std::string>{long_string('x'),
+                                                long_string('y')}));
+
+  std::vector<std::string> more{long_string('m'), long_string('n')};
+  v.insert(v.begin() + 1, more.begin(), more.end());
+  CHECK_EQ(to_std(v),
+           (std::vector<std::string>{long_string('x'), long_string('m'),
+                                     long_string('n'), long_string('y')}));
+
+  v.erase(v.begin());
+  v.pop_back();
+  CHECK_EQ(to_std(v), more);
+
+  mem::static_vector<std::unique_ptr<int>, 2> owners;
+  owners.push_back(std::make_unique<int>(1));
+  owners.emplace(owners.begin(), std::make_unique<int>(0));
+  CHECK_EQ(*owners[0], 0);
+  CHECK_EQ(*owners[1], 1);
+}
+
+TEST_CASE("static_vector: overflow policies") {
+  mem::static_vector<header, 2, mem::overflow::assert_capacity> headers;
+  headers.push_back({12, 1});
+  headers.emplace_back();
+  CHECK_EQ(headers[0].length, 12);
+  CHECK_EQ(headers[1].type, 0);
+
+  static_assert(std::is_same_v<decltype(headers)::overflow_policy,
+                               mem::overflow::assert_capacity>);
+}
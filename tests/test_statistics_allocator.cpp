@@ -0,0 +1,163 @@
+#include <doctest/doctest.h>
+
+#include "aligned_allocator.hpp"
+#include "base_vector.hpp"
+#include "statistics_allocator.hpp"
+
+#if defined(__linux__)
+#include "mmap_allocator.hpp"
+#endif
+
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+using int_allocator = mem::statistics_allocator<int>;
+using int_vector = mem::base_vector<int, int_allocator>;
+} // namespace
+
+TEST_CASE("statistics_allocator: allocations are recorded") {
+  mem::allocation_statistics stats;
+  int_allocator alloc(stats);
+
+  auto *p = alloc.allocate(10);
+  auto snapshot = stats.snapshot();
+
+  CHECK_EQ(snapshot.allocations, 1);
+  CHECK_EQ(snapshot.bytes_allocated, 10 * sizeof(int));
+  CHECK_EQ(snapshot.bytes_in_use, 10 * sizeof(int));
+  // 40 bytes lie in [32, 64)
+  CHECK_EQ(snapshot.size_histogram[5], 1);
+
+  alloc.deallocate(p, 10);
+  snapshot = stats.snapshot();
+
+  CHECK_EQ(snapshot.deallocations, 1);
+  CHECK_EQ(snapshot.bytes_deallocated, 10 * sizeof(int));
+  CHECK_EQ(snapshot.bytes_in_use, 0);
+  CHECK_EQ(snapshot.peak_bytes_in_use, 10 * sizeof(int));
+
+  THEN("reset keeps the bytes in use") {
+    auto *q = alloc.allocate(2);
+    stats.reset();
+    snapshot = stats.snapshot();
+
+    CHECK_EQ(snapshot.allocations, 0);
+    CHECK_EQ(snapshot.bytes_in_use, 2 * sizeof(int));
+    CHECK_EQ(snapshot.peak_bytes_in_use, 2 * sizeof(int));
+
+    alloc.deallocate(q, 2);
+  }
+}
+
+TEST_CASE("statistics_allocator: telemetry of a base_vector") {
+  mem::allocation_statistics stats;
+
+  {
+    int_vector v{int_allocator(stats)};
+    for (int i = 0; i < 1000; ++i) {
+      v.push_back(i);
+    }
+
+    auto snapshot = stats.snapshot();
+    CHECK_EQ(snapshot.bytes_in_use, v.capacity() * sizeof(int));
+    CHECK_EQ(snapshot.allocations, snapshot.deallocations + 1);
+    // Growing by factor 2 from a single element: 1, 2, 4, ..., 1024
+    CHECK_EQ(snapshot.allocations, 11);
+  }
+
+  CHECK_EQ(stats.snapshot().bytes_in_use, 0);
+}
+
+TEST_CASE("statistics_allocator: statistics move with the buffer") {
+  mem::allocation_statistics a_stats;
+  mem::allocation_statistics b_stats;
+
+  int_vector a(100, 1, int_allocator(a_stats));
+  int_vector b(10, 2, int_allocator(b_stats));
+
+  WHEN("Move assigning") {
+    b = std::move(a);
+
+    CHECK_EQ(&b.get_allocator().statistics(), &a_stats);
+    CHECK_EQ(b_stats.snapshot().bytes_in_use, 0);
+    CHECK_EQ(a_stats.snapshot().bytes_in_use, 100 * sizeof(int));
+  }
+
+  WHEN("Swapping") {
+    a.swap(b);
+
+    CHECK_EQ(&a.get_allocator().statistics(), &b_stats);
+    CHECK_EQ(a.size(), 10);
+  }
+
+  WHEN("Copy assigning, the statistics of the target are kept") {
+    b = a;
+
+    CHECK_EQ(&b.get_allocator().statistics(), &b_stats);
+    CHECK_EQ(b_stats.snapshot().bytes_in_use, b.capacity() * sizeof(int));
+  }
+}
+
+#if defined(__linux__)
+TEST_CASE("statistics_allocator: wrapping an allocator with extensions") {
+  using mmap_ints = mem::statistics_allocator<int, mem::mmap_allocator<int>>;
+  CHECK(mem::detail::has_try_expand<mmap_ints>::value);
+  CHECK(mem::detail::has_try_reallocate<mmap_ints>::value);
+  CHECK_FALSE(mem::detail::has_try_expand<int_allocator>::value);
+
+  mem::allocation_statistics stats;
+  {
+    mem::base_vector<int, mmap_ints> v{mmap_ints(stats)};
+    v.resize(1 << 16);
+    v.resize(1 << 20);
+
+    auto snapshot = stats.snapshot();
+    CHECK_EQ(snapshot.bytes_in_use, v.capacity() * sizeof(int));
+    CHECK_EQ(snapshot.allocations, 1);
+    CHECK_GE(snapshot.expansions, 1);
+  }
+
+  CHECK_EQ(stats.snapshot().bytes_in_use, 0);
+}
+#endif
+
+TEST_CASE("statistics_allocator: forwards the alignment") {
+  using aligned_doubles =
+      mem::statistics_allocator<double, mem::aligned_allocator<double, 64>>;
+  using vector = mem::base_vector<double, aligned_doubles>;
+  static_assert(vector::alignment == 64);
+  static_assert(mem::base_vector<double, mem::statistics_allocator<double>>::
+                    alignment == alignof(double));
+
+  mem::allocation_statistics stats;
+  vector v{aligned_doubles(stats)};
+  v.resize(100);
+  CHECK_EQ(reinterpret_cast<std::uintptr_t>(v.aligned_data()) % 64, 0);
+}
+
+TEST_CASE("statistics_allocator: concurrent allocations") {
+  mem::allocation_statistics stats;
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 8; ++t) {
+    threads.emplace_back([&stats] {
+      for (int i = 0; i < 100; ++i) {
+        int_vector v{int_allocator(stats)};
+        v.assign(64, i);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  auto snapshot = stats.snapshot();
+  CHECK_EQ(snapshot.allocations, 800);
+  CHECK_EQ(snapshot.deallocations, 800);
+  CHECK_EQ(snapshot.bytes_in_use, 0);
+  CHECK_GE(snapshot.peak_bytes_in_use, 64 * sizeof(int));
+  CHECK_LE(snapshot.peak_bytes_in_use, 8 * 64 * sizeof(int));
+}
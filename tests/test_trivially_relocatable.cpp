@@ -0,0 +1,53 @@
+#include <doctest/doctest.h>
+
+#include "trivially_relocatable.hpp"
+
+#include <memory>
+#include <string>
+
+namespace {
+struct pod {
+  int a;
+  float b;
+};
+
+struct handle {
+  int *resource;
+
+  explicit handle(int *r) : resource(r) {}
+  handle(handle &&other) noexcept : resource(other.resource) {
+    other.resource = nullptr;
+  }
+  ~handle() { delete resource; }
+};
+
+struct self_referencing {
+  self_referencing *self = this;
+
+  self_referencing() = default;
+  self_referencing(const self_referencing &) : self(this) {}
+};
+} // namespace
+
+template <> struct mem::is_trivially_relocatable<handle> : std::true_type {};
+
+TEST_CASE("is_trivially_relocatable: detected for trivially copyable types") {
+  CHECK(mem::is_trivially_relocatable_v<int>);
+  CHECK(mem::is_trivially_relocatable_v<double>);
+  CHECK(mem::is_trivially_relocatable_v<int *>);
+  CHECK(mem::is_trivially_relocatable_v<pod>);
+}
+
+TEST_CASE("is_trivially_relocatable: std::unique_ptr is trivially "
+          "relocatable") {
+  CHECK(mem::is_trivially_relocatable_v<std::unique_ptr<int>>);
+  CHECK(mem::is_trivially_relocatable_v<std::unique_ptr<int[]>>);
+}
+
+TEST_CASE("is_trivially_relocatable: non trivially copyable types need to "
+          "opt in") {
+  CHECK_FALSE(mem::is_trivially_relocatable_v<self_referencing>);
+  CHECK_FALSE(mem::is_trivially_relocatable_v<std::string>);
+
+  CHECK(mem::is_trivially_relocatable_v<handle>);
+}
@@ -0,0 +1,156 @@
+#include <doctest/doctest.h>
+
+#include "small_vector.hpp"
+#include "test_helpers.h"
+#include "vector_view.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+namespace {
+using test::to_std;
+
+int sum(mem::vector_view<const int> v) {
+  return std::accumulate(v.begin(), v.end(), 0);
+}
+} // namespace
+
+TEST_CASE("vector_view: converts from base_vector") {
+  mem::base_vector<int> v(10);
+  std::iota(v.begin(), v.end(), 0);
+
+  mem::vector_view<int> view = v;
+  CHECK_EQ(view.data(), v.data());
+  CHECK_EQ(view.size(), 10);
+  CHECK_EQ(view.front(), 0);
+  CHECK_EQ(view.back(), 9);
+
+  view[0] = 100;
+  CHECK_EQ(v[0], 100);
+
+  CHECK_EQ(sum(v), 145);
+  CHECK_EQ(sum(view), 145);
+
+  const mem::base_vector<int> &c = v;
+  mem::vector_view<const int> read_only = c;
+  CHECK_EQ(read_only.data(), v.data());
+
+  mem::small_vector<int, 4> small(3, 2);
+  CHECK_EQ(sum(small), 6);
+
+  mem::vector_view deduced = c;
+  static_assert(std::is_same_v<decltype(deduced), mem::vector_view<const int>>);
+
+  mem::vector_view<int> empty;
+  CHECK(empty.empty());
+  CHECK_EQ(empty.begin(), empty.end());
+
+  WHEN("Constructing from a pointer and a size or an end") {
+    CHECK(mem::vector_view<int>(v.data(), 0).empty());
+    CHECK_EQ(mem::vector_view<int>(v.data(), 3).size(), 3);
+    CHECK_EQ(mem::vector_view<int>(v.data(), v.data() + 4).size(), 4);
+    CHECK_EQ(mem::vector_view<const int>(v.data(), v.data() + 4).size(), 4);
+  }
+}
+
+TEST_CASE("vector_view: subviews") {
+  mem::base_vector<int> v(10);
+  std::iota(v.begin(), v.end(), 0);
+  mem::vector_view<int> view = v;
+
+  CHECK_EQ(to_std(view.subview(2, 3)), std::vector<int>{2, 3, 4});
+  CHECK_EQ(to_std(view.subview(8)), std::vector<int>{8, 9});
+  CHECK_EQ(to_std(view.subview(8, 5)), std::vector<int>{8, 9});
+  CHECK(view.subview(10).empty());
+
+  CHECK_EQ(to_std(view.first(2)), std::vector<int>{0, 1});
+  CHECK_EQ(to_std(view.last(2)), std::vector<int>{8, 9});
+
+  auto [head, tail] = view.split_at(3);
+  CHECK_EQ(to_std(head), std::vector<int>{0, 1, 2});
+  CHECK_EQ(tail.size(), 7);
+  CHECK_EQ(tail.data(), v.data() + 3);
+}
+
+TEST_CASE("vector_view: chunks partition the view") {
+  mem::base_vector<int> v(10);
+  std::iota(v.begin(), v.end(), 0);
+  mem::vector_view<const int> view = v;
+
+  auto chunks = view.chunks(3);
+  CHECK_EQ(chunks.size(), 3);
+  CHECK_EQ(to_std(chunks[0]), std::vector<int>{0, 1, 2});
+  CHECK_EQ(to_std(chunks[1]), std::vector<int>{3, 4, 5});
+  CHECK_EQ(to_std(chunks[2]), std::vector<int>{6, 7, 8, 9});
+
+  std::vector<int> joined;
+  for (auto chunk : chunks) {
+    joined.insert(joined.end(), chunk.begin(), chunk.end());
+  }
+  CHECK_EQ(joined, to_std(view));
+
+  WHEN("There are more chunks than elements") {
+    std::size_t total = 0;
+    for (auto chunk : view.first(2).chunks(4)) {
+      total += chunk.size();
+    }
+    CHECK_EQ(total, 2);
+  }
+}
+
+TEST_CASE("vector_view: strided views") {
+  // 3 x 4 matrix, row major
+  mem::base_vector<int> v(12);
+  std::iota(v.begin(), v.end(), 0);
+  mem::vector_view<int> matrix = v;
+
+  mem::strided_view<int> column(matrix.data() + 1, 3, 4);
+  CHECK_EQ(to_std(column), std::vector<int>{1, 5, 9});
+  CHECK_EQ(column.back(), 9);
+  CHECK_EQ(column.end() - column.begin(), 3);
+
+  std::fill(column.begin(), column.end(), -1);
+  CHECK_EQ(v[5], -1);
+
+  CHECK_EQ(to_std(matrix.stride(5)), std::vector<int>{0, -1, 10});
+  CHECK_EQ(to_std(matrix.stride(4).stride(2)), std::vector<int>{0, 8});
+  CHECK_EQ(to_std(column.subview(1)), std::vector<int>{-1, -1});
+
+  auto [top, bottom] = mem::strided_view<const int>(column).split_at(2);
+  CHECK_EQ(top.size(), 2);
+  CHECK_EQ(bottom.front(), -1);
+
+  auto chunks = mem::strided_view<int>(matrix).chunks(2);
+  CHECK_EQ(to_std(chunks[1]), std::vector<int>{6, 7, 8, -1, 10, 11});
+
+  WHEN("Iterating the last column") {
+    // Its end lies beyond the array, if computed as a pointer
+    mem::strided_view<const int> last(matrix.data() + 3, 3, 4);
+    CHECK_EQ(to_std(last), std::vector<int>{3, 7, 11});
+    CHECK_EQ(std::distance(last.begin(), last.end()), 3);
+    CHECK_EQ(*(last.end() - 1), 11);
+    CHECK(last.subview(3).empty());
+    CHECK_EQ(last.split_at(3).second.begin(), last.split_at(3).second.end());
+  }
+}
+
+TEST_CASE("vector_view: algorithms on views") {
+  mem::base_vector<int> v(10);
+  std::iota(v.begin(), v.end(), 0);
+  mem::vector_view<int> view = v;
+
+  WHEN("Copying overlapping views") {
+    auto copied = mem::overlapped_copy(view.first(6), view.subview(2));
+    CHECK_EQ(copied.data(), v.data() + 2);
+    CHECK_EQ(copied.size(), 6);
+    CHECK_EQ(to_std(view), std::vector<int>{0, 1, 0, 1, 2, 3, 4, 5, 8, 9});
+  }
+
+  WHEN("Compacting a tile") {
+    auto kept = mem::compact(view.subview(2, 6),
+                             [](std::size_t i) { return i % 2 == 0; });
+    CHECK_EQ(to_std(kept), std::vector<int>{2, 4, 6});
+    CHECK_EQ(v[8], 8);
+  }
+}